@@ -65,7 +65,7 @@ echo "-- Building the example..."
 CC=gcc
 BIN=main
 
-CFLAGS=(-ansi -Iinclude -lEGL -lm -lX11 -lGL -lpng build/MibiEngine2.a -Wall \
+CFLAGS=(-ansi -Iinclude -lEGL -lm -lX11 -lGL -lpng -lpthread build/MibiEngine2.a -Wall \
         -Wextra -Wpedantic -g)
 
 if $emscripten; then
@@ -82,3 +82,8 @@ fi
 
 $CC example/*.c -o $BIN ${CFLAGS[@]}
 
+
+if ! $emscripten; then
+    echo "-- Building the tools..."
+    $CC tools/getexconv.c -o getexconv ${CFLAGS[@]}
+fi
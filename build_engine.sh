@@ -35,7 +35,8 @@
 
 NAME=MibiEngine2
 VERSION="v.0.1"
-SRCFILES=(src/backends/*.c src/backends/gles/*.c
+SRCFILES=(src/backends/*.c src/backends/gles/*.c src/backends/soft/*.c
+          src/backends/null/*.c
           src/base/*.c src/renderer/*.c src/render2d/*.c)
 CC=cc
 AR=ar
@@ -37,6 +37,7 @@
 #include <string.h>
 #include <math.h>
 
+#include <mibiengine2/base/backend.h>
 #include <mibiengine2/base/mat.h>
 #include <mibiengine2/base/window.h>
 #include <mibiengine2/base/texturedmodel.h>
@@ -241,11 +242,12 @@ void init(void) {
         EXIT(EXIT_FAILURE);
     }
     
-    if(ge_image_init(&image, "spot_texture.png")){
+    if(ge_image_init_texture(&image, "spot_texture.png", 0)){
         fputs("Failed to read image!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
-    if(ge_texture_init(&texture, &image, 1, 0)){
+    if(ge_texture_init(&texture, &image, 1, 0,
+                       GE_MIPMAP_KAISER|GE_MIPMAP_GAMMA)){
         fputs("Failed to load texture!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
@@ -267,11 +269,11 @@ void init(void) {
         EXIT(EXIT_FAILURE);
     }
     
-    if(ge_image_init(&font_image, "font.png")){
+    if(ge_image_init_texture(&font_image, "font.png", 0)){
         fputs("Failed to read image!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
-    if(ge_texture_init(&font_texture, &font_image, 0, 0)){
+    if(ge_texture_init(&font_texture, &font_image, 0, 0, GE_MIPMAP_NONE)){
         fputs("Failed to load texture!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
@@ -298,11 +300,12 @@ void init(void) {
         EXIT(EXIT_FAILURE);
     }
     
-    if(ge_image_init(&tileset, "tiles.png")){
+    if(ge_image_init_texture(&tileset, "tiles.png", 0)){
         fputs("Failed to read image!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
-    if(ge_texture_init(&tileset_texture, &tileset, 0, 0)){
+    if(ge_texture_init(&tileset_texture, &tileset, 0, 0,
+                       GE_MIPMAP_NONE)){
         fputs("Failed to load texture!\n", stderr);
         EXIT(EXIT_FAILURE);
     }
@@ -508,11 +511,21 @@ void sort_test(void) {
 
 int main(int argc, char **argv) {
     int rc;
-    (void)argc;
-    (void)argv;
+    size_t i;
     
     sort_test();
     
+    /* The backend can be chosen with the first argument */
+    if(argc > 1 && ge_backend_use(argv[1])){
+        fprintf(stderr, "Unknown backend \"%s\"! Available backends:\n",
+                argv[1]);
+        for(i=0;i<ge_backend_num();i++){
+            fprintf(stderr, "    %s\n", ge_backend_name(i));
+        }
+        return EXIT_FAILURE;
+    }
+    printf("Using the %s backend\n", ge_backend_current());
+    
     if((rc = ge_window_init(&window, "MibiEngine2 demo"))){
         return rc;
     }
@@ -0,0 +1,115 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_ATLAS_H
+#define GE_ATLAS_H
+
+/* atlas.h
+ *
+ * Packs many images into a single texture, so that the sprites, texts and
+ * tilemaps using them can be rendered without switching textures. The images
+ * are placed with the MaxRects algorithm, picking the free rectangle that
+ * leaves the shortest side free, and can be rotated by 90 degrees to fit
+ * better.
+ */
+
+#include <mibiengine2/base/image.h>
+#include <mibiengine2/base/texture.h>
+
+#include <stddef.h>
+
+typedef struct {
+    /* The area of the image in the atlas in pixels, without its padding. It
+     * is height pixels wide and width pixels high if the image is rotated. */
+    int x, y;
+    int w, h;
+    /* The image is rotated by 90 degrees clockwise */
+    int rotated;
+    /* The texture of the atlas is flipped */
+    int flip;
+    /* The UV coordinates of the corners of the area in the texture */
+    float u1, v1;
+    float u2, v2;
+} GEAtlasRect;
+
+typedef struct {
+    GETexture texture;
+    /* The area of each image, in the order the images were given */
+    GEAtlasRect *rects;
+    size_t rect_num;
+    int width, height;
+} GEAtlas;
+
+/* ge_atlas_init
+ *
+ * Pack images into the texture of an atlas, which is as small as possible
+ * with power of two sides.
+ *
+ * atlas:     The atlas.
+ * images:    The images to pack.
+ * image_num: The number of images.
+ * padding:   The number of pixels around each image, filled with its edges so
+ *            that linear filtering doesn't sample the other images.
+ * rotate:    Allow rotating the images.
+ * max_size:  The max. width and height of the atlas.
+ * linear:    Use linear filtering instead of nearest neighbour filtering.
+ * flip:      Flip the texture (see ge_texture_init).
+ * Returns GE_E_NONE (0) on success, GE_E_ATLAS_FULL if the images don't fit
+ * in the max. size or another error code on failure.
+ */
+int ge_atlas_init(GEAtlas *atlas, GEImage **images, size_t image_num,
+                  int padding, int rotate, int max_size, int linear,
+                  int flip);
+
+/* ge_atlas_uv
+ *
+ * Get the UV coordinates in the texture of an atlas of a point of one of its
+ * images.
+ *
+ * rect: The area of the image in the atlas.
+ * u:    The U coordinate in the texture of the image on its own.
+ * v:    The V coordinate in the texture of the image on its own.
+ * out:  Set to the U and V coordinates in the texture of the atlas.
+ */
+void ge_atlas_uv(GEAtlasRect *rect, float u, float v, float *out);
+
+/* ge_atlas_free
+ *
+ * Free an atlas and its texture.
+ *
+ * atlas: The atlas to free.
+ */
+void ge_atlas_free(GEAtlas *atlas);
+
+#endif
@@ -0,0 +1,82 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_BACKEND_SELECT_H
+#define GE_BACKEND_SELECT_H
+
+#include <stddef.h>
+
+/* backend.h
+ *
+ * Select the backend used by the engine. The backend should be selected before
+ * calling any other function of the engine (the window should be created with
+ * the same backend as the models, textures, etc.).
+ */
+
+/* ge_backend_use
+ *
+ * Use the backend named name (see ge_backend_name).
+ *
+ * name: The name of the backend to use.
+ * Returns GE_E_NONE (0) on success or GE_E_UNKNOWN_BACKEND if there is no
+ * backend with this name.
+ */
+int ge_backend_use(char *name);
+
+/* ge_backend_num
+ *
+ * Get the number of available backends.
+ *
+ * Returns the number of backends.
+ */
+size_t ge_backend_num(void);
+
+/* ge_backend_name
+ *
+ * Get the name of a backend.
+ *
+ * backend: The number of the backend (between 0 and ge_backend_num()-1).
+ * Returns the name of the backend or NULL if it doesn't exist.
+ */
+char *ge_backend_name(size_t backend);
+
+/* ge_backend_current
+ *
+ * Get the name of the currently used backend.
+ *
+ * Returns the name of the backend that is currently used.
+ */
+char *ge_backend_current(void);
+
+#endif
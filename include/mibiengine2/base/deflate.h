@@ -43,12 +43,67 @@
 
 #include <stddef.h>
 
+/* Maximum length of a huffman code */
+#define GE_DEFLATE_MAX_BITS 15
+/* Number of bits decoded with a single table lookup. Longer codes are decoded
+ * canonically. */
+#define GE_DEFLATE_FAST_BITS 9
+
+#define GE_DEFLATE_LITLEN_NUM 288
+#define GE_DEFLATE_DIST_NUM 32
+#define GE_DEFLATE_CLEN_NUM 19
+
+/* Largest distance a match can refer to */
+#define GE_DEFLATE_WINDOW_MAX 32768
+/* Smallest window that can be passed to ge_deflate_set_output with a flush
+ * callback */
+#define GE_DEFLATE_WINDOW_MIN (GE_DEFLATE_WINDOW_MAX+512)
+
+typedef struct {
+    /* Indexed by the next GE_DEFLATE_FAST_BITS bits of the input: the symbol
+     * shifted left by 4 ORed with the code length, or 0 for longer codes. */
+    unsigned short fast[1<<GE_DEFLATE_FAST_BITS];
+    /* Number of codes of each length */
+    unsigned short count[GE_DEFLATE_MAX_BITS+1];
+    /* Symbols sorted by code */
+    unsigned short symbol[GE_DEFLATE_LITLEN_NUM];
+} GEDeflateHuffman;
+
+/* Called with decompressed data that is about to be overwritten in the
+ * window. Returning a non-zero value stops the decompression and is returned
+ * by ge_deflate_decompress. */
+typedef int GEDeflateFlush(void *data, unsigned char *output, size_t size);
+
+enum {
+    GE_DEFLATE_S_HEADER,
+    GE_DEFLATE_S_BLOCK,
+    GE_DEFLATE_S_STORED_LEN,
+    GE_DEFLATE_S_STORED,
+    GE_DEFLATE_S_TABLE,
+    GE_DEFLATE_S_CLEN,
+    GE_DEFLATE_S_LENGTHS,
+    GE_DEFLATE_S_LITLEN,
+    GE_DEFLATE_S_DIST,
+    GE_DEFLATE_S_CHECK,
+    GE_DEFLATE_S_DONE
+};
+
 typedef struct {
-    void *output;
+    unsigned char *output;
     size_t output_size;
-    size_t cur;
+    size_t output_cap;
     size_t window_size;
     
+    /* Non-zero if the output buffer belongs to the caller */
+    unsigned char user_output;
+    GEDeflateFlush *flush;
+    void *flush_data;
+    /* Number of bytes of the output that were already added to the checksum
+     * and flushed */
+    size_t flushed;
+    /* Adler-32 checksum of the decompressed data */
+    unsigned long int check;
+    
     /* ZLIB header */
     struct {
         unsigned char method;
@@ -57,34 +112,87 @@ typedef struct {
     } compression;
     unsigned char cmf;
     unsigned char has_dict;
-    unsigned long int dict_check;
     
     /* Non-zero if the ZLIB header has been read */
     unsigned char header_found;
     unsigned char adler32_found;
+    unsigned long int adler32;
     
-    /* Used for decoding */
+    /* Bit buffer, filled a byte at a time from the least significant bit */
     unsigned char bits_left;
-    unsigned int bits;
+    unsigned long int bits;
     
-    unsigned char new_block;
-    unsigned char last_block;
-    unsigned char block_type;
+    /* Where to resume decoding */
+    unsigned char state;
     
+    unsigned char last_block;
     unsigned char blocks_finished;
+    unsigned char fixed_tables;
     
-    size_t read;
+    /* Used when decoding blocks with dynamic huffman codes */
+    unsigned int hlit;
+    unsigned int hdist;
+    unsigned int hclen;
+    unsigned int index;
+    unsigned char lengths[GE_DEFLATE_LITLEN_NUM+GE_DEFLATE_DIST_NUM];
+    /* Length of the match whose distance is being decoded */
+    unsigned int length;
     /* Used when decoding blocks with no compression */
-    unsigned int data_size;
-    unsigned int ndata_size;
+    unsigned int stored_left;
+    
+    GEDeflateHuffman litlen;
+    GEDeflateHuffman dist;
 } GEDeflate;
 
+/* ge_deflate_init
+ *
+ * Initialize a ZLIB stream decoder.
+ *
+ * deflate: The decoder to initialize.
+ * Returns 0 on success.
+ */
 int ge_deflate_init(GEDeflate *deflate);
 
+/* ge_deflate_set_output
+ *
+ * Decompress into a buffer owned by the caller instead of a buffer that grows
+ * as needed. Must be called before decompressing anything.
+ *
+ * deflate: The decoder.
+ * buffer: The output buffer.
+ * size: The size of the output buffer.
+ * flush: If NULL, the whole decompressed data is written to the buffer and
+ *        must fit in it. Otherwise the buffer is used as a sliding window and
+ *        flush is called with each part of the decompressed data, in order,
+ *        once it has been decoded. The window should then be at least
+ *        GE_DEFLATE_WINDOW_MIN bytes big.
+ * data: Passed to flush.
+ * Returns 0 on success or GE_E_INVALID_WINDOW_SIZE if the window is too small.
+ */
+int ge_deflate_set_output(GEDeflate *deflate, unsigned char *buffer,
+                          size_t size, GEDeflateFlush *flush, void *data);
+
+/* ge_deflate_decompress
+ *
+ * Decompress the next part of a ZLIB stream. The stream can be split at any
+ * byte, all of the data is consumed and decoding resumes where it stopped on
+ * the next call. The decompressed data is appended to deflate->output or
+ * passed to the flush callback before returning.
+ *
+ * deflate: The decoder.
+ * data: The compressed data.
+ * size: The size of the compressed data.
+ * Returns 0 on success or an error code if the stream is invalid.
+ */
 int ge_deflate_decompress(GEDeflate *deflate, unsigned char *data,
                           size_t size);
 
+/* ge_deflate_free
+ *
+ * Free the decompressed data, unless it is in a buffer owned by the caller.
+ *
+ * deflate: The decoder to free.
+ */
 void ge_deflate_free(GEDeflate *deflate);
 
 #endif
-
@@ -0,0 +1,90 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_ETC1_H
+#define GE_ETC1_H
+
+#include <stddef.h>
+
+/* The size of a block of 4x4 pixels */
+#define GE_ETC1_BLOCK_SIZE 8
+
+/* The qualities of the encoder: FAST only uses the average colors of the
+ * subblocks, MEDIUM refines them to fit the chosen modifiers and HIGH also
+ * searches the neighbouring colors. */
+#define GE_ETC1_FAST 0
+#define GE_ETC1_MEDIUM 1
+#define GE_ETC1_HIGH 2
+
+/* ge_etc1_size
+ *
+ * Get the size of an ETC1 compressed image.
+ *
+ * width:  The width of the image.
+ * height: The height of the image.
+ * Returns the size of the image in bytes.
+ */
+size_t ge_etc1_size(int width, int height);
+
+/* ge_etc1_encode
+ *
+ * Compress RGBA pixels to ETC1, ignoring their alpha. The rows of blocks are
+ * encoded on several threads if GE_ETC1_THREADS is enabled in config.h.
+ *
+ * data:    The compressed image, of ge_etc1_size(width, height) bytes.
+ * rgba:    The first row of pixels.
+ * pitch:   The distance in bytes from a row to the next one, which can be
+ *          negative.
+ * width:   The width of the image.
+ * height:  The height of the image.
+ * quality: GE_ETC1_FAST, GE_ETC1_MEDIUM or GE_ETC1_HIGH.
+ */
+void ge_etc1_encode(unsigned char *data, unsigned char *rgba, long pitch,
+                    int width, int height, int quality);
+
+/* ge_etc1_decode
+ *
+ * Decompress an ETC1 image to opaque RGBA pixels.
+ *
+ * rgba:   The first row of pixels.
+ * pitch:  The distance in bytes from a row to the next one, which can be
+ *         negative.
+ * data:   The compressed image.
+ * width:  The width of the image.
+ * height: The height of the image.
+ */
+void ge_etc1_decode(unsigned char *rgba, long pitch, unsigned char *data,
+                    int width, int height);
+
+#endif
@@ -0,0 +1,70 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_FILE_H
+#define GE_FILE_H
+
+#include <stddef.h>
+
+typedef struct {
+    void *data;
+    size_t size;
+    /* Non-zero if data is mapped in memory, zero if it was read into an
+     * allocated buffer. */
+    unsigned char mapped;
+} GEFile;
+
+/* ge_file_map
+ *
+ * Map a file in memory to read it without copying it. The system is told
+ * that the file will be read sequentially. If the file can't be mapped it
+ * gets read into an allocated buffer instead. The data must not be modified.
+ *
+ * file: The file data.
+ * path: The path of the file.
+ * text: Non-zero if the data should be followed by a null byte, to be used
+ *       as a string.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_file_map(GEFile *file, char *path, int text);
+
+/* ge_file_unmap
+ *
+ * Free a file mapped with ge_file_map.
+ *
+ * file: The file data.
+ */
+void ge_file_unmap(GEFile *file);
+
+#endif
@@ -35,6 +35,19 @@
 #ifndef GE_IMAGE_H
 #define GE_IMAGE_H
 
+#include <mibiengine2/base/file.h>
+
+#include <stddef.h>
+
+/* The extension of the texture files written by ge_image_save_getex */
+#define GE_IMAGE_GETEX_EXT ".getex"
+
+/* The formats of the pixels of an image */
+#define GE_IMAGE_FORMAT_RGBA8 0
+/* Blocks of 4x4 opaque pixels compressed to 8 bytes (see etc1.h). Only .getex
+ * files can be in this format. */
+#define GE_IMAGE_FORMAT_ETC1 1
+
 typedef struct {
     /* TODO: Only store the width, height, data and maybe the color format. */
     unsigned int width, height;
@@ -43,6 +56,19 @@ typedef struct {
     unsigned char *data;
     unsigned char **rows;
     long row_bytes;
+    /* GE_IMAGE_FORMAT_RGBA8 for all images except .getex files that store
+     * another format, row_bytes then being the size of a row of blocks */
+    int format;
+    /* Size of the texture the image is laid out for (see ge_texture_layout),
+     * or 0 if its rows are packed one after the other */
+    int data_width, data_height;
+    /* The rows are stored from the bottom of the texture */
+    int flip;
+    /* Number of mip levels stored one after the other in data, each one
+     * being half the width and half the height of the previous one */
+    int levels;
+    /* The .getex file data points into, if it was loaded from one */
+    GEFile file;
 } GEImage;
 
 /* ge_image_init
@@ -55,6 +81,112 @@ typedef struct {
  */
 int ge_image_init(GEImage *image, char *file);
 
+/* ge_image_init_texture
+ *
+ * Load an image directly in the layout textures without mip levels are
+ * uploaded from: RGBA pixels of the size given by ge_texture_layout, padded
+ * with transparent black and optionally flipped. A texture created from such
+ * an image with the same flip takes its pixels over without copying them, the
+ * image should only be used to get its size afterwards.
+ *
+ * image: The image data.
+ * file:  The file name of the image.
+ * flip:  Store the rows as ge_texture_init would with flip set.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_image_init_texture(GEImage *image, char *file, int flip);
+
+/* ge_image_init_getex
+ *
+ * Map a .getex file in memory. Its pixels are already in the layout of a
+ * texture (see ge_image_init_texture), with its mip levels, so they are used
+ * directly from the file without being decoded or copied. The file stays
+ * mapped until the image is freed.
+ *
+ * image: The image data.
+ * file:  The file name of the .getex file.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_image_init_getex(GEImage *image, char *file);
+
+/* ge_image_save_getex
+ *
+ * Convert an image to the layout of a texture and save it as a .getex file,
+ * to load it with ge_image_init_getex instead of decoding it at runtime.
+ * Textures with mip levels are padded to a power of two width and height, as
+ * OpenGL ES 2 requires it without GL_OES_texture_npot, the others keep the
+ * size of the image.
+ *
+ * image:   The image to save.
+ * file:    The file name of the .getex file.
+ * flip:    Store the rows as ge_texture_init would with flip set.
+ * mipmaps: GE_MIPMAP_NONE, or the filter used to also store all the mip
+ *          levels down to 1x1 (see mipmap.h).
+ * format:  The format of the pixels in the file, GE_IMAGE_FORMAT_RGBA8 or
+ *          GE_IMAGE_FORMAT_ETC1 to compress them (without their alpha).
+ * quality: The quality of the ETC1 encoder (see ge_etc1_encode).
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_image_save_getex(GEImage *image, char *file, int flip, int mipmaps,
+                        int format, int quality);
+
+/* ge_image_level_size
+ *
+ * Get the size of a mip level of a texture.
+ *
+ * format: The format of the pixels.
+ * width:  The width of the level.
+ * height: The height of the level.
+ * Returns the size of the level in bytes.
+ */
+size_t ge_image_level_size(int format, int width, int height);
+
+/* ge_image_levels
+ *
+ * Make an image out of the mip levels of an image starting from one of its
+ * levels, without copying them. It is only valid as long as the image is,
+ * and must not be freed.
+ *
+ * image: The image, with all of its levels in the layout of a texture.
+ * view:  The image of the levels.
+ * first: The first level of the view.
+ */
+void ge_image_levels(GEImage *image, GEImage *view, int first);
+
+/* ge_image_copy_texture
+ *
+ * Copy the first level of an image to RGBA pixels in the layout of a
+ * texture, decompressing them if needed. Used by the backends when the image
+ * isn't already in the layout they need.
+ *
+ * image:  The image to copy.
+ * out:    The width*height RGBA pixels of the texture, filled with zeros.
+ * width:  The width of the texture.
+ * height: The height of the texture.
+ * flip:   Store the rows from the bottom of the texture.
+ */
+void ge_image_copy_texture(GEImage *image, unsigned char *out, int width,
+                           int height, int flip);
+
+/* ge_image_copy_region
+ *
+ * Copy a rectangle of the first level of an image to RGBA pixels in the
+ * layout of a texture, as ge_image_copy_texture does. ETC1 images only get
+ * the blocks that contain the rectangle decompressed.
+ *
+ * image:  The image to copy.
+ * out:    The width*height RGBA pixels of the texture.
+ * width:  The width of the texture.
+ * height: The height of the texture.
+ * flip:   Store the rows from the bottom of the texture.
+ * x:      The position of the rectangle on the X axis, in the image.
+ * y:      The position of the rectangle on the Y axis, in the image.
+ * w:      The width of the rectangle, that has to be inside of the image.
+ * h:      The height of the rectangle, that has to be inside of the image.
+ */
+void ge_image_copy_region(GEImage *image, unsigned char *out, int width,
+                          int height, int flip, int x, int y, int w, int h);
+
 /* ge_image_empty
  *
  * Create a new empty image filled with the RGBA color 0, 0, 0, 0.
@@ -74,7 +206,9 @@ int ge_image_empty(GEImage *image, int width, int height);
  * x:     The position of the pixel on the X axis.
  * y:     The position of the pixel on the Y axis.
  */
-#define GE_IMAGE_GET_PIXEL_PTR(image, x, y) (image->data+(y*image->width+x)*4)
+#define GE_IMAGE_GET_PIXEL_PTR(image, x, y) \
+    ((image)->data+((image)->flip ? (image)->data_height-1-(y) : (y))* \
+     (image)->row_bytes+(x)*4)
 
 /* GE_IMAGE_GET_WIDTH
  *
@@ -94,7 +228,7 @@ int ge_image_empty(GEImage *image, int width, int height);
 
 /* ge_image_free
  *
- * Free an image.
+ * Free an image, or unmap it if it was loaded from a .getex file.
  *
  * image: The image to free.
  */
@@ -0,0 +1,97 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_MESHCACHE_H
+#define GE_MESHCACHE_H
+
+#include <stddef.h>
+
+/* The extension appended to the name of the source file */
+#define GE_MESHCACHE_EXT ".gemesh"
+#define GE_MESHCACHE_ITEM_NUM 4
+
+/* A mesh loaded from a .gemesh file. The arrays point into the mapped file
+ * and are only valid until ge_meshcache_free is called. */
+typedef struct {
+    void *map;
+    size_t map_size;
+    float *vertices;
+    unsigned int *indices;
+    size_t vertex_num;
+    size_t index_num;
+    size_t item_sizes[GE_MESHCACHE_ITEM_NUM];
+} GEMeshCache;
+
+/* ge_meshcache_load
+ *
+ * Map the .gemesh file of a source file in memory, if it is up to date. The
+ * cache is up to date if the source has the same size and modification time
+ * as when the cache was saved, or else if its content has the same hash.
+ *
+ * cache: The mesh to load.
+ * file:  The path to the source file (not the cache file).
+ * Returns GE_E_NONE (0) on success or an error code if there is no valid
+ * cache.
+ */
+int ge_meshcache_load(GEMeshCache *cache, char *file);
+
+/* ge_meshcache_save
+ *
+ * Save the mesh generated from a source file to its .gemesh file, to load it
+ * with ge_meshcache_load instead of generating it again on later runs.
+ *
+ * file:        The path to the source file.
+ * source:      The content of the source file, to compute its hash.
+ * source_size: The size of the source file.
+ * vertices:    The interleaved vertex data.
+ * vertex_num:  The number of vertices (not of floats) in vertices.
+ * item_sizes:  The number of floats of each attribute of a vertex (see
+ *              ge_stdmodel_init_interleaved).
+ * indices:     The indices.
+ * index_num:   The number of indices.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_meshcache_save(char *file, char *source, size_t source_size,
+                      float *vertices, size_t vertex_num, size_t *item_sizes,
+                      unsigned int *indices, size_t index_num);
+
+/* ge_meshcache_free
+ *
+ * Unmap a mesh loaded with ge_meshcache_load.
+ *
+ * cache: The mesh to free.
+ */
+void ge_meshcache_free(GEMeshCache *cache);
+
+#endif
@@ -0,0 +1,101 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_MIPMAP_H
+#define GE_MIPMAP_H
+
+#include <stddef.h>
+
+/* The filters used to compute each mip level from the previous one: BOX
+ * averages 2x2 pixels and KAISER is a Kaiser windowed sinc of 8x8 pixels,
+ * which keeps the levels sharper without aliasing. */
+#define GE_MIPMAP_NONE 0
+#define GE_MIPMAP_BOX 1
+#define GE_MIPMAP_KAISER 2
+/* Combined with a filter, filter the colors in linear light, as they are
+ * stored in sRGB. The alpha channel is always filtered as it is. */
+#define GE_MIPMAP_GAMMA 4
+
+/* ge_mipmap_levels
+ *
+ * Get the number of mip levels of a texture, down to 1x1.
+ *
+ * width:  The width of the texture.
+ * height: The height of the texture.
+ * Returns the number of levels, including the first one.
+ */
+int ge_mipmap_levels(int width, int height);
+
+/* ge_mipmap_size
+ *
+ * Get the size of the RGBA pixels of all the mip levels of a texture, as
+ * stored by ge_mipmap_chain.
+ *
+ * width:  The width of the texture.
+ * height: The height of the texture.
+ * Returns the size of the levels in bytes.
+ */
+size_t ge_mipmap_size(int width, int height);
+
+/* ge_mipmap_generate
+ *
+ * Compute the next mip level of RGBA pixels, of half the width and half the
+ * height of the previous one (rounded down, but at least 1).
+ *
+ * dst:    The pixels of the next level.
+ * src:    The pixels of the previous level.
+ * width:  The width of the previous level.
+ * height: The height of the previous level.
+ * filter: GE_MIPMAP_BOX or GE_MIPMAP_KAISER, optionally combined with
+ *         GE_MIPMAP_GAMMA.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_mipmap_generate(unsigned char *dst, unsigned char *src, int width,
+                       int height, int filter);
+
+/* ge_mipmap_chain
+ *
+ * Compute all the mip levels of RGBA pixels, each level being stored right
+ * after the previous one.
+ *
+ * data:   The pixels of the first level, followed by the space for the other
+ *         ones (ge_mipmap_size(width, height) bytes in total).
+ * width:  The width of the first level.
+ * height: The height of the first level.
+ * filter: The filter, as in ge_mipmap_generate.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_mipmap_chain(unsigned char *data, int width, int height, int filter);
+
+#endif
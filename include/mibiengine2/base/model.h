@@ -60,6 +60,21 @@ typedef struct {
         GEType type;
         unsigned int vbo;
     } indices;
+    /* Replicated indices and instance ids (see GEModelArray), created when
+     * pending is set and the model is drawn in batches, from a copy of the
+     * indices */
+    struct {
+        unsigned int vbo;
+        unsigned int id_vbo;
+        void *indices;
+        int pending;
+        size_t vertex_num;
+        size_t copies;
+    } replicated;
+    /* The vertex array object storing the layout of the arrays in the OpenGL
+     * ES backend, and a hash of the layout it was created for. */
+    unsigned int vao;
+    unsigned long int vao_layout;
     GEModelAttr *attr;
     BASE_DATA(MODEL, {
         void (*before_rendering)(void *_model, GEModelAttr *attr,
@@ -171,6 +186,17 @@ void ge_model_render(GEModel *model);
  *
  * Render a model multiple times.
  * before and after may not be called in the correct order.
+ * If the backend supports instanced rendering and all the uniforms are declared
+ * as vertex attributes in the vertex shader (the OpenGL ES backend defines
+ * GE_INSTANCED in the vertex shader when it is the case), the model is drawn
+ * in a single call, with the uniforms streamed as per-instance attributes.
+ * Without instancing, the OpenGL ES backend defines GE_PSEUDO_INSTANCES to the
+ * number of instances it can draw at once. If the uniforms are declared as
+ * arrays of that size and indexed with the ge_instance attribute, small models
+ * that are not updatable are drawn in batches of that many instances from
+ * replicated buffers. These buffers take that many times the size of the
+ * model in video memory, and are created the first time the model is drawn
+ * in batches, from a copy of its data kept in memory until then.
  *
  * model:         The model to render.
  * pos:           The position of the uniform variables that should be sent for
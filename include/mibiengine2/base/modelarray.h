@@ -39,9 +39,28 @@
 
 #include <mibiengine2/base/types.h>
 
-typedef struct {
+/* The position of a shader attribute and where its data is in the model
+ * array. item_size, stride and offset are counted in elements of the type of
+ * the array, 0 meaning the defaults of a tightly packed array: item_size 0
+ * uses the item_size of the array and stride 0 uses the item_size of the
+ * attribute. next links more attributes read from the same array, to store
+ * interleaved vertices in a single array (see ge_stdmodel_init_interleaved).
+ */
+typedef struct GEModelArrayAttr GEModelArrayAttr;
+struct GEModelArrayAttr {
     int pos;
-} GEModelArrayAttr;
+    size_t item_size;
+    size_t stride;
+    size_t offset;
+    GEModelArrayAttr *next;
+};
+
+/* The item size and the stride used when reading attr from array */
+#define GE_MODELARRAY_ATTR_ITEM_SIZE(array, attr) \
+    ((attr)->item_size ? (attr)->item_size : (array)->item_size)
+#define GE_MODELARRAY_ATTR_STRIDE(array, attr) \
+    ((attr)->stride ? (attr)->stride : GE_MODELARRAY_ATTR_ITEM_SIZE(array, \
+                                                                    attr))
 
 typedef struct {
     void *data;
@@ -51,6 +70,12 @@ typedef struct {
     size_t item_size;
     GEModelArrayAttr *current_attr;
     unsigned char updatable;
+    /* Copies of the data used by the OpenGL ES backend to render multiple
+     * instances in a single draw call without instancing extensions. They are
+     * created from replicated_data, a copy of the data kept until the model is
+     * drawn with ge_model_render_multiple. */
+    unsigned int replicated_vbo;
+    void *replicated_data;
 } GEModelArray;
 
 /* ge_modelarray_init
@@ -88,7 +113,8 @@ int ge_modelarray_update(GEModelArray *array, void *data, size_t size);
  *
  * Use this model array with the model attributes in attr.
  * Model attributes share the position where the model array needs to be loaded
- * to for use in a shader.
+ * to for use in a shader. The attributes linked with attr->next are enabled
+ * too.
  *
  * array: The array to use.
  * attr:  The array attributes.
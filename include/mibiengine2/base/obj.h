@@ -38,7 +38,6 @@
 #define GE_OBJ_DEBUG 0
 
 #define GE_OBJ_ALLOC_STEP (1<<16)
-#define GE_OBJ_TOK_SZ 32
 #define GE_OBJ_TOK_MAX 8
 
 #include <mibiengine2/base/types.h>
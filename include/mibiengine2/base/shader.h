@@ -46,6 +46,13 @@ typedef struct {
 
 typedef struct {
     int pos;
+    /* The position of the vertex attribute with the same name, if the shader
+     * declares it as a per-instance attribute instead of a uniform variable
+     * (see ge_model_render_multiple), -1 otherwise. */
+    int attr;
+    /* The number of elements of the uniform variable if it is an array, 1
+     * otherwise. */
+    int size;
 } GEShaderPos;
 
 typedef enum {
@@ -58,6 +58,8 @@ typedef struct {
     GEModelAttr attr;
     
     unsigned char updatable;
+    /* Non-zero if all the attributes are stored in vertex_array */
+    unsigned char interleaved;
 } GEStdModel;
 
 /* ge_stdmodel_init
@@ -85,6 +87,36 @@ int ge_stdmodel_init(GEModel *model, void *indices, void *vertices,
                      size_t vertex_num, size_t item_size, int updatable,
                      void *extra);
 
+/* ge_stdmodel_init_interleaved
+ *
+ * Create a standard model where the vertex positions, colors, uv coordinates
+ * and normals are interleaved in a single array, which is stored in a single
+ * VBO with the OpenGL ES backend. Each vertex is made of its position followed
+ * by its color, uv coordinates and normal, skipping the ones with a size of 0.
+ * Colors, uv coordinates and normals can't be added or updated separately
+ * afterwards, ge_stdmodel_update_vertices updates the whole array.
+ *
+ * model:      The model to initialize.
+ * indices:    The model indices (see model.h).
+ * data:       The interleaved vertex data.
+ * index_type: The type of the index data (see type.h).
+ * type:       The type of the vertex data (see type.h).
+ * index_num:  The number of indices.
+ * vertex_num: The number of vertices (not of elements) in data.
+ * item_sizes: The number of elements of the position, the color, the uv
+ *             coordinates and the normal of each vertex, in this order. The
+ *             size of the position can't be 0.
+ * updatable:  Non-zero if the model arrays can be updated or zero if they
+ *             can't.
+ * extra:      Extra data (see model.h and base.h).
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_stdmodel_init_interleaved(GEModel *model, void *indices, void *data,
+                                 GEType index_type, GEType type,
+                                 size_t index_num, size_t vertex_num,
+                                 size_t *item_sizes, int updatable,
+                                 void *extra);
+
 /* ge_stdmodel_shader_attr
  *
  * Generate the model attributes.
@@ -141,7 +173,8 @@ int ge_stdmodel_add_normals(GEModel *model, void *data, GEType type,
 
 /* ge_stdmodel_update_vertices
  *
- * Update the vertex position array used with this model.
+ * Update the vertex position array used with this model, or all the vertex
+ * data if the model is interleaved (see ge_stdmodel_init_interleaved).
  *
  * model: The model data.
  * data:  The vertex data. The type and the number of elements per vector is
@@ -36,6 +36,7 @@
 #define GE_TEXTURE_H
 
 #include <mibiengine2/base/image.h>
+#include <mibiengine2/base/mipmap.h>
 
 #include <stddef.h>
 
@@ -43,13 +44,39 @@
 
 #include <mibiengine2/base/mat.h>
 
+/* The lod of a texture that isn't on the GPU anymore */
+#define GE_TEXTURE_EVICTED -1
+
+/* See texturemanager.h */
+typedef struct GETextureManager GETextureManager;
+/* See texturestream.h */
+typedef struct GETextureStream GETextureStream;
+
 typedef struct {
     int width, height;
-    int size;
+    /* The size of the pixels stored by the backend, at least the size of the
+     * image (see ge_texture_layout) */
+    int data_width, data_height;
     unsigned char *data;
     unsigned int id;
     GEVec2 uv_max;
     unsigned char flip;
+    int mipmap;
+    /* The format the pixels were uploaded in (GE_IMAGE_FORMAT_*) */
+    int format;
+    int linear;
+    /* The number of mip levels of the texture, including the dropped ones */
+    int levels;
+    /* The number of mip levels that are not on the GPU to save memory, or
+     * GE_TEXTURE_EVICTED */
+    int lod;
+    /* The manager that keeps track of the memory used by this texture, or
+     * NULL */
+    GETextureManager *manager;
+    /* The frame of the manager the texture was last used in */
+    unsigned long int last_use;
+    /* The stream that uploads the mip levels of the texture, or NULL */
+    GETextureStream *stream;
 } GETexture;
 
 /* ge_texture_init
@@ -61,13 +88,49 @@ typedef struct {
  * linear:  Use linear filtering instead of nearest neighbour filtering.
  * flip:    Flip the texture (textures are loaded as vertically flipped by
  *          default.
+ * mipmap:  GE_MIPMAP_NONE, or the filter used to generate the mip levels
+ *          (see mipmap.h), which are also generated again by
+ *          ge_texture_update. Images that already have their mip levels
+ *          keep them.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_init(GETexture *texture, GEImage *image, int linear, int flip,
+                    int mipmap);
+
+/* ge_texture_layout
+ *
+ * Get the size of the pixels of a texture created from an image, which is
+ * the size of the image if the backend supports textures of any size with
+ * the mip levels requested, and the next power of two width and height
+ * otherwise. uv_max compensates for the padding.
+ *
+ * width:       The width of the image.
+ * height:      The height of the image.
+ * mipmap:      The mipmap argument of ge_texture_init.
+ * data_width:  Set to the width of the texture.
+ * data_height: Set to the height of the texture.
+ */
+void ge_texture_layout(int width, int height, int mipmap, int *data_width,
+                       int *data_height);
+
+/* ge_texture_init_getex
+ *
+ * Load a texture from a .getex file (see ge_image_init_getex), flipped as it
+ * was saved. The GLES backend uploads its pixels and mip levels straight from
+ * the mapped file.
+ *
+ * texture: The texture data.
+ * file:    The file name of the .getex file.
+ * linear:  Use linear filtering instead of nearest neighbour filtering.
  * Returns GE_E_NONE (0) on success or an error code on failure.
  */
-int ge_texture_init(GETexture *texture, GEImage *image, int linear, int flip);
+int ge_texture_init_getex(GETexture *texture, char *file, int linear);
 
 /* ge_texture_update
  *
- * Update the contents of a texture.
+ * Update the contents of a texture. If the image has the same size as the
+ * previous one, its pixels are copied into the texture instead of creating
+ * it again. The texture stops being streamed.
  *
  * texture: The texture to update.
  * image:   The image data to load into the texture.
@@ -75,9 +138,28 @@ int ge_texture_init(GETexture *texture, GEImage *image, int linear, int flip);
  */
 int ge_texture_update(GETexture *texture, GEImage *image);
 
+/* ge_texture_update_region
+ *
+ * Update a rectangle of a texture, to stream pixels into it. Only the rows
+ * of the rectangle are uploaded to the GPU, unless the texture has mip
+ * levels or is compressed. If the image doesn't have the same size as the
+ * texture, the whole texture is updated as with ge_texture_update.
+ *
+ * texture: The texture to update.
+ * image:   The image data to load into the texture.
+ * x:       The position of the rectangle on the X axis, in the image.
+ * y:       The position of the rectangle on the Y axis, in the image.
+ * w:       The width of the rectangle.
+ * h:       The height of the rectangle.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_update_region(GETexture *texture, GEImage *image, int x,
+                             int y, int w, int h);
+
 /* ge_texture_use
  *
- * Use a texture.
+ * Use a texture. If it is tracked by a texture manager, it is loaded back if
+ * it was evicted.
  *
  * texture: The texture to use.
  * pos:     The position of the sampler in the shader.
@@ -87,7 +169,7 @@ void ge_texture_use(GETexture *texture, GEShaderPos *pos, size_t n);
 
 /* ge_texture_free
  *
- * Free a texture.
+ * Free a texture, and remove it from its texture manager and its stream.
  *
  * texture: The texture to free.
  */
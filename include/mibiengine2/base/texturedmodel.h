@@ -71,16 +71,43 @@ int ge_texturedmodel_init(GEModel *model, GETexture *texture, void *indices,
                           size_t vertex_num, size_t item_size, int updatable,
                           void *extra);
 
+/* ge_texturedmodel_init_interleaved
+ *
+ * Create a textured model with interleaved vertex data (see
+ * ge_stdmodel_init_interleaved).
+ *
+ * model:      The model to initialize.
+ * texture:    The texture to use with this model.
+ * indices:    The model indices (see model.h).
+ * data:       The interleaved vertex data.
+ * index_type: The type of the index data (see type.h).
+ * type:       The type of the vertex data (see type.h).
+ * index_num:  The number of indices.
+ * vertex_num: The number of vertices (not of elements) in data.
+ * item_sizes: The number of elements of the position, the color, the uv
+ *             coordinates and the normal of each vertex, in this order.
+ * updatable:  Non-zero if the model arrays can be updated or zero if they
+ *             can't.
+ * extra:      Extra data (see model.h and base.h).
+ * Returns 0 on success or an error code on failure.
+ */
+int ge_texturedmodel_init_interleaved(GEModel *model, GETexture *texture,
+                                      void *indices, void *data,
+                                      GEType index_type, GEType type,
+                                      size_t index_num, size_t vertex_num,
+                                      size_t *item_sizes, int updatable,
+                                      void *extra);
+
 /* ge_texturedmodel_set_texture
  *
  * Set the position of the texture sampler in the shader used with this model.
  *
  * model:      The model to set the texture position to.
  * tex_pos:    The texture sampler position.
- * uv_max_pos: The position of the UV max. uniform. Textures are square and
- *             power of two sized. When the image they contain isn't square,
- *             (or power of two sized) the UV coordinates need to be adapted to
- *             use the correct part of the texture.
+ * uv_max_pos: The position of the UV max. uniform. Textures may be padded
+ *             to a power of two width and height (see ge_texture_layout), the
+ *             UV coordinates then need to be adapted to use the correct part
+ *             of the texture, and to repeat it.
  * Returns 0 on success or an error code on failure.
  */
 int ge_texturedmodel_set_texture(GEModel *model, GEShaderPos *tex_pos,
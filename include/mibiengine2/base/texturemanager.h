@@ -0,0 +1,155 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_TEXTUREMANAGER_H
+#define GE_TEXTUREMANAGER_H
+
+/* texturemanager.h
+ *
+ * Keeps the memory used by textures under a GPU and a CPU budget. Every frame
+ * the textures that weren't used get evicted from the GPU, starting from the
+ * least recently used one, and if that isn't enough, the first mip levels of
+ * the textures that are still used get dropped. They are loaded back when
+ * they get used again, or when they fit in the budget again.
+ *
+ * The copy of the pixels the backends keep on the CPU is also freed, starting
+ * from the least recently used texture, if the texture can be loaded again
+ * from its file.
+ */
+
+#include <mibiengine2/base/texture.h>
+
+#include <stddef.h>
+
+typedef struct {
+    GETexture *texture;
+    /* The file the texture can be loaded from again, or NULL */
+    char *file;
+    /* The number of bytes used by the texture on the GPU and on the CPU */
+    size_t gpu, cpu;
+} GETextureEntry;
+
+struct GETextureManager {
+    GETextureEntry *entries;
+    /* The entries sorted from the least recently used one */
+    GETextureEntry **order;
+    size_t entry_num;
+    size_t entry_max;
+    /* The budgets can be changed at any time, they are enforced by
+     * ge_texture_manager_update */
+    size_t gpu_budget, cpu_budget;
+    /* The number of bytes used by all the textures */
+    size_t gpu, cpu;
+    unsigned long int frame;
+};
+
+/* ge_texture_manager_init
+ *
+ * Initialize a texture manager.
+ *
+ * manager:    The texture manager.
+ * gpu_budget: The max. number of bytes used by the textures on the GPU.
+ * cpu_budget: The max. number of bytes used by the copies of the pixels kept
+ *             on the CPU.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_init(GETextureManager *manager, size_t gpu_budget,
+                            size_t cpu_budget);
+
+/* ge_texture_manager_add
+ *
+ * Keep track of the memory used by a texture.
+ *
+ * manager: The texture manager.
+ * texture: The texture.
+ * file:    The file the texture was loaded from, with ge_texture_init_getex
+ *          or from an image loaded with ge_image_init, or NULL. Without it,
+ *          the texture can only be evicted or have levels dropped if the
+ *          backend keeps a copy of its pixels, which is never freed.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_add(GETextureManager *manager, GETexture *texture,
+                           char *file);
+
+/* ge_texture_manager_use
+ *
+ * Record that a texture got used in the current frame, and load it back if it
+ * was evicted. Called by ge_texture_use.
+ *
+ * texture: The texture, that has to be tracked by a texture manager.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_use(GETexture *texture);
+
+/* ge_texture_manager_changed
+ *
+ * Load all the levels of a texture back before its pixels get changed, and
+ * forget the file it was loaded from, that doesn't contain them anymore.
+ * Called by ge_texture_update and ge_texture_update_region.
+ *
+ * texture: The texture, that has to be tracked by a texture manager.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_changed(GETexture *texture);
+
+/* ge_texture_manager_update
+ *
+ * Enforce the budgets and start a new frame. It should be called once per
+ * frame, after rendering it.
+ *
+ * manager: The texture manager.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_update(GETextureManager *manager);
+
+/* ge_texture_manager_remove
+ *
+ * Stop keeping track of a texture, after loading back all of its levels.
+ * Called by ge_texture_free.
+ *
+ * texture: The texture, that has to be tracked by a texture manager.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_manager_remove(GETexture *texture);
+
+/* ge_texture_manager_free
+ *
+ * Free a texture manager. The textures it keeps track of are loaded back in
+ * full.
+ *
+ * manager: The texture manager.
+ */
+void ge_texture_manager_free(GETextureManager *manager);
+
+#endif
@@ -0,0 +1,130 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_TEXTURESTREAM_H
+#define GE_TEXTURESTREAM_H
+
+/* texturestream.h
+ *
+ * Streams the mip levels of textures loaded from .getex files. Only the
+ * smallest levels are uploaded when a texture is added to a stream, the
+ * bigger ones are read from the disk on a worker thread if
+ * GE_TEXTURE_STREAM_THREAD is enabled in config.h, and get uploaded by
+ * ge_texture_stream_update, on the thread that renders, up to a number of
+ * bytes per frame. The GETexture stays the same while it gets more detailed.
+ */
+
+#include <mibiengine2/base/texture.h>
+
+#include <stddef.h>
+
+typedef struct {
+    GETexture *texture;
+    /* The mapped .getex file */
+    GEImage image;
+    /* The first level that is on the GPU */
+    int lod;
+    /* The first level that was read from the disk */
+    int loaded;
+} GETextureStreamItem;
+
+struct GETextureStream {
+    GETextureStreamItem *items;
+    size_t item_num;
+    size_t item_max;
+    /* The max. number of bytes uploaded per frame, that can be changed at
+     * any time */
+    size_t budget;
+    /* The worker thread, or NULL if the levels are read by
+     * ge_texture_stream_update */
+    void *worker;
+};
+
+/* ge_texture_stream_init
+ *
+ * Initialize a texture stream, and start its worker thread.
+ *
+ * stream: The texture stream.
+ * budget: The max. number of bytes uploaded per frame. A level bigger than
+ *         the budget is uploaded in a frame on its own.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_stream_init(GETextureStream *stream, size_t budget);
+
+/* ge_texture_stream_add
+ *
+ * Load a texture from a .getex file with its levels up to
+ * GE_TEXTURE_STREAM_SIZE pixels wide and high, and stream the other ones.
+ * The texture can be used right away, and is freed as usual with
+ * ge_texture_free.
+ *
+ * stream:  The texture stream.
+ * texture: The texture to load.
+ * file:    The file name of the .getex file.
+ * linear:  Use linear filtering instead of nearest neighbour filtering.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_stream_add(GETextureStream *stream, GETexture *texture,
+                          char *file, int linear);
+
+/* ge_texture_stream_update
+ *
+ * Upload the levels that were read from the disk, as long as the budget
+ * isn't exceeded. A texture stops being streamed once all of its levels are
+ * uploaded, or if they get changed by something else, such as a texture
+ * manager. It should be called once per frame.
+ *
+ * stream: The texture stream.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int ge_texture_stream_update(GETextureStream *stream);
+
+/* ge_texture_stream_remove
+ *
+ * Stop streaming a texture, that keeps the levels it has. Called by
+ * ge_texture_free, ge_texture_update and ge_texture_update_region.
+ *
+ * texture: The texture, that has to be streamed.
+ */
+void ge_texture_stream_remove(GETexture *texture);
+
+/* ge_texture_stream_free
+ *
+ * Stop the worker thread and stop streaming all the textures.
+ *
+ * stream: The texture stream.
+ */
+void ge_texture_stream_free(GETextureStream *stream);
+
+#endif
@@ -56,6 +56,40 @@ int ge_utils_power_of_two(int num);
  */
 unsigned long int ge_utils_adler32(unsigned char *data, size_t size);
 
+/* ge_utils_adler32_update
+ *
+ * Update an Adler-32 checksum with more data.
+ *
+ * adler: The checksum of the previous data, 1 if there is none.
+ * data: The data to add to the checksum.
+ * size: The size of the data.
+ * Returns the updated Adler-32 checksum.
+ */
+unsigned long int ge_utils_adler32_update(unsigned long int adler,
+                                          unsigned char *data, size_t size);
+
+/* ge_utils_crc32
+ *
+ * Get the CRC-32 of data, as used by ZLIB and PNG.
+ *
+ * data: The data to get the CRC of.
+ * size: The size of the data.
+ * Returns the CRC-32.
+ */
+unsigned long int ge_utils_crc32(unsigned char *data, size_t size);
+
+/* ge_utils_crc32_update
+ *
+ * Update a CRC-32 with more data.
+ *
+ * crc: The CRC of the previous data, 0 if there is none.
+ * data: The data to add to the CRC.
+ * size: The size of the data.
+ * Returns the updated CRC-32.
+ */
+unsigned long int ge_utils_crc32_update(unsigned long int crc,
+                                        unsigned char *data, size_t size);
+
 /* ge_utils_sort
  *
  * Sort the data in data in the ascending order.
@@ -41,6 +41,116 @@
  */
 
 #define GE_IMAGE_USE_LIBPNG 1
+/* Map the files read by the loaders in memory instead of copying them (see
+ * file.h). */
+#define GE_FILE_USE_MMAP 1
+
+/* OBJ loading */
+
+/* Parse .obj files in chunks of at least GE_OBJ_CHUNK_MIN bytes on up to
+ * GE_OBJ_THREAD_MAX threads. The number of threads can be lowered with the
+ * GE_OBJ_THREADS environment variable. */
+#ifndef __EMSCRIPTEN__
+#define GE_OBJ_THREADS 1
+#else
+#define GE_OBJ_THREADS 0
+#endif
+#define GE_OBJ_THREAD_MAX 16
+#define GE_OBJ_CHUNK_MIN (1<<20)
+/* Save the models loaded by ge_loader_load_obj in binary .gemesh files next
+ * to the .obj files, and map them in memory instead of parsing the .obj files
+ * again on later runs. */
+#define GE_LOADER_MESH_CACHE 1
+
+/* ETC1 compression */
+
+/* Encode the rows of ETC1 blocks on up to GE_ETC1_THREAD_MAX threads. The
+ * number of threads can be lowered with the GE_ETC1_THREADS environment
+ * variable. */
+#ifndef __EMSCRIPTEN__
+#define GE_ETC1_THREADS 1
+#else
+#define GE_ETC1_THREADS 0
+#endif
+#define GE_ETC1_THREAD_MAX 16
+
+/* Texture managers */
+
+/* The mip levels of the textures are only dropped by the texture managers
+ * down to this width or height (see texturemanager.h). */
+#define GE_TEXTURE_MANAGER_MIN_SIZE 16
+
+/* Texture streaming */
+
+/* Read the mip levels streamed by ge_texture_stream_update from the disk on
+ * a worker thread. */
+#ifndef __EMSCRIPTEN__
+#define GE_TEXTURE_STREAM_THREAD 1
+#else
+#define GE_TEXTURE_STREAM_THREAD 0
+#endif
+/* The levels of the streamed textures up to this width and height are loaded
+ * by ge_texture_stream_add (see texturestream.h). */
+#define GE_TEXTURE_STREAM_SIZE 64
+
+/* OpenGL ES backend */
+
+/* Render the instances passed to ge_model_render_multiple in a single draw
+ * call when GL_EXT_instanced_arrays or GL_ANGLE_instanced_arrays is
+ * available. */
+#define GE_GLES_INSTANCING 1
+/* Without instancing extensions, render up to this many instances per draw
+ * call by replicating the models that have at most
+ * GE_GLES_PSEUDO_INSTANCE_VERTICES vertices and uploading the uniforms as
+ * arrays. The replicated models take GE_GLES_PSEUDO_INSTANCES times their size
+ * in video memory once they get drawn in batches, and the small models keep a
+ * copy of their data in memory until then. Set it to 0 to disable it. */
+#define GE_GLES_PSEUDO_INSTANCES 32
+#define GE_GLES_PSEUDO_INSTANCE_VERTICES 1024
+/* Store the array layout of the models in vertex array objects when
+ * GL_OES_vertex_array_object is available. */
+#define GE_GLES_VAO 1
+/* Upload the mip levels of ETC1 .getex files without decompressing them when
+ * GL_OES_compressed_ETC1_RGB8_texture is available. */
+#define GE_GLES_ETC1 1
+/* Compress the opaque textures created from images to ETC1 with this quality
+ * (see etc1.h) when they can be uploaded compressed, or -1 to upload them
+ * uncompressed. */
+#define GE_GLES_ETC1_ENCODE -1
+/* Create the textures with the size of their images when they have no mip
+ * levels or when GL_OES_texture_npot is available, instead of padding them to
+ * a power of two width and height. */
+#define GE_GLES_NPOT 1
+
+/* Software backend */
+
+/* The size of the offscreen buffer used as a window. */
+#define GE_SOFT_WINDOW_WIDTH 480
+#define GE_SOFT_WINDOW_HEIGHT 360
+/* The number of frames rendered by ge_window_mainloop before returning. It
+ * can be overriden with the GE_SOFT_FRAMES environment variable. */
+#define GE_SOFT_WINDOW_FRAMES 60
+/* The size of the square tiles triangles are binned into. */
+#define GE_SOFT_TILE_SIZE 32
+/* The number of triangles that are binned before they get rasterized. */
+#define GE_SOFT_BATCH_MAX 16384
+/* Rasterize every tile row on its own thread. The max. number of threads can
+ * be lowered with the GE_SOFT_THREADS environment variable. */
+#ifndef __EMSCRIPTEN__
+#define GE_SOFT_THREADS 1
+#else
+#define GE_SOFT_THREADS 0
+#endif
+#define GE_SOFT_THREAD_MAX 32
+
+/* Null backend */
+
+/* The size of the window reported to the resize callback. */
+#define GE_NULL_WINDOW_WIDTH 480
+#define GE_NULL_WINDOW_HEIGHT 360
+/* The number of frames rendered by ge_window_mainloop before returning. It
+ * can be overriden with the GE_NULL_FRAMES environment variable. */
+#define GE_NULL_WINDOW_FRAMES 1000
 
 #endif
 
@@ -60,6 +60,12 @@ enum {
     GE_E_ALREADY_ADDED,
     GE_E_NOT_ADDED_YET,
     GE_E_SORT,
+    GE_E_UNKNOWN_BACKEND,
+    GE_E_THREAD,
+    GE_E_INTERLEAVED,
+    GE_E_MESHCACHE_INVALID,
+    GE_E_GETEX_INVALID,
+    GE_E_ATLAS_FULL,
     /* Base - PNG image loading */
     GE_E_NOT_PNG,
     GE_E_IHDR_NOT_FOUND,
@@ -67,6 +73,8 @@ enum {
     GE_E_CORRUPTED_IEND,
     GE_E_CORRUPTED_PLTE,
     GE_E_PNG_TOO_SMALL,
+    GE_E_CORRUPTED_CHUNK,
+    GE_E_INVALID_FILTER,
     GE_E_UNKNOWN_CRITICAL_CHUNK,
     GE_E_INVALID_COLOR_TYPE,
     GE_E_INVALID_BIT_DEPTH,
@@ -75,6 +83,12 @@ enum {
     GE_E_DECOMPRESSION_FAILED,
     GE_E_INVALID_WINDOW_SIZE,
     GE_E_INVALID_BLOCK_TYPE,
+    GE_E_INVALID_ZLIB_HEADER,
+    GE_E_INVALID_HUFFMAN_CODE,
+    GE_E_INVALID_DISTANCE,
+    GE_E_INVALID_STORED_LENGTH,
+    GE_E_OUTPUT_FULL,
+    GE_E_CHECKSUM,
     /* Renderer */
     GE_E_ARENA_INIT,
     GE_E_ARENA_ALLOC,
@@ -36,6 +36,7 @@
 #define GE_FONT_H
 
 #include <mibiengine2/base/image.h>
+#include <mibiengine2/base/atlas.h>
 #include <stddef.h>
 
 typedef enum {
@@ -52,6 +53,8 @@ typedef struct {
 
 typedef struct {
     GEImage *image;
+    /* The area of the image in an atlas, or NULL */
+    GEAtlasRect *rect;
     GEGlyph *glyphs;
     size_t glyph_num;
     unsigned char charset;
@@ -67,6 +70,10 @@ int ge_font_init(GEFont *font, GEImage *image, int variable_width,
                  int min_char_width, int padding, float char_spacing,
                  float line_spacing, GECharset charset);
 
+/* Use the font from the area of its image in an atlas, for the texts that get
+ * created or updated afterwards */
+void ge_font_set_rect(GEFont *font, GEAtlasRect *rect);
+
 void ge_font_free(GEFont *font);
 
 #endif
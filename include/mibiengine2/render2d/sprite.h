@@ -37,6 +37,7 @@
 
 #include <mibiengine2/base/texturedmodel.h>
 #include <mibiengine2/base/texture.h>
+#include <mibiengine2/base/atlas.h>
 #include <mibiengine2/renderer/stdshader.h>
 
 typedef struct {
@@ -48,6 +49,11 @@ typedef struct {
 int ge_sprite_init(GESprite *sprite, GETexture *texture, GEStdShader *shader,
                    float w, float h);
 
+/* Create a sprite from the area of an image in an atlas */
+int ge_sprite_init_rect(GESprite *sprite, GETexture *texture,
+                        GEAtlasRect *rect, GEStdShader *shader, float w,
+                        float h);
+
 void ge_sprite_free(GESprite *sprite);
 
 #endif
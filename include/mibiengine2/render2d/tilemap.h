@@ -37,15 +37,19 @@
 
 #include <mibiengine2/base/texturedmodel.h>
 #include <mibiengine2/base/texture.h>
+#include <mibiengine2/base/atlas.h>
 #include <mibiengine2/renderer/stdshader.h>
 #include <stddef.h>
 
 typedef struct {
     GEModel model;
     GEImage *tileset;
+    /* The area of the tileset in an atlas, or NULL */
+    GEAtlasRect *rect;
     unsigned short int *tiles;
     int tiles_w, tiles_h;
     int w, h;
+    int size;
     float *vertices;
     float *uv_coords;
     unsigned short int *indices;
@@ -58,6 +62,9 @@ int ge_tilemap_init(GETilemap *tilemap, GEImage *tileset, GETexture *texture,
 int ge_tilemap_update(GETilemap *tilemap, unsigned short int *tiles, int w,
                       int h, int size);
 
+/* Use the tileset from its area in an atlas */
+int ge_tilemap_set_rect(GETilemap *tilemap, GEAtlasRect *rect);
+
 #define GE_TILEMAP_GET_MODEL(tilemap) ((tilemap)->model)
 
 void ge_tilemap_free(GETilemap *tilemap);
@@ -47,14 +47,32 @@ varying vec3 frag_normal;
 
 uniform mat4 ge_projection_mat;
 uniform mat4 ge_view_mat;
+
+/* With instanced rendering the model and normal matrices change for each
+ * instance */
+#if defined(GE_INSTANCED)
+attribute mat4 ge_model_mat;
+attribute mat3 ge_normal_mat;
+#define GE_MODEL_MAT ge_model_mat
+#define GE_NORMAL_MAT ge_normal_mat
+#elif defined(GE_PSEUDO_INSTANCES)
+attribute float ge_instance;
+uniform mat4 ge_model_mat[GE_PSEUDO_INSTANCES];
+uniform mat3 ge_normal_mat[GE_PSEUDO_INSTANCES];
+#define GE_MODEL_MAT ge_model_mat[int(ge_instance)]
+#define GE_NORMAL_MAT ge_normal_mat[int(ge_instance)]
+#else
 uniform mat4 ge_model_mat;
 uniform mat3 ge_normal_mat;
+#define GE_MODEL_MAT ge_model_mat
+#define GE_NORMAL_MAT ge_normal_mat
+#endif
 
 void main() {
     frag_color = ge_color;
     frag_uv = ge_uv;
-    frag_normal = normalize(ge_normal_mat*ge_normal);
-    gl_Position = ge_projection_mat*ge_view_mat*ge_model_mat*ge_vertex;
+    frag_normal = normalize(GE_NORMAL_MAT*ge_normal);
+    gl_Position = ge_projection_mat*ge_view_mat*GE_MODEL_MAT*ge_vertex;
     frag_pos = gl_Position;
 }
 
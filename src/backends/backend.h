@@ -91,9 +91,16 @@ typedef struct {
     void (*shader_load_vec2)(GEShaderPos *pos, GEVec2 *vec);
     void (*shader_free)(GEShader *shader);
 
+    void (*texture_layout)(int width, int height, int mipmap,
+                           int *data_width, int *data_height);
     int (*texture_init)(GETexture *texture, GEImage *image, int linear,
-                        int flip);
+                        int flip, int mipmap);
     int (*texture_update)(GETexture *texture, GEImage *image);
+    int (*texture_update_region)(GETexture *texture, GEImage *image, int x,
+                                 int y, int w, int h);
+    void (*texture_memory)(GETexture *texture, size_t *gpu, size_t *cpu);
+    int (*texture_residency)(GETexture *texture, GEImage *image, int lod);
+    void (*texture_release)(GETexture *texture);
     void (*texture_use)(GETexture *texture, GEShaderPos *pos, size_t n);
     void (*texture_free)(GETexture *texture);
 
@@ -35,15 +35,21 @@
 #include <backendlist.h>
 
 #include <gles.h>
+#include <soft.h>
+#include <null.h>
 
 int _ge_backend = GE_B_GLES;
 
 /* That may not be very cache friendly but I didn't find a better solution for
  * now that is flexible enough. */
 GEBackend *_ge_backend_list[GE_B_AMOUNT] = {
-    &_ge_gles_backend
+    &_ge_gles_backend,
+    &_ge_soft_backend,
+    &_ge_null_backend
 };
 
 char *_ge_backend_names[GE_B_AMOUNT] = {
-    "OpenGL ES 2"
+    "OpenGL ES 2",
+    "Software",
+    "Null"
 };
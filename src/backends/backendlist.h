@@ -39,6 +39,8 @@
 
 enum {
     GE_B_GLES,
+    GE_B_SOFT,
+    GE_B_NULL,
     GE_B_AMOUNT
 };
 
@@ -37,6 +37,198 @@
 
 #include <backend.h>
 
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+/* The OpenGL ES extensions that got loaded by _ge_gles_ext_init. The ANGLE
+ * variants of the functions have the same prototypes as the EXT ones. */
+typedef struct {
+    int instanced_arrays;
+    PFNGLVERTEXATTRIBDIVISOREXTPROC vertex_attrib_divisor;
+    PFNGLDRAWARRAYSINSTANCEDEXTPROC draw_arrays_instanced;
+    PFNGLDRAWELEMENTSINSTANCEDEXTPROC draw_elements_instanced;
+    /* The number of instances drawn at once from replicated buffers when
+     * instanced_arrays is not available, 0 if it is not used. */
+    int pseudo_instances;
+    /* The location the ge_instance attribute is bound to */
+    int instance_attr;
+    int vertex_array_object;
+    PFNGLBINDVERTEXARRAYOESPROC bind_vertex_array;
+    PFNGLDELETEVERTEXARRAYSOESPROC delete_vertex_arrays;
+    PFNGLGENVERTEXARRAYSOESPROC gen_vertex_arrays;
+    /* ETC1 textures can be uploaded without being decompressed */
+    int etc1;
+    /* Textures of any size can have mip levels and repeat */
+    int npot;
+} GEGlesExt;
+
+extern GEGlesExt _ge_gles_ext;
+
+/* _ge_gles_ext_has
+ *
+ * Check if an OpenGL ES extension is supported by the current context.
+ *
+ * name: The name of the extension.
+ * Returns 1 if it is supported, 0 otherwise.
+ */
+int _ge_gles_ext_has(char *name);
+
+/* _ge_gles_ext_init
+ *
+ * Load the extensions the backend can use. Should be called once the context
+ * has been made current.
+ */
+void _ge_gles_ext_init(void);
+
+#define GE_GLES_TEX_UNITS 8
+#define GE_GLES_ATTRIB_MAX 32
+
+/* A copy of the OpenGL ES state set by the backend, to skip the calls that
+ * wouldn't change anything. All the state listed here should be changed
+ * through the _ge_gles_state_* functions. */
+typedef struct {
+    GLuint program;
+    GLuint array_buffer;
+    GLuint vao;
+    /* The element buffer and the vertex attribute arrays are part of the
+     * vertex array object state: the values stored here are the ones of the
+     * default vertex array object, which gets bound again before they are
+     * changed. */
+    GLuint element_buffer;
+    /* The enabled vertex attribute arrays, and the ones that are used by the
+     * next draw call. */
+    unsigned long int attribs;
+    unsigned long int attribs_used;
+    struct {
+        GLuint vbo;
+        GLint size;
+        GLenum type;
+        GLsizei stride;
+        const void *ptr;
+    } pointers[GE_GLES_ATTRIB_MAX];
+    GLuint active_texture;
+    GLuint textures[GE_GLES_TEX_UNITS];
+    int depth_test;
+    int blend;
+    GLenum blend_src, blend_dst;
+} GEGlesState;
+
+extern GEGlesState _ge_gles_state;
+
+/* _ge_gles_state_reset
+ *
+ * Reset the state to the defaults of a new context.
+ */
+void _ge_gles_state_reset(void);
+
+/* _ge_gles_state_program
+ *
+ * Use a shader program.
+ *
+ * program: The shader program.
+ */
+void _ge_gles_state_program(GLuint program);
+
+/* _ge_gles_state_vao
+ *
+ * Bind a vertex array object.
+ *
+ * vao: The vertex array object, 0 for the default one.
+ */
+void _ge_gles_state_vao(GLuint vao);
+
+/* _ge_gles_state_vao_free
+ *
+ * Delete a vertex array object and forget about it.
+ *
+ * vao: A pointer to the vertex array object, which is set to 0.
+ */
+void _ge_gles_state_vao_free(GLuint *vao);
+
+/* _ge_gles_state_buffer
+ *
+ * Bind a buffer.
+ *
+ * target: GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+ * buffer: The buffer to bind.
+ */
+void _ge_gles_state_buffer(GLenum target, GLuint buffer);
+
+/* _ge_gles_state_buffer_free
+ *
+ * Delete a buffer and forget about it.
+ *
+ * buffer: A pointer to the buffer, which is set to 0.
+ */
+void _ge_gles_state_buffer_free(GLuint *buffer);
+
+/* _ge_gles_state_attrib
+ *
+ * Enable a vertex attribute array for the next draw call and set its data.
+ *
+ * index:  The position of the attribute.
+ * vbo:    The buffer containing the data.
+ * size:   The number of components per vertex.
+ * type:   The type of the components.
+ * stride: The number of bytes between two vertices, 0 if they are packed.
+ * ptr:    The offset of the data in the buffer.
+ */
+void _ge_gles_state_attrib(GLuint index, GLuint vbo, GLint size, GLenum type,
+                           GLsizei stride, const void *ptr);
+
+/* _ge_gles_state_attrib_unused
+ *
+ * Don't use a vertex attribute array for the next draw call. It only gets
+ * disabled by _ge_gles_state_attrib_flush if no other draw call enables it
+ * again.
+ *
+ * index: The position of the attribute.
+ */
+void _ge_gles_state_attrib_unused(GLuint index);
+
+/* _ge_gles_state_attrib_flush
+ *
+ * Disable the vertex attribute arrays that are not used anymore. Should be
+ * called before each draw call.
+ */
+void _ge_gles_state_attrib_flush(void);
+
+/* _ge_gles_state_texture
+ *
+ * Bind a texture to a texture unit.
+ *
+ * unit:    The texture unit.
+ * texture: The texture to bind.
+ */
+void _ge_gles_state_texture(GLuint unit, GLuint texture);
+
+/* _ge_gles_state_texture_free
+ *
+ * Delete textures and forget about them.
+ *
+ * num:      The number of textures.
+ * textures: The textures, which are set to 0.
+ */
+void _ge_gles_state_texture_free(GLsizei num, GLuint *textures);
+
+/* _ge_gles_state_cap
+ *
+ * Enable or disable a capability.
+ *
+ * cap:     GL_DEPTH_TEST or GL_BLEND.
+ * enabled: Non-zero to enable it.
+ */
+void _ge_gles_state_cap(GLenum cap, int enabled);
+
+/* _ge_gles_state_blend_func
+ *
+ * Set the blending function.
+ *
+ * src: The source factor.
+ * dst: The destination factor.
+ */
+void _ge_gles_state_blend_func(GLenum src, GLenum dst);
+
 int _ge_gles_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
                               size_t tex_count, GEColor *formats,
                               GETexType *type, char *linear);
@@ -63,6 +255,13 @@ int _ge_gles_model_attr_init(GEModelAttr *attr, GEShader *shader,
                              size_t num);
 void _ge_gles_model_free(GEModel *model);
 
+/* _ge_gles_model_instances_free
+ *
+ * Delete the buffer used to stream the per-instance attributes in
+ * _ge_gles_model_render_multiple.
+ */
+void _ge_gles_model_instances_free(void);
+
 int _ge_gles_modelarray_init(GEModelArray *array, void *data, GEType type,
                              size_t size, size_t item_size, int updatable);
 int _ge_gles_modelarray_update(GEModelArray *array, void *data, size_t size);
@@ -70,6 +269,37 @@ int _ge_gles_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr);
 int _ge_gles_modelarray_disable(GEModelArray *array);
 void _ge_gles_modelarray_free(GEModelArray *array);
 
+/* _ge_gles_modelarray_replicate
+ *
+ * Create the buffer with the copies of the data of an array, from the copy
+ * that was kept when it was created, and free that copy. Does nothing if the
+ * array is too big to be replicated or if it was already replicated.
+ *
+ * array: The array to replicate.
+ */
+void _ge_gles_modelarray_replicate(GEModelArray *array);
+
+/* _ge_gles_modelarray_enable_replicated
+ *
+ * Like _ge_gles_modelarray_enable, but use the replicated data of the array.
+ *
+ * array: The array to enable. It should have been replicated.
+ * attr:  The position of the array in the shader.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+int _ge_gles_modelarray_enable_replicated(GEModelArray *array,
+                                          GEModelArrayAttr *attr);
+
+/* _ge_gles_modelarray_setup
+ *
+ * Enable the array in the currently bound vertex array object and set its
+ * data, without going through the state cache (see GEGlesState).
+ *
+ * array: The array.
+ * attr:  The position of the array in the shader.
+ */
+void _ge_gles_modelarray_setup(GEModelArray *array, GEModelArrayAttr *attr);
+
 char *_ge_gles_shader_init(GEShader *shader, char *vertex_source,
                            char *fragment_source);
 void _ge_gles_shader_use(GEShader *shader);
@@ -81,9 +311,16 @@ void _ge_gles_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec);
 void _ge_gles_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec);
 void _ge_gles_shader_free(GEShader *shader);
 
+void _ge_gles_texture_layout(int width, int height, int mipmap,
+                            int *data_width, int *data_height);
 int _ge_gles_texture_init(GETexture *texture, GEImage *image, int linear,
-                          int flip);
+                          int flip, int mipmap);
 int _ge_gles_texture_update(GETexture *texture, GEImage *image);
+int _ge_gles_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h);
+void _ge_gles_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu);
+int _ge_gles_texture_residency(GETexture *texture, GEImage *image, int lod);
+void _ge_gles_texture_release(GETexture *texture);
 void _ge_gles_texture_use(GETexture *texture, GEShaderPos *pos, size_t n);
 void _ge_gles_texture_free(GETexture *texture);
 
@@ -67,8 +67,13 @@ GEBackend _ge_gles_backend = {
     _ge_gles_shader_load_vec2,
     _ge_gles_shader_free,
     
+    _ge_gles_texture_layout,
     _ge_gles_texture_init,
     _ge_gles_texture_update,
+    _ge_gles_texture_update_region,
+    _ge_gles_texture_memory,
+    _ge_gles_texture_residency,
+    _ge_gles_texture_release,
     _ge_gles_texture_use,
     _ge_gles_texture_free,
     
@@ -0,0 +1,146 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gles.h>
+
+#include <EGL/egl.h>
+
+#include <string.h>
+
+#include <mibiengine2/config.h>
+
+/* The instanced shaders need the 4 attributes of the models, the 4 columns
+ * of the model matrix and the 3 columns of the normal matrix */
+#define _GE_GLES_INSTANCED_ATTRIBS 11
+
+GEGlesExt _ge_gles_ext;
+
+int _ge_gles_ext_has(char *name) {
+    const char *extensions;
+    const char *ext;
+    size_t len;
+    
+    extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if(extensions == NULL) return 0;
+    len = strlen(name);
+    /* The extensions are separated by spaces and some of them are prefixes
+     * of others */
+    for(ext=strstr(extensions, name);ext;ext=strstr(ext+len, name)){
+        if((ext == extensions || ext[-1] == ' ') &&
+           (ext[len] == ' ' || ext[len] == '\0')){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void _ge_gles_ext_init(void) {
+#if GE_GLES_INSTANCING || GE_GLES_PSEUDO_INSTANCES
+    GLint attribs;
+#endif
+#if GE_GLES_PSEUDO_INSTANCES
+    GLint vectors;
+    int n;
+#endif
+    memset(&_ge_gles_ext, 0, sizeof(GEGlesExt));
+    
+#if GE_GLES_INSTANCING
+    if(_ge_gles_ext_has("GL_EXT_instanced_arrays")){
+        _ge_gles_ext.vertex_attrib_divisor = (PFNGLVERTEXATTRIBDIVISOREXTPROC)
+                        eglGetProcAddress("glVertexAttribDivisorEXT");
+        _ge_gles_ext.draw_arrays_instanced = (PFNGLDRAWARRAYSINSTANCEDEXTPROC)
+                        eglGetProcAddress("glDrawArraysInstancedEXT");
+        _ge_gles_ext.draw_elements_instanced =
+                        (PFNGLDRAWELEMENTSINSTANCEDEXTPROC)
+                        eglGetProcAddress("glDrawElementsInstancedEXT");
+    }else if(_ge_gles_ext_has("GL_ANGLE_instanced_arrays")){
+        _ge_gles_ext.vertex_attrib_divisor = (PFNGLVERTEXATTRIBDIVISOREXTPROC)
+                        eglGetProcAddress("glVertexAttribDivisorANGLE");
+        _ge_gles_ext.draw_arrays_instanced = (PFNGLDRAWARRAYSINSTANCEDEXTPROC)
+                        eglGetProcAddress("glDrawArraysInstancedANGLE");
+        _ge_gles_ext.draw_elements_instanced =
+                        (PFNGLDRAWELEMENTSINSTANCEDEXTPROC)
+                        eglGetProcAddress("glDrawElementsInstancedANGLE");
+    }
+    _ge_gles_ext.instanced_arrays = _ge_gles_ext.vertex_attrib_divisor &&
+                                    _ge_gles_ext.draw_arrays_instanced &&
+                                    _ge_gles_ext.draw_elements_instanced;
+    /* GLES 2 only guarantees 8 vertex attributes, the uniform arrays are
+     * used instead if there aren't enough of them */
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &attribs);
+    if(attribs < _GE_GLES_INSTANCED_ATTRIBS){
+        _ge_gles_ext.instanced_arrays = 0;
+    }
+#endif
+    
+#if GE_GLES_VAO
+    if(_ge_gles_ext_has("GL_OES_vertex_array_object")){
+        _ge_gles_ext.bind_vertex_array = (PFNGLBINDVERTEXARRAYOESPROC)
+                        eglGetProcAddress("glBindVertexArrayOES");
+        _ge_gles_ext.delete_vertex_arrays = (PFNGLDELETEVERTEXARRAYSOESPROC)
+                        eglGetProcAddress("glDeleteVertexArraysOES");
+        _ge_gles_ext.gen_vertex_arrays = (PFNGLGENVERTEXARRAYSOESPROC)
+                        eglGetProcAddress("glGenVertexArraysOES");
+    }
+    _ge_gles_ext.vertex_array_object = _ge_gles_ext.bind_vertex_array &&
+                                       _ge_gles_ext.delete_vertex_arrays &&
+                                       _ge_gles_ext.gen_vertex_arrays;
+#endif
+    
+#if GE_GLES_ETC1
+    _ge_gles_ext.etc1 =
+                _ge_gles_ext_has("GL_OES_compressed_ETC1_RGB8_texture");
+#endif
+    
+#if GE_GLES_NPOT
+    _ge_gles_ext.npot = _ge_gles_ext_has("GL_OES_texture_npot");
+#endif
+    
+#if GE_GLES_PSEUDO_INSTANCES
+    if(!_ge_gles_ext.instanced_arrays){
+        glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, &vectors);
+        glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &attribs);
+        /* Keep 16 vectors for the other uniforms and allow up to 8 vectors
+         * per instance (a mat4 and a mat3 take 7) */
+        n = (vectors-16)/8;
+        if(n > GE_GLES_PSEUDO_INSTANCES) n = GE_GLES_PSEUDO_INSTANCES;
+        /* The instance ids are stored as unsigned bytes */
+        if(n > 256) n = 256;
+        if(n > 1){
+            _ge_gles_ext.pseudo_instances = n;
+            _ge_gles_ext.instance_attr = attribs-1;
+        }
+    }
+#endif
+}
@@ -39,6 +39,8 @@
 
 #include <GLES2/gl2.h>
 
+#include <gles.h>
+
 int _ge_gles_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
                               size_t tex_count, GEColor *formats,
                               GETexType *type, char *linear) {
@@ -104,7 +106,8 @@ int _ge_gles_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
     for(i=0;i<tex_count;i++){
         /* Create the texture which will hold the data */
         glGenTextures(1, framebuffer->tex+tex_pos);
-        glBindTexture(GL_TEXTURE_2D, framebuffer->tex[tex_pos]);
+        _ge_gles_state_texture(_ge_gles_state.active_texture,
+                               framebuffer->tex[tex_pos]);
         
         switch(type[i]){
             case GE_TEX_COLOR:
@@ -176,13 +179,11 @@ int _ge_gles_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
     
     if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE){
         glDeleteFramebuffers(1, &framebuffer->fbo);
-        glDeleteTextures(1, framebuffer->tex);
+        _ge_gles_state_texture_free(framebuffer->tex_num, framebuffer->tex);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glBindTexture(GL_TEXTURE_2D, 0);
         return GE_E_FRAMEBUFFER_INCOMPLETE;
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
     framebuffer->tex_size.x = w/(float)framebuffer->size;
     framebuffer->tex_size.y = h/(float)framebuffer->size;
     return GE_E_NONE;
@@ -197,7 +198,8 @@ int _ge_gles_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h) {
     
     glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
     for(i=0;i<framebuffer->tex_num;i++){
-        glBindTexture(GL_TEXTURE_2D, framebuffer->tex[i]);
+        _ge_gles_state_texture(_ge_gles_state.active_texture,
+                               framebuffer->tex[i]);
         glTexImage2D(GL_TEXTURE_2D, 0, framebuffer->tex_internal[i],
                      framebuffer->size, framebuffer->size, 0,
                      framebuffer->tex_format[i], framebuffer->tex_type[i],
@@ -207,8 +209,6 @@ int _ge_gles_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h) {
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     
-    glBindTexture(GL_TEXTURE_2D, 0);
-    
     framebuffer->tex_size.x = w/(float)framebuffer->size;
     framebuffer->tex_size.y = h/(float)framebuffer->size;
     return GE_E_NONE;
@@ -231,25 +231,21 @@ int _ge_gles_framebuffer_attr(GEFramebuffer *framebuffer, GEShader *shader,
 
 void _ge_gles_framebuffer_render(GEFramebuffer *framebuffer) {
     size_t i;
-    int textures[GE_FRAMEBUFFER_TEX_MAX] = {
-        GL_TEXTURE0,
-        GL_TEXTURE1,
-        GL_TEXTURE2
-    };
+    int depth_test;
     ge_shader_load_vec2(framebuffer->size_pos, &framebuffer->tex_size);
     for(i=0;i<framebuffer->tex_num;i++){
-        glActiveTexture(textures[i]);
-        glBindTexture(GL_TEXTURE_2D, framebuffer->tex[i]);
+        _ge_gles_state_texture(i, framebuffer->tex[i]);
         glUniform1i(framebuffer->tex_pos[i], i);
     }
-    glDisable(GL_DEPTH_TEST);
+    depth_test = _ge_gles_state.depth_test;
+    _ge_gles_state_cap(GL_DEPTH_TEST, 0);
     ge_model_render(&framebuffer->model);
-    glEnable(GL_DEPTH_TEST);
+    _ge_gles_state_cap(GL_DEPTH_TEST, depth_test);
+    /* Unbind the textures so that they can't be sampled while rendering to
+     * the framebuffer */
     for(i=0;i<framebuffer->tex_num;i++){
-        glActiveTexture(textures[i]);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        _ge_gles_state_texture(i, 0);
     }
-    glActiveTexture(GL_TEXTURE0);
 }
 
 void _ge_gles_framebuffer_use(GEFramebuffer *framebuffer) {
@@ -262,7 +258,7 @@ void _ge_gles_framebuffer_default(void) {
 
 void _ge_gles_framebuffer_free(GEFramebuffer *framebuffer) {
     glDeleteFramebuffers(1, &framebuffer->fbo);
-    glDeleteTextures(framebuffer->tex_num, framebuffer->tex);
+    _ge_gles_state_texture_free(framebuffer->tex_num, framebuffer->tex);
     ge_model_free(&framebuffer->model);
 }
 
@@ -36,10 +36,19 @@
 
 #include <GLES2/gl2.h>
 
+#include <gles.h>
+
+#include <mibiengine2/config.h>
 #include <mibiengine2/errors.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 #define DEF_CASE(d) case d: return #d;
 
+/* The buffer the per-instance attributes are streamed into */
+static GLuint _ge_gles_instance_vbo = 0;
+
 char *_ge_gl_error_str(int error) {
     switch(error){
         DEF_CASE(GL_NO_ERROR)
@@ -52,6 +61,132 @@ char *_ge_gl_error_str(int error) {
     return NULL;
 }
 
+static unsigned long int _ge_gles_model_index(void *indices, GEType type,
+                                              size_t i) {
+    switch(type){
+        case GE_T_CHAR:
+        case GE_T_UCHAR:
+            return ((unsigned char*)indices)[i];
+        case GE_T_SHORT:
+        case GE_T_USHORT:
+            return ((unsigned short int*)indices)[i];
+        case GE_T_INT:
+        case GE_T_UINT:
+            return ((unsigned int*)indices)[i];
+        case GE_T_LONG:
+        case GE_T_ULONG:
+            return ((unsigned long int*)indices)[i];
+        default:
+            return 0;
+    }
+}
+
+static void _ge_gles_model_replicated_free(GEModel *model) {
+    _ge_gles_state_buffer_free(&model->replicated.vbo);
+    _ge_gles_state_buffer_free(&model->replicated.id_vbo);
+    free(model->replicated.indices);
+    model->replicated.indices = NULL;
+    model->replicated.pending = 0;
+    model->replicated.copies = 0;
+}
+
+/* Keep a copy of the indices if the model is small enough to be replicated
+ * (see ge_model_render_multiple). The replicated buffers are only created by
+ * _ge_gles_model_replicate when the model gets drawn in batches. */
+static void _ge_gles_model_keep(GEModel *model, void *indices,
+                                GEType index_type, size_t index_num) {
+    unsigned long int index;
+    size_t i, vertex_num;
+    
+    model->replicated.vbo = 0;
+    model->replicated.id_vbo = 0;
+    model->replicated.indices = NULL;
+    model->replicated.pending = 0;
+    model->replicated.vertex_num = 0;
+    model->replicated.copies = 0;
+    if(_ge_gles_ext.pseudo_instances < 2 || !index_num) return;
+    
+    vertex_num = index_num;
+    if(indices){
+        vertex_num = 0;
+        for(i=0;i<index_num;i++){
+            index = _ge_gles_model_index(indices, index_type, i);
+            if(index >= vertex_num) vertex_num = index+1;
+        }
+    }
+    if(vertex_num > GE_GLES_PSEUDO_INSTANCE_VERTICES) return;
+    
+    if(indices){
+        /* It is only an optimization */
+        model->replicated.indices = malloc(index_num*
+                                           ge_type_size[index_type]);
+        if(model->replicated.indices == NULL) return;
+        memcpy(model->replicated.indices, indices,
+               index_num*ge_type_size[index_type]);
+    }
+    model->replicated.vertex_num = vertex_num;
+    model->replicated.pending = 1;
+}
+
+/* Create the replicated index buffer, with the indices of each copy offset by
+ * the number of vertices of the model, the buffer containing the instance id
+ * of each replicated vertex and the replicated arrays, from the copies kept
+ * by _ge_gles_model_keep. */
+static void _ge_gles_model_replicate(GEModel *model) {
+    unsigned short int *replicated = NULL;
+    unsigned char *ids;
+    void *indices = model->replicated.indices;
+    size_t index_num = model->indices.num;
+    size_t vertex_num = model->replicated.vertex_num;
+    size_t i, n, copies;
+    
+    model->replicated.pending = 0;
+    copies = _ge_gles_ext.pseudo_instances;
+    /* The replicated indices are unsigned shorts */
+    if(copies*vertex_num > 65536) copies = 65536/vertex_num;
+    
+    ids = malloc(copies*vertex_num);
+    if(indices){
+        replicated = malloc(copies*index_num*sizeof(unsigned short int));
+    }
+    /* It is only an optimization */
+    if(copies < 2 || ids == NULL || (indices && replicated == NULL)){
+        free(ids);
+        free(replicated);
+        _ge_gles_model_replicated_free(model);
+        return;
+    }
+    for(n=0;n<copies;n++){
+        memset(ids+n*vertex_num, n, vertex_num);
+        for(i=0;i<index_num && indices;i++){
+            replicated[n*index_num+i] = n*vertex_num+
+                                        _ge_gles_model_index(indices,
+                                                    model->indices.type, i);
+        }
+    }
+    
+    glGenBuffers(1, &model->replicated.id_vbo);
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, model->replicated.id_vbo);
+    glBufferData(GL_ARRAY_BUFFER, copies*vertex_num, ids, GL_STATIC_DRAW);
+    if(indices){
+        glGenBuffers(1, &model->replicated.vbo);
+        _ge_gles_state_buffer(GL_ELEMENT_ARRAY_BUFFER, model->replicated.vbo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                     copies*index_num*sizeof(unsigned short int), replicated,
+                     GL_STATIC_DRAW);
+    }
+    free(ids);
+    free(replicated);
+    free(model->replicated.indices);
+    model->replicated.indices = NULL;
+    model->replicated.copies = copies;
+    
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL) continue;
+        _ge_gles_modelarray_replicate(model->arrays[i]);
+    }
+}
+
 int _ge_gles_model_init(GEModel *model, GEModelArray **arrays,
                         size_t array_num, void *indices, GEType index_type,
                         size_t index_num, int updatable, void *extra) {
@@ -69,13 +204,22 @@ int _ge_gles_model_init(GEModel *model, GEModelArray **arrays,
     model->updatable = updatable;
     
     /* Index array */
+    model->indices.vbo = 0;
+    model->vao = 0;
+    model->vao_layout = 0;
     if(model->indices.data){
         glGenBuffers(1, &model->indices.vbo);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
+        _ge_gles_state_buffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER,
                      index_num*ge_type_size[index_type], indices,
                      model->updatable ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    
+    model->replicated.indices = NULL;
+    model->replicated.pending = 0;
+    model->replicated.copies = 0;
+    if(!updatable){
+        _ge_gles_model_keep(model, indices, index_type, index_num);
     }
     
     model->extra[0] = extra;
@@ -96,11 +240,11 @@ int _ge_gles_model_update_indices(GEModel *model, void *data, size_t size) {
     /* See _ge_gles_modelarray_update in modelarray.c to understand why I added
      * this condition. */
     if(!model->updatable) return GE_E_IMMUTABLE;
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
+    _ge_gles_model_replicated_free(model);
+    _ge_gles_state_buffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER,
                  size*ge_type_size[model->indices.type], data,
                  model->updatable ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     model->indices.num = size;
     return GE_E_NONE;
 }
@@ -110,6 +254,64 @@ int _ge_gles_model_set_attr(GEModel *model, GEModelAttr *attr) {
     return GE_E_NONE;
 }
 
+/* Returns a hash of the layout of the arrays of the model, to know when its
+ * vertex array object needs to be recreated. */
+static unsigned long int _ge_gles_model_layout(GEModel *model) {
+    unsigned long int layout;
+    GEModelArray *array;
+    GEModelArrayAttr *attr;
+    size_t i;
+    layout = model->indices.vbo;
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
+            continue;
+        }
+        array = model->arrays[i];
+        layout = layout*31+i;
+        layout = layout*31+array->vbo;
+        layout = layout*31+array->item_size;
+        layout = layout*31+array->type;
+        for(attr=model->attr->array_pos[i];attr!=NULL;attr=attr->next){
+            layout = layout*31+attr->pos;
+            layout = layout*31+attr->item_size;
+            layout = layout*31+attr->stride;
+            layout = layout*31+attr->offset;
+        }
+    }
+    return layout;
+}
+
+/* Bind the vertex array object of the model, after (re)creating it if the
+ * layout of the arrays changed. Returns 1 if it got bound or 0 if vertex
+ * array objects are not available. */
+static int _ge_gles_model_vao(GEModel *model) {
+    unsigned long int layout;
+    size_t i;
+    
+    if(!_ge_gles_ext.vertex_array_object) return 0;
+    layout = _ge_gles_model_layout(model);
+    if(model->vao && model->vao_layout == layout){
+        _ge_gles_state_vao(model->vao);
+        return 1;
+    }
+    
+    _ge_gles_state_vao_free(&model->vao);
+    _ge_gles_ext.gen_vertex_arrays(1, &model->vao);
+    _ge_gles_state_vao(model->vao);
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
+            continue;
+        }
+        _ge_gles_modelarray_setup(model->arrays[i], model->attr->array_pos[i]);
+    }
+    /* The element buffer binding is stored in the vertex array object */
+    if(model->indices.data){
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
+    }
+    model->vao_layout = layout;
+    return 1;
+}
+
 void _ge_gles_model_render(GEModel *model) {
     int gl_types[GE_T_AMOUNT] = {
         0,
@@ -125,6 +327,7 @@ void _ge_gles_model_render(GEModel *model) {
         GL_FLOAT
     };
     size_t i;
+    int vao;
     
     /* If the rendering attributes are not set, the model cannot be rendered */
     if(model->attr == NULL) return;
@@ -136,7 +339,9 @@ void _ge_gles_model_render(GEModel *model) {
         }
     }
     
-    for(i=0;i<model->array_num;i++){
+    vao = _ge_gles_model_vao(model);
+    
+    for(i=0;i<model->array_num && !vao;i++){
         if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
             continue;
         }
@@ -144,11 +349,12 @@ void _ge_gles_model_render(GEModel *model) {
     }
     
     /* Bind the index array */
-    if(model->indices.data){
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
+    if(model->indices.data && !vao){
+        _ge_gles_state_buffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
     }
     
     /* Draw the model */
+    if(!vao) _ge_gles_state_attrib_flush();
     if(model->indices.data){
         glDrawElements(GL_TRIANGLES, model->indices.num,
                        gl_types[model->indices.type], 0);
@@ -156,11 +362,9 @@ void _ge_gles_model_render(GEModel *model) {
         glDrawArrays(GL_TRIANGLES, 0, model->indices.num);
     }
     
-    /* Unbind the index buffer */
-    if(model->indices.data) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    
-    /* Unbind the buffers */
-    for(i=0;i<model->array_num;i++){
+    /* The arrays only get disabled before the next draw call that doesn't
+     * use them */
+    for(i=0;i<model->array_num && !vao;i++){
         if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
             continue;
         }
@@ -175,10 +379,134 @@ void _ge_gles_model_render(GEModel *model) {
     }
 }
 
+/* Returns 1 if all the uniforms of ge_model_render_multiple can be sent as
+ * per-instance attributes. */
+static int _ge_gles_model_can_instance(GEShaderPos **pos,
+                                       size_t uniform_count) {
+    size_t i;
+    if(!_ge_gles_ext.instanced_arrays) return 0;
+    for(i=0;i<uniform_count;i++){
+        /* A real uniform cannot change between instances */
+        if(pos[i]->pos >= 0) return 0;
+    }
+    return 1;
+}
+
+/* Stream the uniforms into the instance buffer and set them up as
+ * per-instance attributes, or disable the attributes again if enable is 0. */
+static void _ge_gles_model_instance_attr(GEShaderPos **pos,
+                                         GEUniformType *types,
+                                         void **uniforms,
+                                         size_t uniform_count, size_t count,
+                                         int enable) {
+    int uniform_sizes[GE_U_AMOUNT] = {
+        sizeof(GEMat4),
+        sizeof(GEMat3),
+        sizeof(GEVec4),
+        sizeof(GEVec3),
+        sizeof(GEVec2)
+    };
+    /* Matrices use one attribute per column */
+    int uniform_columns[GE_U_AMOUNT] = {4, 3, 1, 1, 1};
+    int uniform_components[GE_U_AMOUNT] = {4, 3, 4, 3, 2};
+    size_t i, size, offset;
+    int n, attr;
+    
+    if(enable){
+        size = 0;
+        for(i=0;i<uniform_count;i++){
+            if(pos[i]->attr >= 0) size += count*uniform_sizes[types[i]];
+        }
+        if(!_ge_gles_instance_vbo) glGenBuffers(1, &_ge_gles_instance_vbo);
+        _ge_gles_state_buffer(GL_ARRAY_BUFFER, _ge_gles_instance_vbo);
+        /* Orphan the previous data to avoid waiting for the draw calls that
+         * are still using it */
+        glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+    }
+    
+    offset = 0;
+    for(i=0;i<uniform_count;i++){
+        if(pos[i]->attr < 0) continue;
+        size = count*uniform_sizes[types[i]];
+        if(enable){
+            glBufferSubData(GL_ARRAY_BUFFER, offset, size, uniforms[i]);
+        }
+        for(n=0;n<uniform_columns[types[i]];n++){
+            attr = pos[i]->attr+n;
+            if(!enable){
+                _ge_gles_ext.vertex_attrib_divisor(attr, 0);
+                _ge_gles_state_attrib_unused(attr);
+                continue;
+            }
+            _ge_gles_state_attrib(attr, _ge_gles_instance_vbo,
+                                  uniform_components[types[i]], GL_FLOAT,
+                                  uniform_sizes[types[i]],
+                                  (void*)(offset+n*
+                                          uniform_components[types[i]]*
+                                          sizeof(float)));
+            _ge_gles_ext.vertex_attrib_divisor(attr, 1);
+        }
+        offset += size;
+    }
+    
+}
+
+/* Returns the number of instances that can be drawn at once from the
+ * replicated buffers of the model, after creating them the first time, or 0
+ * if they cannot be used. */
+static size_t _ge_gles_model_pseudo_batch(GEModel *model, GEShaderPos **pos,
+                                          size_t uniform_count) {
+    size_t i, batch;
+    
+    batch = _ge_gles_ext.pseudo_instances;
+    for(i=0;i<uniform_count;i++){
+        /* Unused uniforms don't need to be loaded */
+        if(pos[i]->pos < 0 && pos[i]->attr < 0) continue;
+        if(pos[i]->pos < 0 || pos[i]->size < 2) return 0;
+        if((size_t)pos[i]->size < batch) batch = pos[i]->size;
+    }
+    /* The shader can draw the model in batches, so the replicated buffers
+     * are worth their memory */
+    if(model->replicated.pending) _ge_gles_model_replicate(model);
+    if(model->replicated.copies < batch) batch = model->replicated.copies;
+    if(batch < 2) return 0;
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
+            continue;
+        }
+        if(!model->arrays[i]->replicated_vbo) return 0;
+    }
+    return batch;
+}
+
+/* Load num elements of a uniform array */
+static void _ge_gles_model_load_uniforms(GEShaderPos *pos, GEUniformType type,
+                                         void *data, size_t num) {
+    if(pos->pos < 0) return;
+    switch(type){
+        case GE_U_MAT4:
+            glUniformMatrix4fv(pos->pos, num, 0, data);
+            break;
+        case GE_U_MAT3:
+            glUniformMatrix3fv(pos->pos, num, 0, data);
+            break;
+        case GE_U_VEC4:
+            glUniform4fv(pos->pos, num, data);
+            break;
+        case GE_U_VEC3:
+            glUniform3fv(pos->pos, num, data);
+            break;
+        case GE_U_VEC2:
+            glUniform2fv(pos->pos, num, data);
+            break;
+        default:
+            break;
+    }
+}
+
 void _ge_gles_model_render_multiple(GEModel *model, GEShaderPos **pos,
                                     GEUniformType *types, void **uniforms,
                                     size_t uniform_count, size_t count) {
-    /* TODO: Use GL_EXT_draw_instanced if possible. */
     int uniform_sizes[GE_U_AMOUNT] = {
         sizeof(GEMat4),
         sizeof(GEMat3),
@@ -199,10 +527,12 @@ void _ge_gles_model_render_multiple(GEModel *model, GEShaderPos **pos,
         GL_FLOAT,
         GL_FLOAT
     };
-    size_t i, n;
+    size_t i, n, num, batch;
+    int instanced;
+    int vao = 0;
     
     /* If the rendering attributes are not set, the model cannot be rendered */
-    if(model->attr == NULL) return;
+    if(model->attr == NULL || !count) return;
     
     for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
         if(model->calls[i].before_rendering){
@@ -211,20 +541,76 @@ void _ge_gles_model_render_multiple(GEModel *model, GEShaderPos **pos,
         }
     }
     
-    for(i=0;i<model->array_num;i++){
+    instanced = _ge_gles_model_can_instance(pos, uniform_count);
+    batch = 0;
+    if(!instanced && count > 1){
+        batch = _ge_gles_model_pseudo_batch(model, pos, uniform_count);
+    }
+    if(!instanced && !batch) vao = _ge_gles_model_vao(model);
+    
+    for(i=0;i<model->array_num && !vao;i++){
         if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
             continue;
         }
-        ge_modelarray_enable(model->arrays[i], model->attr->array_pos[i]);
+        if(batch){
+            _ge_gles_modelarray_enable_replicated(model->arrays[i],
+                                                  model->attr->array_pos[i]);
+        }else{
+            ge_modelarray_enable(model->arrays[i], model->attr->array_pos[i]);
+        }
     }
     
     /* Bind the index array */
-    if(model->indices.data){
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model->indices.vbo);
+    if(model->indices.data && !vao){
+        _ge_gles_state_buffer(GL_ELEMENT_ARRAY_BUFFER,
+                              batch ? model->replicated.vbo :
+                                      model->indices.vbo);
+    }
+    
+    if(batch){
+        /* Draw batch instances at once, each one of them indexing the uniform
+         * arrays with its instance id */
+        _ge_gles_state_attrib(_ge_gles_ext.instance_attr,
+                              model->replicated.id_vbo, 1, GL_UNSIGNED_BYTE, 0,
+                              0);
+        _ge_gles_state_attrib_flush();
+        for(i=0;i<count;i+=batch){
+            num = count-i < batch ? count-i : batch;
+            for(n=0;n<uniform_count;n++){
+                _ge_gles_model_load_uniforms(pos[n], types[n],
+                                             (char*)uniforms[n]+
+                                             i*uniform_sizes[types[n]], num);
+            }
+            if(model->indices.data){
+                glDrawElements(GL_TRIANGLES, num*model->indices.num,
+                               GL_UNSIGNED_SHORT, 0);
+            }else{
+                glDrawArrays(GL_TRIANGLES, 0,
+                             num*model->replicated.vertex_num);
+            }
+        }
+        _ge_gles_state_attrib_unused(_ge_gles_ext.instance_attr);
+    }else if(instanced){
+        /* Draw all the instances at once */
+        _ge_gles_model_instance_attr(pos, types, uniforms, uniform_count,
+                                     count, 1);
+        _ge_gles_state_attrib_flush();
+        if(model->indices.data){
+            _ge_gles_ext.draw_elements_instanced(GL_TRIANGLES,
+                                             model->indices.num,
+                                             gl_types[model->indices.type], 0,
+                                             count);
+        }else{
+            _ge_gles_ext.draw_arrays_instanced(GL_TRIANGLES, 0,
+                                               model->indices.num, count);
+        }
+        _ge_gles_model_instance_attr(pos, types, uniforms, uniform_count,
+                                     count, 0);
     }
     
     /* Draw the model multiple times */
-    for(i=0;i<count;i++){
+    if(!instanced && !batch && !vao) _ge_gles_state_attrib_flush();
+    for(i=0;i<count && !instanced && !batch;i++){
         /* Load all the uniform variables */
         for(n=0;n<uniform_count;n++){
             ge_shader_load_any(pos[n], types[n],
@@ -238,11 +624,9 @@ void _ge_gles_model_render_multiple(GEModel *model, GEShaderPos **pos,
         }
     }
     
-    /* Unbind the index buffer */
-    if(model->indices.data) glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    
-    /* Unbind the buffers */
-    for(i=0;i<model->array_num;i++){
+    /* The arrays only get disabled before the next draw call that doesn't
+     * use them */
+    for(i=0;i<model->array_num && !vao;i++){
         if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
             continue;
         }
@@ -257,6 +641,10 @@ void _ge_gles_model_render_multiple(GEModel *model, GEShaderPos **pos,
     }
 }
 
+void _ge_gles_model_instances_free(void) {
+    _ge_gles_state_buffer_free(&_ge_gles_instance_vbo);
+}
+
 int _ge_gles_model_attr_init(GEModelAttr *attr, GEShader *shader,
                              GEModelArrayAttr **array_attr, char **names,
                              size_t num) {
@@ -284,6 +672,9 @@ void _ge_gles_model_free(GEModel *model) {
         if(model->arrays[i] == NULL) continue;
         ge_modelarray_free(model->arrays[i]);
     }
+    _ge_gles_state_buffer_free(&model->indices.vbo);
+    _ge_gles_model_replicated_free(model);
+    if(model->vao) _ge_gles_state_vao_free(&model->vao);
     
     for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
         if(model->calls[i].after_free){
@@ -36,8 +36,53 @@
 
 #include <GLES2/gl2.h>
 
+#include <gles.h>
+
+#include <mibiengine2/config.h>
 #include <mibiengine2/errors.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep a copy of the data if the array is small enough to be replicated
+ * (see ge_model_render_multiple), the replicated buffer only gets created if
+ * the model is drawn in batches. */
+static void _ge_gles_modelarray_keep(GEModelArray *array) {
+    size_t size;
+    
+    array->replicated_data = NULL;
+    if(_ge_gles_ext.pseudo_instances < 2 || array->data == NULL) return;
+    if(array->size/array->item_size > GE_GLES_PSEUDO_INSTANCE_VERTICES){
+        return;
+    }
+    size = array->size*ge_type_size[array->type];
+    /* It is only an optimization */
+    array->replicated_data = malloc(size);
+    if(array->replicated_data == NULL) return;
+    memcpy(array->replicated_data, array->data, size);
+}
+
+void _ge_gles_modelarray_replicate(GEModelArray *array) {
+    size_t i, size;
+    char *data;
+    
+    if(array->replicated_vbo || array->replicated_data == NULL) return;
+    size = array->size*ge_type_size[array->type];
+    data = malloc(size*_ge_gles_ext.pseudo_instances);
+    /* The array will just not be replicated */
+    if(data == NULL) return;
+    for(i=0;i<(size_t)_ge_gles_ext.pseudo_instances;i++){
+        memcpy(data+i*size, array->replicated_data, size);
+    }
+    glGenBuffers(1, &array->replicated_vbo);
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, array->replicated_vbo);
+    glBufferData(GL_ARRAY_BUFFER, size*_ge_gles_ext.pseudo_instances, data,
+                 GL_STATIC_DRAW);
+    free(data);
+    free(array->replicated_data);
+    array->replicated_data = NULL;
+}
+
 int _ge_gles_modelarray_init(GEModelArray *array, void *data, GEType type,
                              size_t size, size_t item_size, int updatable) {
     array->data = data;
@@ -48,10 +93,13 @@ int _ge_gles_modelarray_init(GEModelArray *array, void *data, GEType type,
     array->updatable = 1;
     
     glGenBuffers(1, &array->vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, array->vbo);
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, array->vbo);
     glBufferData(GL_ARRAY_BUFFER, size*ge_type_size[type],
                  data, updatable ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    array->replicated_vbo = 0;
+    array->replicated_data = NULL;
+    if(!updatable) _ge_gles_modelarray_keep(array);
     return GE_E_NONE;
 }
 
@@ -61,45 +109,83 @@ int _ge_gles_modelarray_update(GEModelArray *array, void *data, size_t size) {
      * future backends which may be able to improve performance if the array
      * doesn't need to be updated. */
     if(!array->updatable) return GE_E_IMMUTABLE;
-    glBindBuffer(GL_ARRAY_BUFFER, array->vbo);
+    /* The replicated data is out of date now */
+    _ge_gles_state_buffer_free(&array->replicated_vbo);
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, array->vbo);
     glBufferData(GL_ARRAY_BUFFER, size*ge_type_size[array->type],
                  data, array->updatable ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
     return GE_E_NONE;
 }
 
-int _ge_gles_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr) {
-    int gl_types[GE_T_AMOUNT] = {
-        0,
-        GL_BYTE,
-        GL_UNSIGNED_BYTE,
-        GL_SHORT,
-        GL_UNSIGNED_SHORT,
-        GL_INT,
-        GL_UNSIGNED_INT,
-        GL_INT,
-        GL_UNSIGNED_INT,
-        GL_FLOAT,
-        GL_FLOAT
-    };
-    glBindBuffer(GL_ARRAY_BUFFER, array->vbo);
-    glEnableVertexAttribArray(attr->pos);
-    glVertexAttribPointer(attr->pos, array->item_size, gl_types[array->type],
-                          GL_FALSE, 0, 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+static int _ge_gles_modelarray_gl_types[GE_T_AMOUNT] = {
+    0,
+    GL_BYTE,
+    GL_UNSIGNED_BYTE,
+    GL_SHORT,
+    GL_UNSIGNED_SHORT,
+    GL_INT,
+    GL_UNSIGNED_INT,
+    GL_INT,
+    GL_UNSIGNED_INT,
+    GL_FLOAT,
+    GL_FLOAT
+};
+
+static int _ge_gles_modelarray_bind(GEModelArray *array,
+                                    GEModelArrayAttr *attr, unsigned int vbo) {
+    GEModelArrayAttr *cur;
+    size_t type_size = ge_type_size[array->type];
+    for(cur=attr;cur!=NULL;cur=cur->next){
+        if(cur->pos < 0) continue;
+        _ge_gles_state_attrib(cur->pos, vbo,
+                              GE_MODELARRAY_ATTR_ITEM_SIZE(array, cur),
+                              _ge_gles_modelarray_gl_types[array->type],
+                              cur->stride*type_size,
+                              (void*)(cur->offset*type_size));
+    }
     array->current_attr = attr;
     return GE_E_NONE;
 }
 
+int _ge_gles_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr) {
+    return _ge_gles_modelarray_bind(array, attr, array->vbo);
+}
+
+int _ge_gles_modelarray_enable_replicated(GEModelArray *array,
+                                          GEModelArrayAttr *attr) {
+    return _ge_gles_modelarray_bind(array, attr, array->replicated_vbo);
+}
+
+void _ge_gles_modelarray_setup(GEModelArray *array, GEModelArrayAttr *attr) {
+    GEModelArrayAttr *cur;
+    size_t type_size = ge_type_size[array->type];
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, array->vbo);
+    for(cur=attr;cur!=NULL;cur=cur->next){
+        if(cur->pos < 0) continue;
+        glEnableVertexAttribArray(cur->pos);
+        glVertexAttribPointer(cur->pos,
+                              GE_MODELARRAY_ATTR_ITEM_SIZE(array, cur),
+                              _ge_gles_modelarray_gl_types[array->type],
+                              GL_FALSE,
+                              cur->stride*type_size,
+                              (void*)(cur->offset*type_size));
+    }
+}
+
 int _ge_gles_modelarray_disable(GEModelArray *array) {
+    GEModelArrayAttr *cur;
     if(array->current_attr == NULL) return 1;
-    glDisableVertexAttribArray(array->current_attr->pos);
+    for(cur=array->current_attr;cur!=NULL;cur=cur->next){
+        if(cur->pos >= 0) _ge_gles_state_attrib_unused(cur->pos);
+    }
     array->current_attr = NULL;
     return GE_E_NONE;
 }
 
 void _ge_gles_modelarray_free(GEModelArray *array) {
-    glDeleteBuffers(1, &array->vbo);
-    array->vbo = 0;
+    _ge_gles_state_buffer_free(&array->vbo);
+    _ge_gles_state_buffer_free(&array->replicated_vbo);
+    free(array->replicated_data);
+    array->replicated_data = NULL;
 }
 
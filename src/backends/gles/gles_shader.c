@@ -36,15 +36,24 @@
 
 #include <GLES2/gl2.h>
 #include <stddef.h>
+#include <string.h>
+
+#include <gles.h>
 
 #include <mibiengine2/errors.h>
 #include <mibiengine2/base/shadertree.h>
 
 #include <stdio.h>
 
+#define _GE_GLES_SHADER_NAME_MAX 64
+
 char *_ge_gles_shader_init(GEShader *shader, char *vertex_source,
                            char *fragment_source) {
     static char log[GE_SHADER_LOG_SIZE];
+    char defines[64];
+    const char *vertex_sources[3];
+    GLint vertex_sizes[3];
+    char *line_end;
     int success;
     char *errors[GE_S_E_AMOUNT] = {
         "No error",
@@ -69,8 +78,31 @@ char *_ge_gles_shader_init(GEShader *shader, char *vertex_source,
     /* Load the shader */
     shader->shader_program = glCreateProgram();
     shader->vertex_shader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(shader->vertex_shader, 1,
-                  (const char* const*)&vertex_source, NULL);
+    /* Tell the vertex shader how it can declare the uniforms that change for
+     * each instance in ge_model_render_multiple: as vertex attributes or as
+     * arrays indexed by ge_instance. The define needs to be after the
+     * #version directive, if there is one. */
+    defines[0] = '\0';
+    if(_ge_gles_ext.instanced_arrays){
+        strcpy(defines, "#define GE_INSTANCED 1\n");
+    }else if(_ge_gles_ext.pseudo_instances){
+        sprintf(defines, "#define GE_PSEUDO_INSTANCES %d\n",
+                _ge_gles_ext.pseudo_instances);
+    }
+    vertex_sources[0] = vertex_source;
+    vertex_sizes[0] = 0;
+    vertex_sources[1] = defines;
+    vertex_sizes[1] = strlen(defines);
+    vertex_sources[2] = vertex_source;
+    vertex_sizes[2] = strlen(vertex_source);
+    line_end = strchr(vertex_source, '\n');
+    if(line_end != NULL && !strncmp(vertex_source+strspn(vertex_source, " \t"),
+                                    "#version", 8)){
+        vertex_sizes[0] = line_end+1-vertex_source;
+        vertex_sources[2] = line_end+1;
+        vertex_sizes[2] -= vertex_sizes[0];
+    }
+    glShaderSource(shader->vertex_shader, 3, vertex_sources, vertex_sizes);
     glCompileShader(shader->vertex_shader);
     /* Return the log if required */
     glGetShaderiv(shader->vertex_shader, GL_COMPILE_STATUS, &success);
@@ -98,6 +130,10 @@ char *_ge_gles_shader_init(GEShader *shader, char *vertex_source,
     /* Link the shader program */
     glAttachShader(shader->shader_program, shader->vertex_shader);
     glAttachShader(shader->shader_program, shader->fragment_shader);
+    if(_ge_gles_ext.pseudo_instances){
+        glBindAttribLocation(shader->shader_program,
+                             _ge_gles_ext.instance_attr, "ge_instance");
+    }
     glLinkProgram(shader->shader_program);
     glGetProgramiv(shader->shader_program, GL_LINK_STATUS, &success);
     if(!success){
@@ -112,32 +148,83 @@ char *_ge_gles_shader_init(GEShader *shader, char *vertex_source,
 }
 
 void _ge_gles_shader_use(GEShader *shader) {
-    glUseProgram(shader->shader_program);
+    _ge_gles_state_program(shader->shader_program);
 }
 
 GEShaderPos _ge_gles_shader_get_pos(GEShader *shader, char *name) {
     GEShaderPos pos;
+    char active_name[_GE_GLES_SHADER_NAME_MAX];
+    GLint uniform_num;
+    GLint i, size;
+    GLenum type;
+    size_t len;
     pos.pos = glGetUniformLocation(shader->shader_program, name);
+    /* Get the size of the uniform if it is an array. Array names end with
+     * [0] */
+    pos.size = 1;
+    len = strlen(name);
+    glGetProgramiv(shader->shader_program, GL_ACTIVE_UNIFORMS, &uniform_num);
+    for(i=0;i<uniform_num && pos.pos >= 0;i++){
+        glGetActiveUniform(shader->shader_program, i,
+                           _GE_GLES_SHADER_NAME_MAX, NULL, &size, &type,
+                           active_name);
+        if(!strncmp(active_name, name, len) && (active_name[len] == '\0' ||
+                                                active_name[len] == '[')){
+            pos.size = size;
+            break;
+        }
+    }
+    /* It may have been declared as a per-instance attribute */
+    pos.attr = -1;
+    if(pos.pos < 0){
+        pos.attr = glGetAttribLocation(shader->shader_program, name);
+    }
     return pos;
 }
 
+/* When the variable is a per-instance attribute, it is loaded as a constant
+ * vertex attribute, which is used as long as its array is disabled. Matrices
+ * take one attribute per column. */
+
 void _ge_gles_shader_load_mat4(GEShaderPos *pos, GEMat4 *mat) {
+    int i;
+    if(pos->pos < 0 && pos->attr >= 0){
+        for(i=0;i<4;i++) glVertexAttrib4fv(pos->attr+i, mat->mat+i*4);
+        return;
+    }
     glUniformMatrix4fv(pos->pos, 1, 0, mat->mat);
 }
 
 void _ge_gles_shader_load_mat3(GEShaderPos *pos, GEMat3 *mat) {
+    int i;
+    if(pos->pos < 0 && pos->attr >= 0){
+        for(i=0;i<3;i++) glVertexAttrib3fv(pos->attr+i, mat->mat+i*3);
+        return;
+    }
     glUniformMatrix3fv(pos->pos, 1, 0, mat->mat);
 }
 
 void _ge_gles_shader_load_vec4(GEShaderPos *pos, GEVec4 *vec) {
+    if(pos->pos < 0 && pos->attr >= 0){
+        glVertexAttrib4f(pos->attr, vec->x, vec->y, vec->z, vec->w);
+        return;
+    }
     glUniform4f(pos->pos, vec->x, vec->y, vec->z, vec->w);
 }
 
 void _ge_gles_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec) {
+    if(pos->pos < 0 && pos->attr >= 0){
+        glVertexAttrib3f(pos->attr, vec->x, vec->y, vec->z);
+        return;
+    }
     glUniform3f(pos->pos, vec->x, vec->y, vec->z);
 }
 
 void _ge_gles_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec) {
+    if(pos->pos < 0 && pos->attr >= 0){
+        glVertexAttrib2f(pos->attr, vec->x, vec->y);
+        return;
+    }
     glUniform2f(pos->pos, vec->x, vec->y);
 }
 
@@ -0,0 +1,197 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gles.h>
+
+#include <string.h>
+
+GEGlesState _ge_gles_state;
+
+void _ge_gles_state_reset(void) {
+    memset(&_ge_gles_state, 0, sizeof(GEGlesState));
+    _ge_gles_state.blend_src = GL_ONE;
+    _ge_gles_state.blend_dst = GL_ZERO;
+}
+
+void _ge_gles_state_program(GLuint program) {
+    if(_ge_gles_state.program == program) return;
+    glUseProgram(program);
+    _ge_gles_state.program = program;
+}
+
+void _ge_gles_state_vao(GLuint vao) {
+    if(_ge_gles_state.vao == vao) return;
+    _ge_gles_ext.bind_vertex_array(vao);
+    _ge_gles_state.vao = vao;
+}
+
+void _ge_gles_state_vao_free(GLuint *vao) {
+    if(!*vao) return;
+    _ge_gles_ext.delete_vertex_arrays(1, vao);
+    /* Deleting the bound vertex array object binds the default one */
+    if(_ge_gles_state.vao == *vao) _ge_gles_state.vao = 0;
+    *vao = 0;
+}
+
+void _ge_gles_state_buffer(GLenum target, GLuint buffer) {
+    GLuint *bound;
+    if(target == GL_ELEMENT_ARRAY_BUFFER && _ge_gles_state.vao){
+        _ge_gles_state_vao(0);
+    }
+    bound = target == GL_ELEMENT_ARRAY_BUFFER ?
+            &_ge_gles_state.element_buffer : &_ge_gles_state.array_buffer;
+    if(*bound == buffer) return;
+    glBindBuffer(target, buffer);
+    *bound = buffer;
+}
+
+void _ge_gles_state_buffer_free(GLuint *buffer) {
+    size_t i;
+    if(!*buffer) return;
+    /* Only detach it from the default vertex array object, which is the one
+     * this state is about */
+    if(_ge_gles_state.vao) _ge_gles_state_vao(0);
+    glDeleteBuffers(1, buffer);
+    /* Deleting a buffer resets all the bindings to it to 0 */
+    if(_ge_gles_state.array_buffer == *buffer){
+        _ge_gles_state.array_buffer = 0;
+    }
+    if(_ge_gles_state.element_buffer == *buffer){
+        _ge_gles_state.element_buffer = 0;
+    }
+    for(i=0;i<GE_GLES_ATTRIB_MAX;i++){
+        if(_ge_gles_state.pointers[i].vbo == *buffer){
+            _ge_gles_state.pointers[i].vbo = 0;
+            _ge_gles_state.pointers[i].size = 0;
+        }
+    }
+    *buffer = 0;
+}
+
+void _ge_gles_state_attrib(GLuint index, GLuint vbo, GLint size, GLenum type,
+                           GLsizei stride, const void *ptr) {
+    if(_ge_gles_state.vao) _ge_gles_state_vao(0);
+    if(index >= GE_GLES_ATTRIB_MAX){
+        _ge_gles_state_buffer(GL_ARRAY_BUFFER, vbo);
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(index, size, type, GL_FALSE, stride, ptr);
+        return;
+    }
+    _ge_gles_state.attribs_used |= 1UL<<index;
+    if(!(_ge_gles_state.attribs&(1UL<<index))){
+        glEnableVertexAttribArray(index);
+        _ge_gles_state.attribs |= 1UL<<index;
+    }
+    if(_ge_gles_state.pointers[index].vbo == vbo &&
+       _ge_gles_state.pointers[index].size == size &&
+       _ge_gles_state.pointers[index].type == type &&
+       _ge_gles_state.pointers[index].stride == stride &&
+       _ge_gles_state.pointers[index].ptr == ptr){
+        return;
+    }
+    _ge_gles_state_buffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(index, size, type, GL_FALSE, stride, ptr);
+    _ge_gles_state.pointers[index].vbo = vbo;
+    _ge_gles_state.pointers[index].size = size;
+    _ge_gles_state.pointers[index].type = type;
+    _ge_gles_state.pointers[index].stride = stride;
+    _ge_gles_state.pointers[index].ptr = ptr;
+}
+
+void _ge_gles_state_attrib_unused(GLuint index) {
+    if(index >= GE_GLES_ATTRIB_MAX){
+        if(_ge_gles_state.vao) _ge_gles_state_vao(0);
+        glDisableVertexAttribArray(index);
+        return;
+    }
+    _ge_gles_state.attribs_used &= ~(1UL<<index);
+}
+
+void _ge_gles_state_attrib_flush(void) {
+    unsigned long int unused;
+    GLuint i;
+    if(_ge_gles_state.vao) _ge_gles_state_vao(0);
+    unused = _ge_gles_state.attribs&~_ge_gles_state.attribs_used;
+    for(i=0;unused;i++,unused>>=1){
+        if(unused&1) glDisableVertexAttribArray(i);
+    }
+    _ge_gles_state.attribs = _ge_gles_state.attribs_used;
+}
+
+void _ge_gles_state_texture(GLuint unit, GLuint texture) {
+    if(unit < GE_GLES_TEX_UNITS && _ge_gles_state.textures[unit] == texture){
+        return;
+    }
+    if(_ge_gles_state.active_texture != unit){
+        glActiveTexture(GL_TEXTURE0+unit);
+        _ge_gles_state.active_texture = unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if(unit < GE_GLES_TEX_UNITS) _ge_gles_state.textures[unit] = texture;
+}
+
+void _ge_gles_state_texture_free(GLsizei num, GLuint *textures) {
+    GLsizei i;
+    size_t n;
+    glDeleteTextures(num, textures);
+    /* Deleting a texture resets all the bindings to it to 0 */
+    for(i=0;i<num;i++){
+        for(n=0;n<GE_GLES_TEX_UNITS;n++){
+            if(_ge_gles_state.textures[n] == textures[i]){
+                _ge_gles_state.textures[n] = 0;
+            }
+        }
+        textures[i] = 0;
+    }
+}
+
+void _ge_gles_state_cap(GLenum cap, int enabled) {
+    int *current;
+    current = cap == GL_BLEND ? &_ge_gles_state.blend :
+                                &_ge_gles_state.depth_test;
+    enabled = enabled != 0;
+    if(*current == enabled) return;
+    if(enabled) glEnable(cap);
+    else glDisable(cap);
+    *current = enabled;
+}
+
+void _ge_gles_state_blend_func(GLenum src, GLenum dst) {
+    if(_ge_gles_state.blend_src == src && _ge_gles_state.blend_dst == dst){
+        return;
+    }
+    glBlendFunc(src, dst);
+    _ge_gles_state.blend_src = src;
+    _ge_gles_state.blend_dst = dst;
+}
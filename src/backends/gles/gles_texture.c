@@ -35,115 +35,339 @@
 #include <mibiengine2/base/texture.h>
 
 #include <mibiengine2/base/utils.h>
+#include <mibiengine2/base/etc1.h>
+#include <mibiengine2/base/mipmap.h>
 
 #include <GLES2/gl2.h>
 
+#include <gles.h>
+
 #include <stdlib.h>
 #include <string.h>
 
 #include <mibiengine2/errors.h>
+#include <mibiengine2/config.h>
 
-int _ge_gles_texture_init(GETexture *texture, GEImage *image, int linear,
-                          int flip) {
-    size_t x, y;
-    size_t tex_y;
-    int bytes;
-    unsigned char color[4];
-    /* Make a copy of the texture in RGBA color format as a square texture */
-    texture->size = ge_utils_power_of_two(image->width > image->height ?
-                                          image->width : image->height);
+/* Returns 1 if both sides of a texture are powers of two */
+static int _ge_gles_texture_power_of_two(int width, int height) {
+    return !(width&(width-1)) && !(height&(height-1));
+}
+
+void _ge_gles_texture_layout(int width, int height, int mipmap,
+                             int *data_width, int *data_height) {
+#if GE_GLES_NPOT
+    /* OpenGL ES 2 supports textures of any size without mip levels, as long
+     * as they don't repeat, which the shaders handle themselves. */
+    if(!mipmap || _ge_gles_ext.npot){
+        *data_width = width;
+        *data_height = height;
+        return;
+    }
+#else
+    (void)mipmap;
+#endif
+    *data_width = ge_utils_power_of_two(width);
+    *data_height = ge_utils_power_of_two(height);
+}
+
+/* Returns 1 if the pixels of an image laid out for a texture can be uploaded
+ * as they are */
+static int _ge_gles_texture_fits(GETexture *texture, GEImage *image) {
+    if(!image->data_width || !image->flip != !texture->flip) return 0;
+    if(_ge_gles_texture_power_of_two(image->data_width, image->data_height)){
+        return 1;
+    }
+    if(texture->mipmap || image->levels > 1) return _ge_gles_ext.npot;
+    return GE_GLES_NPOT;
+}
+
+static int _ge_gles_texture_copy(GETexture *texture, GEImage *image) {
+    int fits = _ge_gles_texture_fits(texture, image);
+    if(fits){
+        texture->data_width = image->data_width;
+        texture->data_height = image->data_height;
+    }else{
+        _ge_gles_texture_layout(image->width, image->height, texture->mipmap,
+                                &texture->data_width, &texture->data_height);
+    }
     texture->width = image->width;
     texture->height = image->height;
-    texture->flip = flip;
-    texture->uv_max.x = image->width/(float)texture->size;
-    texture->uv_max.y = image->height/(float)texture->size;
-    texture->data = malloc(texture->size*texture->size*4);
+    texture->uv_max.x = image->width/(float)texture->data_width;
+    texture->uv_max.y = image->height/(float)texture->data_height;
+    if(fits){
+        if(image->file.data != NULL){
+            /* The pixels get uploaded straight from the mapped file */
+            texture->data = NULL;
+            return GE_E_NONE;
+        }
+        /* The image was decoded in the layout of the texture, take its
+         * pixels over */
+        texture->data = image->data;
+        image->data = NULL;
+        return GE_E_NONE;
+    }
+    /* Make a copy of the texture in RGBA color format */
+    texture->data = calloc((size_t)texture->data_width*texture->data_height,
+                           4);
     if(texture->data == NULL){
         return GE_E_OUT_OF_MEM;
     }
-    bytes = image->row_bytes/image->width;
-    memset(texture->data, 0, texture->size*texture->size*4);
-    for(y=0;y<image->height;y++){
-        for(x=0;x<image->width;x++){
-            memcpy(color, image->data+(y*image->width+x)*bytes,
-                   bytes <= 4 ? bytes : 4);
-            if(4-bytes > 0) memset(color+bytes, 255, 4-bytes);
-            if(flip) tex_y = (texture->size-y-1);
-            else tex_y = y;
-            memcpy(texture->data+(tex_y*texture->size+x)*4,
-                   color, 4);
+    ge_image_copy_texture(image, texture->data, texture->data_width,
+                          texture->data_height, texture->flip);
+    return GE_E_NONE;
+}
+
+#if GE_GLES_ETC1_ENCODE >= 0
+/* Returns 1 if all the pixels of the texture are opaque, without looking at
+ * its padding */
+static int _ge_gles_texture_opaque(GETexture *texture) {
+    size_t x, y;
+    unsigned char *alpha;
+    for(y=0;y<(size_t)texture->height;y++){
+        alpha = texture->data+(texture->flip ? texture->data_height-1-y : y)*
+                              texture->data_width*4+3;
+        for(x=0;x<(size_t)texture->width;x++,alpha+=4){
+            if(*alpha != 255) return 0;
         }
     }
-    /* Upload the texture to the GPU */
+    return 1;
+}
+#endif
+
+/* _ge_gles_texture_upload
+ *
+ * Upload the pixels of the bound texture, or all the mip levels of the image
+ * if they are used without being copied. The mip levels of textures with a
+ * single RGBA level are generated first if they were requested. ETC1 levels
+ * are uploaded compressed if GL_OES_compressed_ETC1_RGB8_texture is
+ * available and decoded otherwise. The first texture->lod levels are
+ * skipped, the next one becoming the first level of the texture.
+ *
+ * texture: The texture.
+ * image:   The image the texture was created from.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+static int _ge_gles_texture_upload(GETexture *texture, GEImage *image) {
+    unsigned char *data = texture->data;
+    unsigned char *chain = NULL;
+    unsigned char *compressed = NULL;
+    unsigned char *pixels = NULL;
+    int format = GE_IMAGE_FORMAT_RGBA8;
+    int width = texture->data_width;
+    int height = texture->data_height;
+    int levels = 1;
+    int wrap = GL_REPEAT;
+    int lod;
+    int i;
+    int rc;
+#if GE_GLES_ETC1_ENCODE >= 0
+    unsigned char *level;
+    unsigned char *out;
+    size_t bytes;
+    int w, h;
+#endif
+    if(data == NULL){
+        data = image->data;
+        levels = image->levels;
+        format = image->format;
+    }
+    if(texture->mipmap && levels == 1 && format == GE_IMAGE_FORMAT_RGBA8){
+        chain = malloc(ge_mipmap_size(width, height));
+        if(chain == NULL) return GE_E_OUT_OF_MEM;
+        memcpy(chain, data, (size_t)width*height*4);
+        rc = ge_mipmap_chain(chain, width, height, texture->mipmap);
+        if(rc){
+            free(chain);
+            return rc;
+        }
+        data = chain;
+        levels = ge_mipmap_levels(width, height);
+    }
+#if GE_GLES_ETC1_ENCODE >= 0
+    if(texture->data != NULL && _ge_gles_ext.etc1 &&
+       _ge_gles_texture_opaque(texture)){
+        bytes = 0;
+        for(i=0,w=width,h=height;i<levels;i++,w=w>1?w/2:1,h=h>1?h/2:1){
+            bytes += ge_etc1_size(w, h);
+        }
+        compressed = malloc(bytes);
+        if(compressed != NULL){
+            level = data;
+            out = compressed;
+            for(i=0,w=width,h=height;i<levels;i++,w=w>1?w/2:1,h=h>1?h/2:1){
+                ge_etc1_encode(out, level, (long)w*4, w, h,
+                               GE_GLES_ETC1_ENCODE);
+                level += (size_t)w*h*4;
+                out += ge_etc1_size(w, h);
+            }
+            data = compressed;
+            format = GE_IMAGE_FORMAT_ETC1;
+        }
+    }
+#endif
+    /* Keep at least the last level */
+    lod = texture->lod < levels ? texture->lod : levels-1;
+    if(format == GE_IMAGE_FORMAT_ETC1 && !_ge_gles_ext.etc1){
+        pixels = malloc((size_t)width*height*4);
+        if(pixels == NULL){
+            free(chain);
+            return GE_E_OUT_OF_MEM;
+        }
+    }
+    if(!_ge_gles_ext.npot &&
+       !_ge_gles_texture_power_of_two(width, height)){
+        wrap = GL_CLAMP_TO_EDGE;
+    }
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    levels-lod > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    for(i=0;i<levels;i++){
+        if(i < lod){
+            /* This level was dropped */
+        }else if(format == GE_IMAGE_FORMAT_RGBA8){
+            glTexImage2D(GL_TEXTURE_2D, i-lod, GL_RGBA, width, height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }else if(pixels == NULL){
+            glCompressedTexImage2D(GL_TEXTURE_2D, i-lod, GL_ETC1_RGB8_OES,
+                                   width, height, 0,
+                                   ge_etc1_size(width, height), data);
+        }else{
+            ge_etc1_decode(pixels, (long)width*4, data, width, height);
+            glTexImage2D(GL_TEXTURE_2D, i-lod, GL_RGBA, width, height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+        data += ge_image_level_size(format, width, height);
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    texture->format = format;
+    texture->levels = levels;
+    texture->lod = lod;
+    free(pixels);
+    free(compressed);
+    free(chain);
+    return GE_E_NONE;
+}
+
+/* Create the texture on the GPU and bind it */
+static void _ge_gles_texture_create(GETexture *texture) {
     glGenTextures(1, &texture->id);
-    glBindTexture(GL_TEXTURE_2D, texture->id);
+    _ge_gles_state_texture(_ge_gles_state.active_texture, texture->id);
     
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-                    linear ? GL_LINEAR : GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture->size, texture->size, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, texture->data);
-    return GE_E_NONE;
+                    texture->linear ? GL_LINEAR : GL_NEAREST);
+}
+
+int _ge_gles_texture_init(GETexture *texture, GEImage *image, int linear,
+                          int flip, int mipmap) {
+    texture->flip = flip;
+    texture->mipmap = mipmap;
+    texture->linear = linear;
+    if(_ge_gles_texture_copy(texture, image)) return GE_E_OUT_OF_MEM;
+    /* Upload the texture to the GPU */
+    _ge_gles_texture_create(texture);
+    return _ge_gles_texture_upload(texture, image);
+}
+
+/* Returns 1 if the texture keeps a copy of its pixels the image can be copied
+ * into */
+static int _ge_gles_texture_reusable(GETexture *texture, GEImage *image) {
+    return texture->data != NULL && (int)image->width == texture->width &&
+           (int)image->height == texture->height;
 }
 
 int _ge_gles_texture_update(GETexture *texture, GEImage *image) {
-    size_t x, y;
-    size_t tex_y;
-    int bytes;
-    unsigned char color[4];
-    /* TODO: Do not entirely recreate it if it has the same size as the
-     * previous one. */
-    /* Make a copy of the texture in RGBA color format as a square texture */
-    texture->size = ge_utils_power_of_two(image->width > image->height ?
-                                          image->width : image->height);
-    texture->width = image->width;
-    texture->height = image->height;
-    texture->uv_max.x = image->width/(float)texture->size;
-    texture->uv_max.y = image->height/(float)texture->size;
+    if(_ge_gles_texture_reusable(texture, image)){
+        return _ge_gles_texture_update_region(texture, image, 0, 0,
+                                              image->width, image->height);
+    }
     free(texture->data);
-    texture->data = malloc(texture->size*texture->size*4);
-    if(texture->data == NULL){
-        return GE_E_OUT_OF_MEM;
+    if(_ge_gles_texture_copy(texture, image)) return GE_E_OUT_OF_MEM;
+    /* Upload the texture to the GPU */
+    _ge_gles_state_texture(_ge_gles_state.active_texture, texture->id);
+    return _ge_gles_texture_upload(texture, image);
+}
+
+int _ge_gles_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h) {
+    int row;
+    if(!_ge_gles_texture_reusable(texture, image)){
+        return _ge_gles_texture_update(texture, image);
     }
-    bytes = image->row_bytes/image->width;
-    memset(texture->data, 0, texture->size*texture->size*4);
-    for(y=0;y<image->height;y++){
-        for(x=0;x<image->width;x++){
-            memcpy(color, image->data+(y*image->width+x)*bytes,
-                   bytes <= 4 ? bytes : 4);
-            if(4-bytes > 0) memset(color+bytes, 255, 4-bytes);
-            if(texture->flip) tex_y = (texture->size-y-1);
-            else tex_y = y;
-            memcpy(texture->data+(tex_y*texture->size+x)*4,
-                   color, 4);
-        }
+    /* The copy of the pixels is used as a staging buffer */
+    ge_image_copy_region(image, texture->data, texture->data_width,
+                         texture->data_height, texture->flip, x, y, w, h);
+    _ge_gles_state_texture(_ge_gles_state.active_texture, texture->id);
+    if(texture->mipmap || texture->format != GE_IMAGE_FORMAT_RGBA8){
+        return _ge_gles_texture_upload(texture, image);
     }
-    /* Upload the texture to the GPU */
+    /* OpenGL ES 2 can't skip the start and the end of the rows of the
+     * pixels, so whole rows are uploaded */
+    row = texture->flip ? texture->data_height-y-h : y;
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glBindTexture(GL_TEXTURE_2D, texture->id);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture->size, texture->size, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, texture->data);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, texture->data_width, h,
+                    GL_RGBA, GL_UNSIGNED_BYTE,
+                    texture->data+(size_t)row*texture->data_width*4);
     return GE_E_NONE;
 }
 
+void _ge_gles_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu) {
+    /* ETC1 levels are decoded if they can't be uploaded compressed */
+    int format = _ge_gles_ext.etc1 ? texture->format : GE_IMAGE_FORMAT_RGBA8;
+    int width = texture->data_width;
+    int height = texture->data_height;
+    int i;
+    *cpu = 0;
+    if(texture->data != NULL){
+        *cpu = (size_t)texture->data_width*texture->data_height*4;
+    }
+    *gpu = 0;
+    if(texture->lod == GE_TEXTURE_EVICTED) return;
+    for(i=0;i<texture->levels;i++){
+        if(i >= texture->lod){
+            *gpu += ge_image_level_size(format, width, height);
+        }
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+}
+
+int _ge_gles_texture_residency(GETexture *texture, GEImage *image, int lod) {
+    if(lod == GE_TEXTURE_EVICTED){
+        _ge_gles_state_texture_free(1, &texture->id);
+        texture->lod = lod;
+        return GE_E_NONE;
+    }
+    if(texture->data == NULL){
+        /* The copy of the pixels was released, use the ones of the image */
+        if(image == NULL) return GE_E_UNKNOWN;
+        if(_ge_gles_texture_copy(texture, image)) return GE_E_OUT_OF_MEM;
+    }
+    /* Create the texture again so that the levels that got dropped don't
+     * stay allocated */
+    _ge_gles_state_texture_free(1, &texture->id);
+    _ge_gles_texture_create(texture);
+    texture->lod = lod;
+    return _ge_gles_texture_upload(texture, image);
+}
+
+void _ge_gles_texture_release(GETexture *texture) {
+    free(texture->data);
+    texture->data = NULL;
+}
+
 void _ge_gles_texture_use(GETexture *texture, GEShaderPos *pos, size_t n) {
     /* OpenGL requires at least support for 16 texture units per stage */
     if(n >= 16) n = 15;
-    glActiveTexture(GL_TEXTURE0+n);
-    glBindTexture(GL_TEXTURE_2D, texture->id);
+    _ge_gles_state_texture(n, texture->id);
     glUniform1i(pos->pos, n);
-    glActiveTexture(GL_TEXTURE0);
 }
 
 void _ge_gles_texture_free(GETexture *texture) {
     free(texture->data);
     texture->data = NULL;
-    glDeleteTextures(1, &texture->id);
-    texture->id = 0;
+    _ge_gles_state_texture_free(1, &texture->id);
 }
 
@@ -50,6 +50,8 @@
 
 #include <mibiengine2/config.h>
 
+#include <gles.h>
+
 #include <mibiengine2/errors.h>
 
 /*
@@ -275,7 +277,10 @@ int _ge_gles_window_init(GEWindow *window, char *title) {
     glDebugMessageCallback(_ge_window_debug_callback, NULL);
 #endif
     
-    glEnable(GL_DEPTH_TEST);
+    _ge_gles_ext_init();
+    _ge_gles_state_reset();
+    
+    _ge_gles_state_cap(GL_DEPTH_TEST, 1);
     glDepthFunc(GL_LEQUAL);
     /*glEnable(GL_TEXTURE_2D);*/
     
@@ -307,18 +312,13 @@ int _ge_gles_window_cap_framerate(GEWindow *window, int cap) {
 
 void _ge_gles_window_depth_test(GEWindow *window, int depth_test) {
     (void)window;
-    if(depth_test) glEnable(GL_DEPTH_TEST);
-    else glDisable(GL_DEPTH_TEST);
+    _ge_gles_state_cap(GL_DEPTH_TEST, depth_test);
 }
 
 void _ge_gles_window_blending(GEWindow *window, int blend) {
     (void)window;
-    if(blend){
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    }else{
-        glDisable(GL_BLEND);
-    }
+    _ge_gles_state_cap(GL_BLEND, blend);
+    if(blend) _ge_gles_state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 unsigned long _ge_gles_window_ms(GEWindow *window) {
@@ -851,6 +851,9 @@ void _ge_gles_window_view(GEWindow *window, int w, int h) {
 }
 
 void _ge_gles_window_free(GEWindow *window) {
+    /* Delete the buffers the backend created itself while the context is
+     * still current */
+    _ge_gles_model_instances_free();
     /* Delete all the EGL and Xlib stuff */
     if(eglMakeCurrent(*(EGLDisplay*)window->egl.display, EGL_NO_SURFACE,
                       EGL_NO_SURFACE, EGL_NO_CONTEXT) == EGL_FALSE){
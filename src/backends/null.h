@@ -0,0 +1,204 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_NULL_H
+#define GE_NULL_H
+
+#include <backend.h>
+
+/* null.h
+ *
+ * A backend that doesn't render anything. Every function only records how
+ * many times it got called and how many bytes it would have sent to the
+ * driver, to measure the time spent in the engine itself.
+ *
+ * ge_window_mainloop renders GE_NULL_WINDOW_FRAMES frames (or the number of
+ * frames given in the GE_NULL_FRAMES environment variable) and prints the
+ * time spent per frame and the calls and bytes per frame of each function.
+ */
+
+enum {
+    GE_NULL_FRAMEBUFFER_INIT,
+    GE_NULL_FRAMEBUFFER_RESIZE,
+    GE_NULL_FRAMEBUFFER_ATTR,
+    GE_NULL_FRAMEBUFFER_RENDER,
+    GE_NULL_FRAMEBUFFER_USE,
+    GE_NULL_FRAMEBUFFER_DEFAULT,
+    GE_NULL_FRAMEBUFFER_FREE,
+    
+    GE_NULL_MODEL_INIT,
+    GE_NULL_MODEL_UPDATE_INDICES,
+    GE_NULL_MODEL_SET_ATTR,
+    GE_NULL_MODEL_RENDER,
+    GE_NULL_MODEL_RENDER_MULTIPLE,
+    GE_NULL_MODEL_ATTR_INIT,
+    GE_NULL_MODEL_FREE,
+    
+    GE_NULL_MODELARRAY_INIT,
+    GE_NULL_MODELARRAY_UPDATE,
+    GE_NULL_MODELARRAY_ENABLE,
+    GE_NULL_MODELARRAY_DISABLE,
+    GE_NULL_MODELARRAY_FREE,
+    
+    GE_NULL_SHADER_INIT,
+    GE_NULL_SHADER_USE,
+    GE_NULL_SHADER_GET_POS,
+    GE_NULL_SHADER_LOAD_MAT4,
+    GE_NULL_SHADER_LOAD_MAT3,
+    GE_NULL_SHADER_LOAD_VEC4,
+    GE_NULL_SHADER_LOAD_VEC3,
+    GE_NULL_SHADER_LOAD_VEC2,
+    GE_NULL_SHADER_FREE,
+    
+    GE_NULL_TEXTURE_INIT,
+    GE_NULL_TEXTURE_UPDATE,
+    GE_NULL_TEXTURE_UPDATE_REGION,
+    GE_NULL_TEXTURE_RESIDENCY,
+    GE_NULL_TEXTURE_RELEASE,
+    GE_NULL_TEXTURE_USE,
+    GE_NULL_TEXTURE_FREE,
+    
+    GE_NULL_WINDOW_INIT,
+    GE_NULL_WINDOW_SET_DATA,
+    GE_NULL_WINDOW_CAP_FRAMERATE,
+    GE_NULL_WINDOW_DEPTH_TEST,
+    GE_NULL_WINDOW_BLENDING,
+    GE_NULL_WINDOW_MS,
+    GE_NULL_WINDOW_KEY_PRESSED,
+    GE_NULL_WINDOW_MAINLOOP,
+    GE_NULL_WINDOW_CLEAR,
+    GE_NULL_WINDOW_VIEW,
+    GE_NULL_WINDOW_FREE,
+    
+    /* Draw calls, with the size of the indices they use */
+    GE_NULL_DRAW,
+    
+    GE_NULL_AMOUNT
+};
+
+typedef struct {
+    unsigned long int calls[GE_NULL_AMOUNT];
+    unsigned long int bytes[GE_NULL_AMOUNT];
+} GENullStats;
+
+extern GENullStats _ge_null_stats;
+
+/* GE_NULL_COUNT
+ *
+ * Record a call to a function.
+ *
+ * fnc:   The function (GE_NULL_*).
+ * bytes: The number of bytes that would have been sent to the driver.
+ */
+#define GE_NULL_COUNT(fnc, num) { \
+        _ge_null_stats.calls[fnc]++; \
+        _ge_null_stats.bytes[fnc] += (num); \
+    }
+
+void _ge_null_stats_reset(void);
+void _ge_null_stats_print(unsigned long int frames, double us);
+
+int _ge_null_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
+                              size_t tex_count, GEColor *formats,
+                              GETexType *type, char *linear);
+int _ge_null_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h);
+int _ge_null_framebuffer_attr(GEFramebuffer *framebuffer, GEShader *shader,
+                              char **attr_names, char **tex_names,
+                              GEShaderPos *size_pos);
+void _ge_null_framebuffer_render(GEFramebuffer *framebuffer);
+void _ge_null_framebuffer_use(GEFramebuffer *framebuffer);
+void _ge_null_framebuffer_default(void);
+void _ge_null_framebuffer_free(GEFramebuffer *framebuffer);
+
+int _ge_null_model_init(GEModel *model, GEModelArray **arrays,
+                        size_t array_num, void *indices, GEType index_type,
+                        size_t index_num, int updatable, void *extra);
+int _ge_null_model_update_indices(GEModel *model, void *data, size_t size);
+int _ge_null_model_set_attr(GEModel *model, GEModelAttr *attr);
+void _ge_null_model_render(GEModel *model);
+void _ge_null_model_render_multiple(GEModel *model, GEShaderPos **pos,
+                                    GEUniformType *types, void **uniforms,
+                                    size_t uniform_count, size_t count);
+int _ge_null_model_attr_init(GEModelAttr *attr, GEShader *shader,
+                             GEModelArrayAttr **array_attr, char **names,
+                             size_t num);
+void _ge_null_model_free(GEModel *model);
+
+int _ge_null_modelarray_init(GEModelArray *array, void *data, GEType type,
+                             size_t size, size_t item_size, int updatable);
+int _ge_null_modelarray_update(GEModelArray *array, void *data, size_t size);
+int _ge_null_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr);
+int _ge_null_modelarray_disable(GEModelArray *array);
+void _ge_null_modelarray_free(GEModelArray *array);
+
+char *_ge_null_shader_init(GEShader *shader, char *vertex_source,
+                           char *fragment_source);
+void _ge_null_shader_use(GEShader *shader);
+GEShaderPos _ge_null_shader_get_pos(GEShader *shader, char *name);
+void _ge_null_shader_load_mat4(GEShaderPos *pos, GEMat4 *mat);
+void _ge_null_shader_load_mat3(GEShaderPos *pos, GEMat3 *mat);
+void _ge_null_shader_load_vec4(GEShaderPos *pos, GEVec4 *vec);
+void _ge_null_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec);
+void _ge_null_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec);
+void _ge_null_shader_free(GEShader *shader);
+
+void _ge_null_texture_layout(int width, int height, int mipmap,
+                            int *data_width, int *data_height);
+int _ge_null_texture_init(GETexture *texture, GEImage *image, int linear,
+                          int flip, int mipmap);
+int _ge_null_texture_update(GETexture *texture, GEImage *image);
+int _ge_null_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h);
+void _ge_null_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu);
+int _ge_null_texture_residency(GETexture *texture, GEImage *image, int lod);
+void _ge_null_texture_release(GETexture *texture);
+void _ge_null_texture_use(GETexture *texture, GEShaderPos *pos, size_t n);
+void _ge_null_texture_free(GETexture *texture);
+
+int _ge_null_window_init(GEWindow *window, char *title);
+int _ge_null_window_set_data(GEWindow *window, void *data);
+int _ge_null_window_cap_framerate(GEWindow *window, int cap);
+void _ge_null_window_depth_test(GEWindow *window, int depth_test);
+void _ge_null_window_blending(GEWindow *window, int blend);
+unsigned long _ge_null_window_ms(GEWindow *window);
+int _ge_null_window_key_pressed(GEWindow *window, GEKey key);
+void _ge_null_window_mainloop(GEWindow *window);
+void _ge_null_window_clear(GEWindow *window, float r, float g, float b,
+                           float a);
+void _ge_null_window_view(GEWindow *window, int w, int h);
+void _ge_null_window_free(GEWindow *window);
+
+extern GEBackend _ge_null_backend;
+
+#endif
@@ -0,0 +1,172 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <null.h>
+
+#include <stdio.h>
+
+GENullStats _ge_null_stats;
+
+GEBackend _ge_null_backend = {
+    _ge_null_framebuffer_init,
+    _ge_null_framebuffer_resize,
+    _ge_null_framebuffer_attr,
+    _ge_null_framebuffer_render,
+    _ge_null_framebuffer_use,
+    _ge_null_framebuffer_default,
+    _ge_null_framebuffer_free,
+    
+    _ge_null_model_init,
+    _ge_null_model_update_indices,
+    _ge_null_model_set_attr,
+    _ge_null_model_render,
+    _ge_null_model_render_multiple,
+    _ge_null_model_attr_init,
+    _ge_null_model_free,
+    
+    _ge_null_modelarray_init,
+    _ge_null_modelarray_update,
+    _ge_null_modelarray_enable,
+    _ge_null_modelarray_disable,
+    _ge_null_modelarray_free,
+    
+    _ge_null_shader_init,
+    _ge_null_shader_use,
+    _ge_null_shader_get_pos,
+    _ge_null_shader_load_mat4,
+    _ge_null_shader_load_mat3,
+    _ge_null_shader_load_vec4,
+    _ge_null_shader_load_vec3,
+    _ge_null_shader_load_vec2,
+    _ge_null_shader_free,
+    
+    _ge_null_texture_layout,
+    _ge_null_texture_init,
+    _ge_null_texture_update,
+    _ge_null_texture_update_region,
+    _ge_null_texture_memory,
+    _ge_null_texture_residency,
+    _ge_null_texture_release,
+    _ge_null_texture_use,
+    _ge_null_texture_free,
+    
+    _ge_null_window_init,
+    _ge_null_window_set_data,
+    _ge_null_window_cap_framerate,
+    _ge_null_window_depth_test,
+    _ge_null_window_blending,
+    _ge_null_window_ms,
+    _ge_null_window_key_pressed,
+    _ge_null_window_mainloop,
+    _ge_null_window_clear,
+    _ge_null_window_view,
+    _ge_null_window_free
+};
+
+void _ge_null_stats_reset(void) {
+    size_t i;
+    for(i=0;i<GE_NULL_AMOUNT;i++){
+        _ge_null_stats.calls[i] = 0;
+        _ge_null_stats.bytes[i] = 0;
+    }
+}
+
+void _ge_null_stats_print(unsigned long int frames, double us) {
+    char *names[GE_NULL_AMOUNT] = {
+        "framebuffer_init",
+        "framebuffer_resize",
+        "framebuffer_attr",
+        "framebuffer_render",
+        "framebuffer_use",
+        "framebuffer_default",
+        "framebuffer_free",
+        
+        "model_init",
+        "model_update_indices",
+        "model_set_attr",
+        "model_render",
+        "model_render_multiple",
+        "model_attr_init",
+        "model_free",
+        
+        "modelarray_init",
+        "modelarray_update",
+        "modelarray_enable",
+        "modelarray_disable",
+        "modelarray_free",
+        
+        "shader_init",
+        "shader_use",
+        "shader_get_pos",
+        "shader_load_mat4",
+        "shader_load_mat3",
+        "shader_load_vec4",
+        "shader_load_vec3",
+        "shader_load_vec2",
+        "shader_free",
+        
+        "texture_init",
+        "texture_update",
+        "texture_update_region",
+        "texture_residency",
+        "texture_release",
+        "texture_use",
+        "texture_free",
+        
+        "window_init",
+        "window_set_data",
+        "window_cap_framerate",
+        "window_depth_test",
+        "window_blending",
+        "window_ms",
+        "window_key_pressed",
+        "window_mainloop",
+        "window_clear",
+        "window_view",
+        "window_free",
+        
+        "draw_calls"
+    };
+    size_t i;
+    if(!frames) frames = 1;
+    printf("Null backend: %lu frames in %.3f ms (%.3f us per frame)\n",
+           frames, us/1e3, us/frames);
+    printf("%-24s %14s %14s\n", "Function", "Calls/frame", "Bytes/frame");
+    for(i=0;i<GE_NULL_AMOUNT;i++){
+        if(!_ge_null_stats.calls[i]) continue;
+        printf("%-24s %14.2f %14.2f\n", names[i],
+               _ge_null_stats.calls[i]/(double)frames,
+               _ge_null_stats.bytes[i]/(double)frames);
+    }
+}
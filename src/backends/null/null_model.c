@@ -0,0 +1,229 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <null.h>
+
+#include <mibiengine2/errors.h>
+
+int _ge_null_model_init(GEModel *model, GEModelArray **arrays,
+                        size_t array_num, void *indices, GEType index_type,
+                        size_t index_num, int updatable, void *extra) {
+    size_t i;
+    
+    GE_NULL_COUNT(GE_NULL_MODEL_INIT, indices ?
+                  index_num*ge_type_size[index_type] : 0);
+    
+    model->indices.data = indices;
+    model->indices.type = index_type;
+    
+    model->indices.num = index_num;
+    model->indices.vbo = 0;
+    
+    model->arrays = arrays;
+    model->array_num = array_num;
+    
+    model->updatable = updatable;
+    
+    model->extra[0] = extra;
+    /* The model attributes are required for rendering but need to be set
+     * later */
+    model->attr = NULL;
+    for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
+        model->calls[i].before_rendering = NULL;
+        model->calls[i].after_rendering = NULL;
+        model->calls[i].before_free = NULL;
+        model->calls[i].after_free = NULL;
+    }
+    model->call_ptr = 0;
+    return GE_E_NONE;
+}
+
+int _ge_null_model_update_indices(GEModel *model, void *data, size_t size) {
+    (void)data;
+    GE_NULL_COUNT(GE_NULL_MODEL_UPDATE_INDICES,
+                  size*ge_type_size[model->indices.type]);
+    if(!model->updatable) return GE_E_IMMUTABLE;
+    model->indices.num = size;
+    return GE_E_NONE;
+}
+
+int _ge_null_model_set_attr(GEModel *model, GEModelAttr *attr) {
+    GE_NULL_COUNT(GE_NULL_MODEL_SET_ATTR, 0);
+    model->attr = attr;
+    return GE_E_NONE;
+}
+
+/* Do everything rendering a model does in the other backends, except
+ * drawing it. */
+static void _ge_null_model_draw(GEModel *model, GEShaderPos **pos,
+                                GEUniformType *types, void **uniforms,
+                                size_t uniform_count, size_t count) {
+    int uniform_sizes[GE_U_AMOUNT] = {
+        sizeof(GEMat4),
+        sizeof(GEMat3),
+        sizeof(GEVec4),
+        sizeof(GEVec3),
+        sizeof(GEVec2)
+    };
+    size_t i, n;
+    
+    if(model->attr == NULL) return;
+    
+    for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
+        if(model->calls[i].before_rendering){
+            model->calls[i].before_rendering((void*)model, model->attr,
+                                             model->extra[i]);
+        }
+    }
+    
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
+            continue;
+        }
+        ge_modelarray_enable(model->arrays[i], model->attr->array_pos[i]);
+    }
+    
+    for(i=0;i<count;i++){
+        for(n=0;n<uniform_count;n++){
+            ge_shader_load_any(pos[n], types[n],
+                               (char*)uniforms[n]+i*uniform_sizes[types[n]]);
+        }
+        GE_NULL_COUNT(GE_NULL_DRAW, model->indices.data ?
+                      model->indices.num*ge_type_size[model->indices.type] :
+                      0);
+    }
+    
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL || model->attr->array_pos[i] == NULL){
+            continue;
+        }
+        ge_modelarray_disable(model->arrays[i]);
+    }
+    
+    for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
+        if(model->calls[i].after_rendering){
+            model->calls[i].after_rendering((void*)model, model->attr,
+                                            model->extra[i]);
+        }
+    }
+}
+
+void _ge_null_model_render(GEModel *model) {
+    GE_NULL_COUNT(GE_NULL_MODEL_RENDER, 0);
+    _ge_null_model_draw(model, NULL, NULL, NULL, 0, 1);
+}
+
+void _ge_null_model_render_multiple(GEModel *model, GEShaderPos **pos,
+                                    GEUniformType *types, void **uniforms,
+                                    size_t uniform_count, size_t count) {
+    GE_NULL_COUNT(GE_NULL_MODEL_RENDER_MULTIPLE, 0);
+    _ge_null_model_draw(model, pos, types, uniforms, uniform_count, count);
+}
+
+int _ge_null_model_attr_init(GEModelAttr *attr, GEShader *shader,
+                             GEModelArrayAttr **array_attr, char **names,
+                             size_t num) {
+    size_t i;
+    (void)shader;
+    GE_NULL_COUNT(GE_NULL_MODEL_ATTR_INIT, 0);
+    attr->array_pos = array_attr;
+    attr->array_num = num;
+    for(i=0;i<num;i++){
+        if(!names[i] || !attr->array_pos[i]) continue;
+        attr->array_pos[i]->pos = i;
+    }
+    return GE_E_NONE;
+}
+
+void _ge_null_model_free(GEModel *model) {
+    size_t i;
+    
+    GE_NULL_COUNT(GE_NULL_MODEL_FREE, 0);
+    
+    for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
+        if(model->calls[i].before_free){
+            model->calls[i].before_free((void*)model, model->extra[i]);
+        }
+    }
+    
+    for(i=0;i<model->array_num;i++){
+        if(model->arrays[i] == NULL) continue;
+        ge_modelarray_free(model->arrays[i]);
+    }
+    
+    for(i=0;i<GE_MODEL_INHERIT_MAX;i++){
+        if(model->calls[i].after_free){
+            model->calls[i].after_free((void*)model, model->extra[i]);
+        }
+    }
+}
+
+int _ge_null_modelarray_init(GEModelArray *array, void *data, GEType type,
+                             size_t size, size_t item_size, int updatable) {
+    (void)updatable;
+    GE_NULL_COUNT(GE_NULL_MODELARRAY_INIT, size*ge_type_size[type]);
+    array->data = data;
+    array->type = type;
+    array->size = size;
+    array->item_size = item_size;
+    array->current_attr = NULL;
+    array->updatable = 1;
+    array->vbo = 0;
+    return GE_E_NONE;
+}
+
+int _ge_null_modelarray_update(GEModelArray *array, void *data, size_t size) {
+    (void)data;
+    GE_NULL_COUNT(GE_NULL_MODELARRAY_UPDATE, size*ge_type_size[array->type]);
+    if(!array->updatable) return GE_E_IMMUTABLE;
+    return GE_E_NONE;
+}
+
+int _ge_null_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr) {
+    GE_NULL_COUNT(GE_NULL_MODELARRAY_ENABLE, 0);
+    array->current_attr = attr;
+    return GE_E_NONE;
+}
+
+int _ge_null_modelarray_disable(GEModelArray *array) {
+    GE_NULL_COUNT(GE_NULL_MODELARRAY_DISABLE, 0);
+    if(array->current_attr == NULL) return 1;
+    array->current_attr = NULL;
+    return GE_E_NONE;
+}
+
+void _ge_null_modelarray_free(GEModelArray *array) {
+    GE_NULL_COUNT(GE_NULL_MODELARRAY_FREE, 0);
+    array->vbo = 0;
+}
@@ -0,0 +1,238 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <null.h>
+
+#include <mibiengine2/base/utils.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mibiengine2/errors.h>
+
+char *_ge_null_shader_init(GEShader *shader, char *vertex_source,
+                           char *fragment_source) {
+    GE_NULL_COUNT(GE_NULL_SHADER_INIT, strlen(vertex_source)+
+                                       strlen(fragment_source));
+    shader->shader_program = 0;
+    shader->vertex_shader = 0;
+    shader->fragment_shader = 0;
+    return NULL;
+}
+
+void _ge_null_shader_use(GEShader *shader) {
+    (void)shader;
+    GE_NULL_COUNT(GE_NULL_SHADER_USE, 0);
+}
+
+GEShaderPos _ge_null_shader_get_pos(GEShader *shader, char *name) {
+    GEShaderPos pos;
+    (void)shader;
+    (void)name;
+    GE_NULL_COUNT(GE_NULL_SHADER_GET_POS, 0);
+    pos.pos = 0;
+    pos.attr = -1;
+    pos.size = 1;
+    return pos;
+}
+
+void _ge_null_shader_load_mat4(GEShaderPos *pos, GEMat4 *mat) {
+    (void)pos;
+    (void)mat;
+    GE_NULL_COUNT(GE_NULL_SHADER_LOAD_MAT4, sizeof(GEMat4));
+}
+
+void _ge_null_shader_load_mat3(GEShaderPos *pos, GEMat3 *mat) {
+    (void)pos;
+    (void)mat;
+    GE_NULL_COUNT(GE_NULL_SHADER_LOAD_MAT3, sizeof(GEMat3));
+}
+
+void _ge_null_shader_load_vec4(GEShaderPos *pos, GEVec4 *vec) {
+    (void)pos;
+    (void)vec;
+    GE_NULL_COUNT(GE_NULL_SHADER_LOAD_VEC4, sizeof(float)*4);
+}
+
+void _ge_null_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec) {
+    (void)pos;
+    (void)vec;
+    GE_NULL_COUNT(GE_NULL_SHADER_LOAD_VEC3, sizeof(float)*3);
+}
+
+void _ge_null_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec) {
+    (void)pos;
+    (void)vec;
+    GE_NULL_COUNT(GE_NULL_SHADER_LOAD_VEC2, sizeof(float)*2);
+}
+
+void _ge_null_shader_free(GEShader *shader) {
+    (void)shader;
+    GE_NULL_COUNT(GE_NULL_SHADER_FREE, 0);
+}
+
+void _ge_null_texture_layout(int width, int height, int mipmap,
+                             int *data_width, int *data_height) {
+    /* Lay the textures out as the GLES backend does without extensions */
+    if(!mipmap){
+        *data_width = width;
+        *data_height = height;
+        return;
+    }
+    *data_width = ge_utils_power_of_two(width);
+    *data_height = ge_utils_power_of_two(height);
+}
+
+/* Returns the number of bytes of the levels of a texture that the GLES
+ * backend keeps on the GPU */
+static size_t _ge_null_texture_bytes(GETexture *texture) {
+    int width = texture->data_width;
+    int height = texture->data_height;
+    size_t bytes = 0;
+    int i;
+    if(texture->lod == GE_TEXTURE_EVICTED) return 0;
+    for(i=0;i<texture->levels;i++){
+        if(i >= texture->lod){
+            bytes += ge_image_level_size(texture->format, width, height);
+        }
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    return bytes;
+}
+
+/* Sets the size of a texture and returns the number of bytes the GLES
+ * backend uploads for it, which includes the mip levels of images mapped from
+ * .getex files, that stay compressed */
+static size_t _ge_null_texture_size(GETexture *texture, GEImage *image) {
+    int mapped = image->file.data != NULL && !image->flip == !texture->flip &&
+                 !(image->levels == 1 && texture->mipmap);
+    texture->width = image->width;
+    texture->height = image->height;
+    texture->format = mapped ? image->format : GE_IMAGE_FORMAT_RGBA8;
+    if(mapped){
+        texture->data_width = image->data_width;
+        texture->data_height = image->data_height;
+        texture->levels = image->levels;
+    }else{
+        _ge_null_texture_layout(image->width, image->height, texture->mipmap,
+                                &texture->data_width, &texture->data_height);
+        /* The GLES backend generates the mip levels of these textures */
+        texture->levels = texture->mipmap ?
+                          ge_mipmap_levels(texture->data_width,
+                                           texture->data_height) : 1;
+    }
+    texture->uv_max.x = image->width/(float)texture->data_width;
+    texture->uv_max.y = image->height/(float)texture->data_height;
+    if(texture->lod >= texture->levels) texture->lod = texture->levels-1;
+    return _ge_null_texture_bytes(texture);
+}
+
+int _ge_null_texture_init(GETexture *texture, GEImage *image, int linear,
+                          int flip, int mipmap) {
+    (void)linear;
+    texture->mipmap = mipmap;
+    texture->flip = flip;
+    texture->data = NULL;
+    texture->id = 0;
+    GE_NULL_COUNT(GE_NULL_TEXTURE_INIT,
+                  _ge_null_texture_size(texture, image));
+    return GE_E_NONE;
+}
+
+int _ge_null_texture_update(GETexture *texture, GEImage *image) {
+    GE_NULL_COUNT(GE_NULL_TEXTURE_UPDATE,
+                  _ge_null_texture_size(texture, image));
+    return GE_E_NONE;
+}
+
+int _ge_null_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h) {
+    (void)x;
+    (void)y;
+    (void)w;
+    if((int)image->width != texture->width ||
+       (int)image->height != texture->height){
+        return _ge_null_texture_update(texture, image);
+    }
+    /* The GLES backend uploads whole rows, or everything again if it has to
+     * generate the mip levels or compress the pixels */
+    if(texture->mipmap || texture->format != GE_IMAGE_FORMAT_RGBA8){
+        GE_NULL_COUNT(GE_NULL_TEXTURE_UPDATE_REGION,
+                      _ge_null_texture_size(texture, image));
+        return GE_E_NONE;
+    }
+    GE_NULL_COUNT(GE_NULL_TEXTURE_UPDATE_REGION,
+                  (size_t)texture->data_width*h*4);
+    return GE_E_NONE;
+}
+
+void _ge_null_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu) {
+    *gpu = _ge_null_texture_bytes(texture);
+    *cpu = 0;
+}
+
+int _ge_null_texture_residency(GETexture *texture, GEImage *image, int lod) {
+    texture->lod = lod;
+    if(lod == GE_TEXTURE_EVICTED){
+        GE_NULL_COUNT(GE_NULL_TEXTURE_RESIDENCY, 0);
+        return GE_E_NONE;
+    }
+    if(image != NULL){
+        GE_NULL_COUNT(GE_NULL_TEXTURE_RESIDENCY,
+                      _ge_null_texture_size(texture, image));
+        return GE_E_NONE;
+    }
+    if(lod >= texture->levels) texture->lod = texture->levels-1;
+    GE_NULL_COUNT(GE_NULL_TEXTURE_RESIDENCY, _ge_null_texture_bytes(texture));
+    return GE_E_NONE;
+}
+
+void _ge_null_texture_release(GETexture *texture) {
+    (void)texture;
+    GE_NULL_COUNT(GE_NULL_TEXTURE_RELEASE, 0);
+}
+
+void _ge_null_texture_use(GETexture *texture, GEShaderPos *pos, size_t n) {
+    (void)texture;
+    (void)pos;
+    (void)n;
+    GE_NULL_COUNT(GE_NULL_TEXTURE_USE, 0);
+}
+
+void _ge_null_texture_free(GETexture *texture) {
+    GE_NULL_COUNT(GE_NULL_TEXTURE_FREE, 0);
+    free(texture->data);
+    texture->data = NULL;
+}
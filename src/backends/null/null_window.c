@@ -0,0 +1,252 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <null.h>
+
+#include <mibiengine2/base/utils.h>
+#include <mibiengine2/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mibiengine2/errors.h>
+
+int _ge_null_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
+                              size_t tex_count, GEColor *formats,
+                              GETexType *type, char *linear) {
+    float vertices[4*2] = {
+        -1,  1,
+        -1, -1,
+         1, -1,
+         1,  1
+    };
+    unsigned short int indices[6] = {
+        0, 1, 3,
+        3, 1, 2
+    };
+    float uv_coords[4*2] = {
+        0, 0,
+        0, 1,
+        1, 1,
+        1, 0
+    };
+    size_t i;
+    (void)formats;
+    (void)type;
+    (void)linear;
+    if(ge_stdmodel_init(&framebuffer->model, indices, vertices, GE_T_USHORT,
+                        GE_T_FLOAT, 6, 4*2, 2, 0, NULL)){
+        return GE_E_STDMODEL_INIT;
+    }
+    if(ge_stdmodel_add_uv_coords(&framebuffer->model, uv_coords, GE_T_FLOAT,
+                                 4*2, 2)){
+        ge_model_free(&framebuffer->model);
+        return GE_E_STDMODEL_ADD;
+    }
+    if(tex_count > GE_FRAMEBUFFER_TEX_MAX) tex_count = GE_FRAMEBUFFER_TEX_MAX;
+    framebuffer->tex_num = tex_count;
+    framebuffer->width = w;
+    framebuffer->height = h;
+    framebuffer->size = ge_utils_power_of_two(w > h ? w : h);
+    framebuffer->fbo = 0;
+    for(i=0;i<tex_count;i++) framebuffer->tex[i] = 0;
+    framebuffer->tex_size.x = w/(float)framebuffer->size;
+    framebuffer->tex_size.y = h/(float)framebuffer->size;
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_INIT,
+                  framebuffer->size*framebuffer->size*4*tex_count);
+    return GE_E_NONE;
+}
+
+int _ge_null_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h) {
+    framebuffer->width = w;
+    framebuffer->height = h;
+    framebuffer->size = ge_utils_power_of_two(w > h ? w : h);
+    framebuffer->tex_size.x = w/(float)framebuffer->size;
+    framebuffer->tex_size.y = h/(float)framebuffer->size;
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_RESIZE,
+                  framebuffer->size*framebuffer->size*4*framebuffer->tex_num);
+    return GE_E_NONE;
+}
+
+int _ge_null_framebuffer_attr(GEFramebuffer *framebuffer, GEShader *shader,
+                              char **attr_names, char **tex_names,
+                              GEShaderPos *size_pos) {
+    size_t i;
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_ATTR, 0);
+    for(i=0;i<framebuffer->tex_num;i++){
+        framebuffer->tex_pos[i] = ge_shader_get_pos(shader, tex_names[i]).pos;
+    }
+    if(ge_stdmodel_shader_attr(&framebuffer->model, shader, attr_names)){
+        return GE_E_SET_ATTR;
+    }
+    framebuffer->size_pos = size_pos;
+    return GE_E_NONE;
+}
+
+void _ge_null_framebuffer_render(GEFramebuffer *framebuffer) {
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_RENDER, 0);
+    ge_shader_load_vec2(framebuffer->size_pos, &framebuffer->tex_size);
+    ge_model_render(&framebuffer->model);
+}
+
+void _ge_null_framebuffer_use(GEFramebuffer *framebuffer) {
+    (void)framebuffer;
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_USE, 0);
+}
+
+void _ge_null_framebuffer_default(void) {
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_DEFAULT, 0);
+}
+
+void _ge_null_framebuffer_free(GEFramebuffer *framebuffer) {
+    GE_NULL_COUNT(GE_NULL_FRAMEBUFFER_FREE, 0);
+    ge_model_free(&framebuffer->model);
+}
+
+int _ge_null_window_init(GEWindow *window, char *title) {
+    (void)title;
+    _ge_null_stats_reset();
+    GE_NULL_COUNT(GE_NULL_WINDOW_INIT, 0);
+    
+    window->egl.display = NULL;
+    window->egl.surface = NULL;
+    window->egl.config = NULL;
+    window->egl.context = NULL;
+    window->platform.display = NULL;
+    window->platform.window = NULL;
+    window->platform.wm_delete_window = NULL;
+    memset(window->platform.keys_down, 0, GE_K_AMOUNT);
+    window->platform.mouse_x = 0;
+    window->platform.mouse_y = 0;
+    
+    window->draw = NULL;
+    window->resize = NULL;
+    window->keyevent = NULL;
+    window->mouseevent = NULL;
+    return GE_E_NONE;
+}
+
+int _ge_null_window_set_data(GEWindow *window, void *data) {
+    GE_NULL_COUNT(GE_NULL_WINDOW_SET_DATA, 0);
+    window->data = data;
+    return GE_E_NONE;
+}
+
+int _ge_null_window_cap_framerate(GEWindow *window, int cap) {
+    (void)window;
+    (void)cap;
+    GE_NULL_COUNT(GE_NULL_WINDOW_CAP_FRAMERATE, 0);
+    return GE_E_NONE;
+}
+
+void _ge_null_window_depth_test(GEWindow *window, int depth_test) {
+    (void)window;
+    (void)depth_test;
+    GE_NULL_COUNT(GE_NULL_WINDOW_DEPTH_TEST, 0);
+}
+
+void _ge_null_window_blending(GEWindow *window, int blend) {
+    (void)window;
+    (void)blend;
+    GE_NULL_COUNT(GE_NULL_WINDOW_BLENDING, 0);
+}
+
+unsigned long _ge_null_window_ms(GEWindow *window) {
+    struct timespec time;
+    (void)window;
+    GE_NULL_COUNT(GE_NULL_WINDOW_MS, 0);
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_nsec/(unsigned long)(1e6)+time.tv_sec*1000;
+}
+
+int _ge_null_window_key_pressed(GEWindow *window, GEKey key) {
+    GE_NULL_COUNT(GE_NULL_WINDOW_KEY_PRESSED, 0);
+    if(key >= 0 && key < GE_K_AMOUNT){
+        return window->platform.keys_down[key];
+    }
+    return 0;
+}
+
+void _ge_null_window_mainloop(GEWindow *window) {
+    unsigned long int frames = GE_NULL_WINDOW_FRAMES;
+    unsigned long int i;
+    struct timespec start, end;
+    char *env;
+    
+    env = getenv("GE_NULL_FRAMES");
+    if(env && atol(env) > 0) frames = atol(env);
+    
+    if(window->resize != NULL){
+        window->resize(window->data, GE_NULL_WINDOW_WIDTH,
+                       GE_NULL_WINDOW_HEIGHT);
+    }
+    
+    /* Only count the calls made while rendering the frames */
+    _ge_null_stats_reset();
+    /* The monotonic clock doesn't jump when the system time changes */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(i=0;i<frames;i++){
+        if(window->draw != NULL) window->draw(window->data);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    _ge_null_stats_print(frames, (end.tv_sec-start.tv_sec)*1e6+
+                                 (end.tv_nsec-start.tv_nsec)/1e3);
+}
+
+void _ge_null_window_clear(GEWindow *window, float r, float g, float b,
+                           float a) {
+    (void)window;
+    (void)r;
+    (void)g;
+    (void)b;
+    (void)a;
+    GE_NULL_COUNT(GE_NULL_WINDOW_CLEAR, 0);
+}
+
+void _ge_null_window_view(GEWindow *window, int w, int h) {
+    (void)window;
+    (void)w;
+    (void)h;
+    GE_NULL_COUNT(GE_NULL_WINDOW_VIEW, 0);
+}
+
+void _ge_null_window_free(GEWindow *window) {
+    (void)window;
+    GE_NULL_COUNT(GE_NULL_WINDOW_FREE, 0);
+}
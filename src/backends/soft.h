@@ -0,0 +1,326 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef GE_SOFT_H
+#define GE_SOFT_H
+
+#include <backend.h>
+
+#include <mibiengine2/base/arena.h>
+#include <mibiengine2/config.h>
+
+/* soft.h
+ *
+ * A software backend that renders to an offscreen buffer on the CPU, so that
+ * the engine can be used without a GPU.
+ *
+ * Triangles are transformed when drawn and binned into square tiles of
+ * GE_SOFT_TILE_SIZE pixels. They are only rasterized when the bins are
+ * flushed (when the render target changes, when the target is cleared, at the
+ * end of a frame, etc.). Each tile row is rasterized on its own thread.
+ *
+ * Shaders are C callbacks (see GESoftShader). The GLSL source passed to
+ * ge_shader_init is only parsed to get the attributes and uniforms it declares.
+ * The first built-in shader that only uses declared attributes and uniforms is
+ * used, unless another one is chosen with the following directive (that is
+ * ignored by GLSL compilers):
+ *
+ * #pragma ge_soft <name>
+ *
+ * Like with OpenGL, buffers, textures, shader programs and framebuffers are
+ * referenced by unsigned int names (see _ge_soft_object_add).
+ */
+
+#define GE_SOFT_TEX_UNITS 16
+#define GE_SOFT_ATTR_MAX 16
+#define GE_SOFT_UNIFORM_MAX 32
+#define GE_SOFT_VARYING_MAX 16
+#define GE_SOFT_NAME_SZ 32
+#define GE_SOFT_LOC_MAX 16
+#define GE_SOFT_SCRATCH_SZ 32
+
+/* Vertex data is stored as floats and indices as unsigned ints */
+typedef struct {
+    void *data;
+    size_t size;
+    size_t max;
+} GESoftBuffer;
+
+typedef struct {
+    /* RGBA colors if depth is NULL */
+    unsigned char *color;
+    /* Depth values between 0 and 1 for depth textures */
+    float *depth;
+    int width, height;
+    unsigned char linear;
+    unsigned char is_depth;
+    /* Non-zero if the texture data was allocated by the backend */
+    unsigned char owned;
+} GESoftTexture;
+
+typedef struct {
+    GESoftTexture *color;
+    GESoftTexture *depth;
+    int width, height;
+} GESoftTarget;
+
+typedef struct GESoftState GESoftState;
+
+/* The C callbacks used as a shader.
+ *
+ * attr_names and uniform_names are the names of the attributes and uniforms
+ * used by the callbacks. They are looked up when the shader is loaded. The
+ * value of the n-th uniform is in state->uniform[n] (it contains zeros if the
+ * uniform wasn't declared). Samplers contain the number of the texture unit
+ * to use.
+ *
+ * prepare:  Called once per draw call, it can store values derived from the
+ *           uniforms in the scratch space of the state. Can be NULL.
+ * vertex:   Transform a vertex. attr[n] contains the n-th attribute as a vec4.
+ *           It writes the clip space position of the vertex to pos and
+ *           varying_num floats to varyings.
+ * fragment: Write the RGBA color (between 0 and 1) of a fragment to color.
+ *           Returns 0 if the fragment should be discarded.
+ */
+typedef struct {
+    char *name;
+    size_t varying_num;
+    char **attr_names;
+    size_t attr_num;
+    char **uniform_names;
+    size_t uniform_num;
+    void (*prepare)(GESoftState *state);
+    void (*vertex)(GESoftState *state, float attr[GE_SOFT_ATTR_MAX][4],
+                   float *pos, float *varyings);
+    int (*fragment)(GESoftState *state, float *varyings, float *color);
+} GESoftShader;
+
+typedef struct {
+    char name[GE_SOFT_NAME_SZ];
+    size_t offset;
+    size_t size;
+} GESoftUniform;
+
+typedef struct {
+    GESoftShader *shader;
+    char attrs[GE_SOFT_ATTR_MAX][GE_SOFT_NAME_SZ];
+    size_t attr_num;
+    GESoftUniform uniforms[GE_SOFT_UNIFORM_MAX];
+    size_t uniform_num;
+    /* The number of floats needed to store all the uniforms */
+    size_t uniform_size;
+    float *values;
+    int attr_loc[GE_SOFT_LOC_MAX];
+    int uniform_loc[GE_SOFT_LOC_MAX];
+} GESoftProgram;
+
+/* Everything a draw call needs to be rasterized later. */
+struct GESoftState {
+    GESoftShader *shader;
+    float *uniform[GE_SOFT_LOC_MAX];
+    GESoftTexture *units[GE_SOFT_TEX_UNITS];
+    float scratch[GE_SOFT_SCRATCH_SZ];
+    unsigned char depth_test;
+    unsigned char blend;
+};
+
+typedef struct {
+    GESoftBuffer *buffer;
+    size_t item_size;
+    /* In floats */
+    size_t stride;
+    size_t offset;
+    unsigned char enabled;
+} GESoftAttrib;
+
+typedef struct {
+    /* Edge functions (a*x+b*y+c) of the edges in front of each vertex */
+    float edge[3][3];
+    unsigned char top_left[3];
+    float inv_area;
+    float z[3];
+    float inv_w[3];
+    /* Varyings divided by w */
+    float varyings[3][GE_SOFT_VARYING_MAX];
+    int min_x, min_y, max_x, max_y;
+    GESoftState *state;
+} GESoftTriangle;
+
+typedef struct {
+    unsigned int *tris;
+    size_t num;
+    size_t max;
+} GESoftBin;
+
+typedef struct {
+    /* Objects referenced by their name */
+    void **objects;
+    size_t object_num;
+
+    GESoftAttrib attribs[GE_SOFT_ATTR_MAX];
+    GESoftProgram *program;
+    GESoftTexture *units[GE_SOFT_TEX_UNITS];
+    unsigned char depth_test;
+    unsigned char blend;
+    int view_x, view_y, view_w, view_h;
+
+    GESoftTarget *target;
+    GESoftTarget window;
+
+    /* Transformed vertices of the current draw call */
+    float *vertices;
+    size_t vertex_max;
+
+    /* Binned triangles */
+    GESoftTriangle *tris;
+    size_t tri_num;
+    GESoftBin *bins;
+    size_t bin_num;
+    size_t tiles_x, tiles_y;
+    GEArena states;
+    size_t state_num;
+
+    /* Statistics */
+    unsigned long int triangles;
+    unsigned long int frames;
+    size_t thread_num;
+} GESoftContext;
+
+extern GESoftContext _ge_soft;
+
+/* Objects */
+unsigned int _ge_soft_object_add(void *object);
+void *_ge_soft_object_get(unsigned int name);
+void _ge_soft_object_remove(unsigned int name);
+
+/* Buffers */
+int _ge_soft_buffer_set(GESoftBuffer *buffer, void *data, GEType type,
+                        size_t size, int indices);
+unsigned int _ge_soft_buffer_new(void *data, GEType type, size_t size,
+                                 int indices);
+void _ge_soft_buffer_delete(unsigned int name);
+
+/* Rasterizer */
+int _ge_soft_raster_init(void);
+void _ge_soft_draw(GESoftBuffer *indices, size_t num);
+void _ge_soft_flush(void);
+void _ge_soft_use_target(GESoftTarget *target);
+void _ge_soft_raster_free(void);
+
+/* Shaders */
+void _ge_soft_sample(GESoftTexture *texture, float u, float v, float *color);
+GESoftShader *_ge_soft_shader_find(char *name);
+int _ge_soft_program_attr(GESoftProgram *program, char *name);
+int _ge_soft_program_uniform(GESoftProgram *program, char *name);
+GESoftState *_ge_soft_state_new(GESoftProgram *program);
+void _ge_soft_shader_load(GEShaderPos *pos, float *values, size_t num);
+
+/* Textures */
+GESoftTexture *_ge_soft_texture_new(int w, int h, int depth, int linear);
+int _ge_soft_texture_resize(GESoftTexture *texture, int w, int h);
+void _ge_soft_texture_delete(GESoftTexture *texture);
+
+int _ge_soft_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
+                              size_t tex_count, GEColor *formats,
+                              GETexType *type, char *linear);
+int _ge_soft_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h);
+int _ge_soft_framebuffer_attr(GEFramebuffer *framebuffer, GEShader *shader,
+                              char **attr_names, char **tex_names,
+                              GEShaderPos *size_pos);
+void _ge_soft_framebuffer_render(GEFramebuffer *framebuffer);
+void _ge_soft_framebuffer_use(GEFramebuffer *framebuffer);
+void _ge_soft_framebuffer_default(void);
+void _ge_soft_framebuffer_free(GEFramebuffer *framebuffer);
+
+int _ge_soft_model_init(GEModel *model, GEModelArray **arrays,
+                        size_t array_num, void *indices, GEType index_type,
+                        size_t index_num, int updatable, void *extra);
+int _ge_soft_model_update_indices(GEModel *model, void *data, size_t size);
+int _ge_soft_model_set_attr(GEModel *model, GEModelAttr *attr);
+void _ge_soft_model_render(GEModel *model);
+void _ge_soft_model_render_multiple(GEModel *model, GEShaderPos **pos,
+                                    GEUniformType *types, void **uniforms,
+                                    size_t uniform_count, size_t count);
+int _ge_soft_model_attr_init(GEModelAttr *attr, GEShader *shader,
+                             GEModelArrayAttr **array_attr, char **names,
+                             size_t num);
+void _ge_soft_model_free(GEModel *model);
+
+int _ge_soft_modelarray_init(GEModelArray *array, void *data, GEType type,
+                             size_t size, size_t item_size, int updatable);
+int _ge_soft_modelarray_update(GEModelArray *array, void *data, size_t size);
+int _ge_soft_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr);
+int _ge_soft_modelarray_disable(GEModelArray *array);
+void _ge_soft_modelarray_free(GEModelArray *array);
+
+char *_ge_soft_shader_init(GEShader *shader, char *vertex_source,
+                           char *fragment_source);
+void _ge_soft_shader_use(GEShader *shader);
+GEShaderPos _ge_soft_shader_get_pos(GEShader *shader, char *name);
+void _ge_soft_shader_load_mat4(GEShaderPos *pos, GEMat4 *mat);
+void _ge_soft_shader_load_mat3(GEShaderPos *pos, GEMat3 *mat);
+void _ge_soft_shader_load_vec4(GEShaderPos *pos, GEVec4 *vec);
+void _ge_soft_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec);
+void _ge_soft_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec);
+void _ge_soft_shader_free(GEShader *shader);
+
+void _ge_soft_texture_layout(int width, int height, int mipmap,
+                            int *data_width, int *data_height);
+int _ge_soft_texture_init(GETexture *texture, GEImage *image, int linear,
+                          int flip, int mipmap);
+int _ge_soft_texture_update(GETexture *texture, GEImage *image);
+int _ge_soft_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h);
+void _ge_soft_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu);
+int _ge_soft_texture_residency(GETexture *texture, GEImage *image, int lod);
+void _ge_soft_texture_release(GETexture *texture);
+void _ge_soft_texture_use(GETexture *texture, GEShaderPos *pos, size_t n);
+void _ge_soft_texture_free(GETexture *texture);
+
+int _ge_soft_window_init(GEWindow *window, char *title);
+int _ge_soft_window_set_data(GEWindow *window, void *data);
+int _ge_soft_window_cap_framerate(GEWindow *window, int cap);
+void _ge_soft_window_depth_test(GEWindow *window, int depth_test);
+void _ge_soft_window_blending(GEWindow *window, int blend);
+unsigned long _ge_soft_window_ms(GEWindow *window);
+int _ge_soft_window_key_pressed(GEWindow *window, GEKey key);
+void _ge_soft_window_mainloop(GEWindow *window);
+void _ge_soft_window_clear(GEWindow *window, float r, float g, float b,
+                           float a);
+void _ge_soft_window_view(GEWindow *window, int w, int h);
+void _ge_soft_window_free(GEWindow *window);
+
+extern GEBackend _ge_soft_backend;
+
+#endif
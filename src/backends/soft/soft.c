@@ -0,0 +1,131 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <soft.h>
+
+#include <stdlib.h>
+
+#define _GE_SOFT_OBJECT_STEP 64
+
+GESoftContext _ge_soft;
+
+GEBackend _ge_soft_backend = {
+    _ge_soft_framebuffer_init,
+    _ge_soft_framebuffer_resize,
+    _ge_soft_framebuffer_attr,
+    _ge_soft_framebuffer_render,
+    _ge_soft_framebuffer_use,
+    _ge_soft_framebuffer_default,
+    _ge_soft_framebuffer_free,
+    
+    _ge_soft_model_init,
+    _ge_soft_model_update_indices,
+    _ge_soft_model_set_attr,
+    _ge_soft_model_render,
+    _ge_soft_model_render_multiple,
+    _ge_soft_model_attr_init,
+    _ge_soft_model_free,
+    
+    _ge_soft_modelarray_init,
+    _ge_soft_modelarray_update,
+    _ge_soft_modelarray_enable,
+    _ge_soft_modelarray_disable,
+    _ge_soft_modelarray_free,
+    
+    _ge_soft_shader_init,
+    _ge_soft_shader_use,
+    _ge_soft_shader_get_pos,
+    _ge_soft_shader_load_mat4,
+    _ge_soft_shader_load_mat3,
+    _ge_soft_shader_load_vec4,
+    _ge_soft_shader_load_vec3,
+    _ge_soft_shader_load_vec2,
+    _ge_soft_shader_free,
+    
+    _ge_soft_texture_layout,
+    _ge_soft_texture_init,
+    _ge_soft_texture_update,
+    _ge_soft_texture_update_region,
+    _ge_soft_texture_memory,
+    _ge_soft_texture_residency,
+    _ge_soft_texture_release,
+    _ge_soft_texture_use,
+    _ge_soft_texture_free,
+    
+    _ge_soft_window_init,
+    _ge_soft_window_set_data,
+    _ge_soft_window_cap_framerate,
+    _ge_soft_window_depth_test,
+    _ge_soft_window_blending,
+    _ge_soft_window_ms,
+    _ge_soft_window_key_pressed,
+    _ge_soft_window_mainloop,
+    _ge_soft_window_clear,
+    _ge_soft_window_view,
+    _ge_soft_window_free
+};
+
+unsigned int _ge_soft_object_add(void *object) {
+    size_t i;
+    void **new;
+    /* The name 0 is never used, like with OpenGL */
+    for(i=1;i<_ge_soft.object_num;i++){
+        if(_ge_soft.objects[i] == NULL){
+            _ge_soft.objects[i] = object;
+            return i;
+        }
+    }
+    new = realloc(_ge_soft.objects, (_ge_soft.object_num+_GE_SOFT_OBJECT_STEP)*
+                  sizeof(void*));
+    if(new == NULL) return 0;
+    _ge_soft.objects = new;
+    for(i=_ge_soft.object_num;i<_ge_soft.object_num+_GE_SOFT_OBJECT_STEP;
+        i++){
+        _ge_soft.objects[i] = NULL;
+    }
+    i = _ge_soft.object_num ? _ge_soft.object_num : 1;
+    _ge_soft.object_num += _GE_SOFT_OBJECT_STEP;
+    _ge_soft.objects[i] = object;
+    return i;
+}
+
+void *_ge_soft_object_get(unsigned int name) {
+    if(name >= _ge_soft.object_num) return NULL;
+    return _ge_soft.objects[name];
+}
+
+void _ge_soft_object_remove(unsigned int name) {
+    if(name >= _ge_soft.object_num) return;
+    _ge_soft.objects[name] = NULL;
+}
@@ -0,0 +1,240 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <soft.h>
+
+#include <mibiengine2/base/framebuffer.h>
+
+#include <mibiengine2/base/utils.h>
+#include <mibiengine2/errors.h>
+
+#include <stdlib.h>
+
+int _ge_soft_framebuffer_init(GEFramebuffer *framebuffer, int w, int h,
+                              size_t tex_count, GEColor *formats,
+                              GETexType *type, char *linear) {
+    /* Model data */
+    float vertices[4*2] = {
+        -1,  1,
+        -1, -1,
+         1, -1,
+         1,  1
+    };
+    unsigned short int indices[6] = {
+        0, 1, 3,
+        3, 1, 2
+    };
+    float uv_coords[4*2] = {
+        0, 0,
+        0, 1,
+        1, 1,
+        1, 0
+    };
+    size_t i;
+    size_t color_attachments = 0;
+    size_t depth_attachments = 0;
+    size_t stencil_attachments = 0;
+    size_t tex_pos = 0;
+    GESoftTarget *target;
+    GESoftTexture *texture;
+    (void)formats;
+    /* Initialize the model used to render the framebuffer */
+    if(ge_stdmodel_init(&framebuffer->model, indices, vertices, GE_T_USHORT,
+                        GE_T_FLOAT, 6, 4*2, 2, 0, NULL)){
+        return GE_E_STDMODEL_INIT;
+    }
+    if(ge_stdmodel_add_uv_coords(&framebuffer->model, uv_coords, GE_T_FLOAT,
+                                 4*2, 2)){
+        ge_model_free(&framebuffer->model);
+        return GE_E_STDMODEL_ADD;
+    }
+    
+    target = malloc(sizeof(GESoftTarget));
+    if(target == NULL){
+        ge_model_free(&framebuffer->model);
+        return GE_E_OUT_OF_MEM;
+    }
+    target->color = NULL;
+    target->depth = NULL;
+    
+    framebuffer->tex_num = tex_count;
+    framebuffer->width = w;
+    framebuffer->height = h;
+    framebuffer->size = ge_utils_power_of_two(w > h ? w : h);
+    target->width = framebuffer->size;
+    target->height = framebuffer->size;
+    
+    /* All the color textures are stored as RGBA */
+    for(i=0;i<tex_count;i++){
+        texture = NULL;
+        switch(type[i]){
+            case GE_TEX_COLOR:
+                if(color_attachments >= GE_FRAMEBUFFER_COLOR_TEX_MAX) break;
+                texture = _ge_soft_texture_new(framebuffer->size,
+                                               framebuffer->size, 0,
+                                               linear[i]);
+                target->color = texture;
+                color_attachments++;
+                break;
+            case GE_TEX_DEPTH:
+                if(depth_attachments >= GE_FRAMEBUFFER_DEPTH_TEX_MAX) break;
+                texture = _ge_soft_texture_new(framebuffer->size,
+                                               framebuffer->size, 1,
+                                               linear[i]);
+                target->depth = texture;
+                depth_attachments++;
+                break;
+            case GE_TEX_STENCIL:
+                if(stencil_attachments >= GE_FRAMEBUFFER_STENCIL_TEX_MAX){
+                    break;
+                }
+                /* TODO: Implement this */
+                framebuffer->tex[tex_pos++] = 0;
+                stencil_attachments++;
+                continue;
+            default:
+                continue;
+        }
+        if(texture == NULL) continue;
+        framebuffer->tex[tex_pos] = _ge_soft_object_add(texture);
+        if(!framebuffer->tex[tex_pos]){
+            _ge_soft_texture_delete(texture);
+            break;
+        }
+        tex_pos++;
+    }
+    framebuffer->tex_num = tex_pos;
+    
+    framebuffer->fbo = _ge_soft_object_add(target);
+    if(i < tex_count || !framebuffer->fbo){
+        for(i=0;i<tex_pos;i++){
+            _ge_soft_texture_delete(_ge_soft_object_get(framebuffer->tex[i]));
+            _ge_soft_object_remove(framebuffer->tex[i]);
+        }
+        _ge_soft_object_remove(framebuffer->fbo);
+        free(target);
+        ge_model_free(&framebuffer->model);
+        return GE_E_FRAMEBUFFER_INCOMPLETE;
+    }
+    framebuffer->tex_size.x = w/(float)framebuffer->size;
+    framebuffer->tex_size.y = h/(float)framebuffer->size;
+    return GE_E_NONE;
+}
+
+int _ge_soft_framebuffer_resize(GEFramebuffer *framebuffer, int w, int h) {
+    GESoftTarget *target = _ge_soft_object_get(framebuffer->fbo);
+    GESoftTexture *texture;
+    size_t i;
+    if(target == NULL) return GE_E_UNKNOWN;
+    _ge_soft_flush();
+    framebuffer->width = w;
+    framebuffer->height = h;
+    framebuffer->size = ge_utils_power_of_two(w > h ? w : h);
+    
+    for(i=0;i<framebuffer->tex_num;i++){
+        texture = _ge_soft_object_get(framebuffer->tex[i]);
+        if(texture == NULL) continue;
+        if(_ge_soft_texture_resize(texture, framebuffer->size,
+                                   framebuffer->size)){
+            return GE_E_OUT_OF_MEM;
+        }
+    }
+    target->width = framebuffer->size;
+    target->height = framebuffer->size;
+    /* Update the tiles if the framebuffer is in use */
+    if(_ge_soft.target == target) _ge_soft_use_target(target);
+    
+    framebuffer->tex_size.x = w/(float)framebuffer->size;
+    framebuffer->tex_size.y = h/(float)framebuffer->size;
+    return GE_E_NONE;
+}
+
+int _ge_soft_framebuffer_attr(GEFramebuffer *framebuffer, GEShader *shader,
+                              char **attr_names, char **tex_names,
+                              GEShaderPos *size_pos) {
+    size_t i;
+    for(i=0;i<framebuffer->tex_num;i++){
+        framebuffer->tex_pos[i] = ge_shader_get_pos(shader, tex_names[i]).pos;
+    }
+    if(ge_stdmodel_shader_attr(&framebuffer->model, shader, attr_names)){
+        return GE_E_SET_ATTR;
+    }
+    framebuffer->size_pos = size_pos;
+    return GE_E_NONE;
+}
+
+void _ge_soft_framebuffer_render(GEFramebuffer *framebuffer) {
+    GEShaderPos pos;
+    size_t i;
+    float unit;
+    pos.attr = -1;
+    pos.size = 1;
+    ge_shader_load_vec2(framebuffer->size_pos, &framebuffer->tex_size);
+    for(i=0;i<framebuffer->tex_num;i++){
+        _ge_soft.units[i] = _ge_soft_object_get(framebuffer->tex[i]);
+        pos.pos = framebuffer->tex_pos[i];
+        unit = i;
+        _ge_soft_shader_load(&pos, &unit, 1);
+    }
+    _ge_soft.depth_test = 0;
+    ge_model_render(&framebuffer->model);
+    _ge_soft.depth_test = 1;
+    for(i=0;i<framebuffer->tex_num;i++){
+        _ge_soft.units[i] = NULL;
+    }
+}
+
+void _ge_soft_framebuffer_use(GEFramebuffer *framebuffer) {
+    GESoftTarget *target = _ge_soft_object_get(framebuffer->fbo);
+    if(target == NULL) return;
+    _ge_soft_use_target(target);
+}
+
+void _ge_soft_framebuffer_default(void) {
+    _ge_soft_use_target(&_ge_soft.window);
+}
+
+void _ge_soft_framebuffer_free(GEFramebuffer *framebuffer) {
+    GESoftTarget *target = _ge_soft_object_get(framebuffer->fbo);
+    size_t i;
+    _ge_soft_flush();
+    if(_ge_soft.target == target) _ge_soft_use_target(&_ge_soft.window);
+    for(i=0;i<framebuffer->tex_num;i++){
+        _ge_soft_texture_delete(_ge_soft_object_get(framebuffer->tex[i]));
+        _ge_soft_object_remove(framebuffer->tex[i]);
+    }
+    free(target);
+    _ge_soft_object_remove(framebuffer->fbo);
+    ge_model_free(&framebuffer->model);
+}
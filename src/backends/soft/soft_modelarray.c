@@ -0,0 +1,200 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <soft.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mibiengine2/errors.h>
+
+#define _GE_SOFT_CONVERT(dest_type, src_type) \
+    for(i=0;i<size;i++){ \
+        ((dest_type*)buffer->data)[i] = \
+                                    (dest_type)((src_type*)data)[i]; \
+    }
+
+#define _GE_SOFT_CONVERT_ALL(dest_type) \
+    switch(type){ \
+        case GE_T_CHAR: \
+            _GE_SOFT_CONVERT(dest_type, signed char); \
+            break; \
+        case GE_T_UCHAR: \
+            _GE_SOFT_CONVERT(dest_type, unsigned char); \
+            break; \
+        case GE_T_SHORT: \
+            _GE_SOFT_CONVERT(dest_type, short int); \
+            break; \
+        case GE_T_USHORT: \
+            _GE_SOFT_CONVERT(dest_type, unsigned short int); \
+            break; \
+        case GE_T_INT: \
+            _GE_SOFT_CONVERT(dest_type, int); \
+            break; \
+        case GE_T_UINT: \
+            _GE_SOFT_CONVERT(dest_type, unsigned int); \
+            break; \
+        case GE_T_LONG: \
+            _GE_SOFT_CONVERT(dest_type, long int); \
+            break; \
+        case GE_T_ULONG: \
+            _GE_SOFT_CONVERT(dest_type, unsigned long int); \
+            break; \
+        case GE_T_FLOAT: \
+            _GE_SOFT_CONVERT(dest_type, float); \
+            break; \
+        case GE_T_DOUBLE: \
+            _GE_SOFT_CONVERT(dest_type, double); \
+            break; \
+        default: \
+            memset(buffer->data, 0, size*sizeof(dest_type)); \
+    }
+
+int _ge_soft_buffer_set(GESoftBuffer *buffer, void *data, GEType type,
+                        size_t size, int indices) {
+    size_t i;
+    size_t item_size = indices ? sizeof(unsigned int) : sizeof(float);
+    void *new;
+    if(size > buffer->max || buffer->data == NULL){
+        new = realloc(buffer->data, (size ? size : 1)*item_size);
+        if(new == NULL) return GE_E_OUT_OF_MEM;
+        buffer->data = new;
+        buffer->max = size;
+    }
+    buffer->size = size;
+    if(data == NULL){
+        memset(buffer->data, 0, size*item_size);
+        return GE_E_NONE;
+    }
+    /* Vertex data is stored as floats and indices as unsigned ints to avoid
+     * converting them when rendering */
+    if(indices){
+        _GE_SOFT_CONVERT_ALL(unsigned int);
+    }else{
+        _GE_SOFT_CONVERT_ALL(float);
+    }
+    return GE_E_NONE;
+}
+
+unsigned int _ge_soft_buffer_new(void *data, GEType type, size_t size,
+                                 int indices) {
+    GESoftBuffer *buffer;
+    unsigned int name;
+    buffer = malloc(sizeof(GESoftBuffer));
+    if(buffer == NULL) return 0;
+    buffer->data = NULL;
+    buffer->max = 0;
+    if(_ge_soft_buffer_set(buffer, data, type, size, indices)){
+        free(buffer);
+        return 0;
+    }
+    name = _ge_soft_object_add(buffer);
+    if(!name){
+        free(buffer->data);
+        free(buffer);
+    }
+    return name;
+}
+
+void _ge_soft_buffer_delete(unsigned int name) {
+    GESoftBuffer *buffer = _ge_soft_object_get(name);
+    size_t i;
+    if(buffer == NULL) return;
+    /* Like OpenGL, deleting a buffer unbinds it */
+    for(i=0;i<GE_SOFT_ATTR_MAX;i++){
+        if(_ge_soft.attribs[i].buffer == buffer){
+            _ge_soft.attribs[i].buffer = NULL;
+            _ge_soft.attribs[i].enabled = 0;
+        }
+    }
+    free(buffer->data);
+    free(buffer);
+    _ge_soft_object_remove(name);
+}
+
+int _ge_soft_modelarray_init(GEModelArray *array, void *data, GEType type,
+                             size_t size, size_t item_size, int updatable) {
+    (void)updatable;
+    array->data = data;
+    array->type = type;
+    array->size = size;
+    array->item_size = item_size;
+    array->current_attr = NULL;
+    array->updatable = 1;
+    
+    array->vbo = _ge_soft_buffer_new(data, type, size, 0);
+    if(!array->vbo) return GE_E_OUT_OF_MEM;
+    return GE_E_NONE;
+}
+
+int _ge_soft_modelarray_update(GEModelArray *array, void *data, size_t size) {
+    GESoftBuffer *buffer;
+    if(!array->updatable) return GE_E_IMMUTABLE;
+    buffer = _ge_soft_object_get(array->vbo);
+    if(buffer == NULL) return GE_E_UNKNOWN;
+    return _ge_soft_buffer_set(buffer, data, array->type, size, 0);
+}
+
+int _ge_soft_modelarray_enable(GEModelArray *array, GEModelArrayAttr *attr) {
+    GESoftAttrib *attrib;
+    GEModelArrayAttr *cur;
+    for(cur=attr;cur!=NULL;cur=cur->next){
+        if(cur->pos < 0 || cur->pos >= GE_SOFT_ATTR_MAX) continue;
+        attrib = _ge_soft.attribs+cur->pos;
+        attrib->buffer = _ge_soft_object_get(array->vbo);
+        attrib->item_size = GE_MODELARRAY_ATTR_ITEM_SIZE(array, cur);
+        attrib->stride = GE_MODELARRAY_ATTR_STRIDE(array, cur);
+        attrib->offset = cur->offset;
+        attrib->enabled = 1;
+    }
+    array->current_attr = attr;
+    return GE_E_NONE;
+}
+
+int _ge_soft_modelarray_disable(GEModelArray *array) {
+    GEModelArrayAttr *cur;
+    if(array->current_attr == NULL) return 1;
+    for(cur=array->current_attr;cur!=NULL;cur=cur->next){
+        if(cur->pos >= 0 && cur->pos < GE_SOFT_ATTR_MAX){
+            _ge_soft.attribs[cur->pos].enabled = 0;
+        }
+    }
+    array->current_attr = NULL;
+    return GE_E_NONE;
+}
+
+void _ge_soft_modelarray_free(GEModelArray *array) {
+    _ge_soft_buffer_delete(array->vbo);
+    array->vbo = 0;
+}
@@ -0,0 +1,654 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <soft.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <mibiengine2/errors.h>
+
+#if GE_SOFT_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define _GE_SOFT_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _GE_SOFT_NEON 1
+#endif
+
+/* The number of floats stored for each transformed vertex */
+#define _GE_SOFT_STRIDE(shader) (4+(shader)->varying_num)
+
+#define _GE_SOFT_CLIP_MAX 4
+
+#define _GE_SOFT_ARENA_MIN 4096
+
+#if GE_SOFT_THREADS
+static pthread_t _ge_soft_threads[GE_SOFT_THREAD_MAX];
+static pthread_mutex_t _ge_soft_mutex;
+static pthread_cond_t _ge_soft_start;
+static pthread_cond_t _ge_soft_done;
+static size_t _ge_soft_generation;
+static size_t _ge_soft_row;
+static size_t _ge_soft_working;
+static int _ge_soft_quit;
+#endif
+
+/* Get the coverage mask of 4 pixels of a row, starting at x. e is set to the
+ * value of the edge functions of each pixel. */
+static int _ge_soft_coverage(GESoftTriangle *tri, int x, int y,
+                             float e[3][4]) {
+#if _GE_SOFT_SSE2
+    __m128 px = _mm_add_ps(_mm_set1_ps(x+0.5f), _mm_set_ps(3, 2, 1, 0));
+    __m128 zero = _mm_setzero_ps();
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    __m128 edge;
+    __m128 top_left;
+    size_t i;
+    for(i=0;i<3;i++){
+        edge = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(tri->edge[i][0]), px),
+                          _mm_set1_ps(tri->edge[i][1]*(y+0.5f)+
+                                      tri->edge[i][2]));
+        top_left = _mm_castsi128_ps(_mm_set1_epi32(tri->top_left[i] ? -1 :
+                                                   0));
+        /* Pixels on the edge are only drawn if it is a top or a left edge */
+        inside = _mm_and_ps(inside,
+                            _mm_or_ps(_mm_cmpgt_ps(edge, zero),
+                                      _mm_and_ps(_mm_cmpeq_ps(edge, zero),
+                                                 top_left)));
+        _mm_storeu_ps(e[i], edge);
+    }
+    return _mm_movemask_ps(inside);
+#elif _GE_SOFT_NEON
+    static const float offsets[4] = {0, 1, 2, 3};
+    static const unsigned int bits[4] = {1, 2, 4, 8};
+    float32x4_t px = vaddq_f32(vdupq_n_f32(x+0.5f), vld1q_f32(offsets));
+    float32x4_t zero = vdupq_n_f32(0);
+    uint32x4_t inside = vdupq_n_u32(0xFFFFFFFF);
+    uint32x4_t top_left;
+    uint32x4_t masked;
+    float32x4_t edge;
+    size_t i;
+    for(i=0;i<3;i++){
+        edge = vmlaq_f32(vdupq_n_f32(tri->edge[i][1]*(y+0.5f)+
+                                     tri->edge[i][2]),
+                         vdupq_n_f32(tri->edge[i][0]), px);
+        top_left = vdupq_n_u32(tri->top_left[i] ? 0xFFFFFFFF : 0);
+        inside = vandq_u32(inside,
+                           vorrq_u32(vcgtq_f32(edge, zero),
+                                     vandq_u32(vceqq_f32(edge, zero),
+                                               top_left)));
+        vst1q_f32(e[i], edge);
+    }
+    masked = vandq_u32(inside, vld1q_u32(bits));
+    return vgetq_lane_u32(masked, 0)|vgetq_lane_u32(masked, 1)|
+           vgetq_lane_u32(masked, 2)|vgetq_lane_u32(masked, 3);
+#else
+    int mask = 0;
+    size_t i, n;
+    float row;
+    for(i=0;i<3;i++){
+        row = tri->edge[i][1]*(y+0.5f)+tri->edge[i][2];
+        for(n=0;n<4;n++){
+            e[i][n] = tri->edge[i][0]*(x+n+0.5f)+row;
+        }
+    }
+    for(n=0;n<4;n++){
+        if((e[0][n] > 0 || (e[0][n] == 0 && tri->top_left[0])) &&
+           (e[1][n] > 0 || (e[1][n] == 0 && tri->top_left[1])) &&
+           (e[2][n] > 0 || (e[2][n] == 0 && tri->top_left[2]))){
+            mask |= 1<<n;
+        }
+    }
+    return mask;
+#endif
+}
+
+static void _ge_soft_fragment(GESoftTriangle *tri, int x, int y, float e0,
+                              float e1, float e2) {
+    GESoftTarget *target = _ge_soft.target;
+    GESoftState *state = tri->state;
+    float varyings[GE_SOFT_VARYING_MAX];
+    float color[4];
+    float l0, l1, l2;
+    float z, w;
+    size_t p = (size_t)y*target->width+x;
+    size_t i;
+    unsigned char *dest;
+    l0 = e0*tri->inv_area;
+    l1 = e1*tri->inv_area;
+    l2 = e2*tri->inv_area;
+    z = l0*tri->z[0]+l1*tri->z[1]+l2*tri->z[2];
+    if(z < 0) z = 0;
+    if(z > 1) z = 1;
+    if(state->depth_test && target->depth && z > target->depth->depth[p]){
+        return;
+    }
+    /* Perspective correct interpolation */
+    w = 1/(l0*tri->inv_w[0]+l1*tri->inv_w[1]+l2*tri->inv_w[2]);
+    l0 *= w;
+    l1 *= w;
+    l2 *= w;
+    for(i=0;i<state->shader->varying_num;i++){
+        varyings[i] = l0*tri->varyings[0][i]+l1*tri->varyings[1][i]+
+                      l2*tri->varyings[2][i];
+    }
+    if(!state->shader->fragment(state, varyings, color)) return;
+    if(target->color){
+        dest = target->color->color+p*4;
+        for(i=0;i<4;i++){
+            if(color[i] < 0) color[i] = 0;
+            if(color[i] > 1) color[i] = 1;
+        }
+        if(state->blend){
+            for(i=0;i<4;i++){
+                color[i] = color[i]*color[3]+
+                           dest[i]*(1/255.0f)*(1-color[3]);
+            }
+        }
+        for(i=0;i<4;i++) dest[i] = (unsigned char)(color[i]*255+0.5f);
+    }
+    if(state->depth_test && target->depth) target->depth->depth[p] = z;
+}
+
+static void _ge_soft_raster_tile(size_t tx, size_t ty) {
+    GESoftBin *bin = _ge_soft.bins+ty*_ge_soft.tiles_x+tx;
+    GESoftTriangle *tri;
+    float e[3][4];
+    int min_x, min_y, max_x, max_y;
+    int x, y;
+    int mask;
+    size_t i, n;
+    for(i=0;i<bin->num;i++){
+        tri = _ge_soft.tris+bin->tris[i];
+        min_x = tx*GE_SOFT_TILE_SIZE;
+        min_y = ty*GE_SOFT_TILE_SIZE;
+        max_x = min_x+GE_SOFT_TILE_SIZE-1;
+        max_y = min_y+GE_SOFT_TILE_SIZE-1;
+        if(tri->min_x > min_x) min_x = tri->min_x;
+        if(tri->min_y > min_y) min_y = tri->min_y;
+        if(tri->max_x < max_x) max_x = tri->max_x;
+        if(tri->max_y < max_y) max_y = tri->max_y;
+        for(y=min_y;y<=max_y;y++){
+            for(x=min_x;x<=max_x;x+=4){
+                mask = _ge_soft_coverage(tri, x, y, e);
+                if(max_x-x < 3) mask &= (1<<(max_x-x+1))-1;
+                for(n=0;mask;n++,mask>>=1){
+                    if(!(mask&1)) continue;
+                    _ge_soft_fragment(tri, x+n, y, e[0][n], e[1][n],
+                                      e[2][n]);
+                }
+            }
+        }
+    }
+}
+
+static void _ge_soft_raster_row(size_t ty) {
+    size_t tx;
+    for(tx=0;tx<_ge_soft.tiles_x;tx++){
+        _ge_soft_raster_tile(tx, ty);
+    }
+}
+
+#if GE_SOFT_THREADS
+static void *_ge_soft_worker(void *arg) {
+    size_t generation = 0;
+    size_t row;
+    (void)arg;
+    pthread_mutex_lock(&_ge_soft_mutex);
+    while(1){
+        while(generation == _ge_soft_generation && !_ge_soft_quit){
+            pthread_cond_wait(&_ge_soft_start, &_ge_soft_mutex);
+        }
+        if(_ge_soft_quit) break;
+        generation = _ge_soft_generation;
+        /* Take tile rows until they have all been rasterized */
+        while(_ge_soft_row < _ge_soft.tiles_y){
+            row = _ge_soft_row++;
+            pthread_mutex_unlock(&_ge_soft_mutex);
+            _ge_soft_raster_row(row);
+            pthread_mutex_lock(&_ge_soft_mutex);
+        }
+        _ge_soft_working--;
+        if(!_ge_soft_working) pthread_cond_signal(&_ge_soft_done);
+    }
+    pthread_mutex_unlock(&_ge_soft_mutex);
+    return NULL;
+}
+#endif
+
+/* Rasterize all the binned triangles */
+static void _ge_soft_raster_bins(void) {
+    size_t i;
+    if(!_ge_soft.tri_num) return;
+#if GE_SOFT_THREADS
+    if(_ge_soft.thread_num > 1){
+        pthread_mutex_lock(&_ge_soft_mutex);
+        _ge_soft_row = 0;
+        _ge_soft_working = _ge_soft.thread_num-1;
+        _ge_soft_generation++;
+        pthread_cond_broadcast(&_ge_soft_start);
+        /* The current thread rasterizes tile rows too */
+        while(_ge_soft_row < _ge_soft.tiles_y){
+            i = _ge_soft_row++;
+            pthread_mutex_unlock(&_ge_soft_mutex);
+            _ge_soft_raster_row(i);
+            pthread_mutex_lock(&_ge_soft_mutex);
+        }
+        while(_ge_soft_working){
+            pthread_cond_wait(&_ge_soft_done, &_ge_soft_mutex);
+        }
+        pthread_mutex_unlock(&_ge_soft_mutex);
+    }else
+#endif
+    {
+        for(i=0;i<_ge_soft.tiles_y;i++) _ge_soft_raster_row(i);
+    }
+    for(i=0;i<_ge_soft.bin_num;i++) _ge_soft.bins[i].num = 0;
+    _ge_soft.tri_num = 0;
+}
+
+#if GE_SOFT_THREADS
+/* Initialize the mutex and the condition variables shared with the workers */
+static int _ge_soft_sync_init(void) {
+    if(pthread_mutex_init(&_ge_soft_mutex, NULL)) return GE_E_THREAD;
+    if(pthread_cond_init(&_ge_soft_start, NULL)){
+        pthread_mutex_destroy(&_ge_soft_mutex);
+        return GE_E_THREAD;
+    }
+    if(pthread_cond_init(&_ge_soft_done, NULL)){
+        pthread_cond_destroy(&_ge_soft_start);
+        pthread_mutex_destroy(&_ge_soft_mutex);
+        return GE_E_THREAD;
+    }
+    return GE_E_NONE;
+}
+
+static void _ge_soft_sync_free(void) {
+    pthread_cond_destroy(&_ge_soft_done);
+    pthread_cond_destroy(&_ge_soft_start);
+    pthread_mutex_destroy(&_ge_soft_mutex);
+}
+#endif
+
+int _ge_soft_raster_init(void) {
+    size_t i;
+#if GE_SOFT_THREADS
+    char *threads;
+    long int thread_num = 1;
+#endif
+    _ge_soft.tris = malloc(GE_SOFT_BATCH_MAX*sizeof(GESoftTriangle));
+    if(_ge_soft.tris == NULL) return GE_E_OUT_OF_MEM;
+    _ge_soft.tri_num = 0;
+    _ge_soft.bins = NULL;
+    _ge_soft.bin_num = 0;
+    _ge_soft.tiles_x = 0;
+    _ge_soft.tiles_y = 0;
+    _ge_soft.vertices = NULL;
+    _ge_soft.vertex_max = 0;
+    _ge_soft.state_num = 0;
+    _ge_soft.triangles = 0;
+    _ge_soft.target = NULL;
+    _ge_soft.program = NULL;
+    _ge_soft.depth_test = 1;
+    _ge_soft.blend = 0;
+    for(i=0;i<GE_SOFT_ATTR_MAX;i++){
+        _ge_soft.attribs[i].buffer = NULL;
+        _ge_soft.attribs[i].enabled = 0;
+    }
+    for(i=0;i<GE_SOFT_TEX_UNITS;i++) _ge_soft.units[i] = NULL;
+    if(ge_arena_init(&_ge_soft.states, _GE_SOFT_ARENA_MIN)){
+        free(_ge_soft.tris);
+        return GE_E_OUT_OF_MEM;
+    }
+    _ge_soft.thread_num = 1;
+#if GE_SOFT_THREADS
+    threads = getenv("GE_SOFT_THREADS");
+    if(threads){
+        thread_num = atol(threads);
+    }else{
+#ifdef _SC_NPROCESSORS_ONLN
+        thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    if(thread_num < 1) thread_num = 1;
+    if(thread_num > GE_SOFT_THREAD_MAX) thread_num = GE_SOFT_THREAD_MAX;
+    /* Render on the calling thread only if the workers can't be
+     * synchronized */
+    if(thread_num > 1 && _ge_soft_sync_init()) thread_num = 1;
+    if(thread_num > 1){
+        _ge_soft_generation = 0;
+        _ge_soft_quit = 0;
+        /* The thread calling ge_window_mainloop is also used */
+        for(i=0;i<(size_t)thread_num-1;i++){
+            if(pthread_create(_ge_soft_threads+i, NULL, _ge_soft_worker,
+                              NULL)){
+                break;
+            }
+        }
+        _ge_soft.thread_num = i+1;
+        if(!i) _ge_soft_sync_free();
+    }
+#endif
+    return GE_E_NONE;
+}
+
+void _ge_soft_flush(void) {
+    _ge_soft_raster_bins();
+    /* Free the states of the draw calls */
+    if(_ge_soft.state_num){
+        ge_arena_free(&_ge_soft.states);
+        ge_arena_init(&_ge_soft.states, _GE_SOFT_ARENA_MIN);
+        _ge_soft.state_num = 0;
+    }
+}
+
+void _ge_soft_use_target(GESoftTarget *target) {
+    GESoftBin *new;
+    size_t bin_num;
+    size_t i;
+    _ge_soft_flush();
+    _ge_soft.target = target;
+    _ge_soft.tiles_x = (target->width+GE_SOFT_TILE_SIZE-1)/GE_SOFT_TILE_SIZE;
+    _ge_soft.tiles_y = (target->height+GE_SOFT_TILE_SIZE-1)/
+                       GE_SOFT_TILE_SIZE;
+    bin_num = _ge_soft.tiles_x*_ge_soft.tiles_y;
+    if(bin_num > _ge_soft.bin_num){
+        new = realloc(_ge_soft.bins, bin_num*sizeof(GESoftBin));
+        if(new == NULL){
+            _ge_soft.tiles_x = 0;
+            _ge_soft.tiles_y = 0;
+            return;
+        }
+        _ge_soft.bins = new;
+        for(i=_ge_soft.bin_num;i<bin_num;i++){
+            _ge_soft.bins[i].tris = NULL;
+            _ge_soft.bins[i].num = 0;
+            _ge_soft.bins[i].max = 0;
+        }
+        _ge_soft.bin_num = bin_num;
+    }
+}
+
+static void _ge_soft_bin(GESoftTriangle *tri) {
+    GESoftBin *bin;
+    unsigned int *new;
+    int tx, ty;
+    for(ty=tri->min_y/GE_SOFT_TILE_SIZE;ty<=tri->max_y/GE_SOFT_TILE_SIZE;
+        ty++){
+        for(tx=tri->min_x/GE_SOFT_TILE_SIZE;
+            tx<=tri->max_x/GE_SOFT_TILE_SIZE;tx++){
+            bin = _ge_soft.bins+ty*_ge_soft.tiles_x+tx;
+            if(bin->num >= bin->max){
+                new = realloc(bin->tris, (bin->max+GE_SOFT_TILE_SIZE)*
+                              sizeof(unsigned int));
+                if(new == NULL) continue;
+                bin->tris = new;
+                bin->max += GE_SOFT_TILE_SIZE;
+            }
+            bin->tris[bin->num++] = tri-_ge_soft.tris;
+        }
+    }
+}
+
+/* Set up a triangle in clip space that is in front of the near plane */
+static void _ge_soft_setup(GESoftState *state, float *v[3]) {
+    GESoftTarget *target = _ge_soft.target;
+    GESoftTriangle *tri;
+    size_t varying_num = state->shader->varying_num;
+    float x[3], y[3], z[3], inv_w[3];
+    float min_x, min_y, max_x, max_y;
+    float area;
+    int order[3] = {0, 1, 2};
+    int a, b;
+    size_t i;
+    for(i=0;i<3;i++){
+        inv_w[i] = 1/v[i][3];
+        x[i] = _ge_soft.view_x+(v[i][0]*inv_w[i]+1)*_ge_soft.view_w*0.5f;
+        y[i] = _ge_soft.view_y+(v[i][1]*inv_w[i]+1)*_ge_soft.view_h*0.5f;
+        z[i] = (v[i][2]*inv_w[i]+1)*0.5f;
+    }
+    area = (x[1]-x[0])*(y[2]-y[0])-(x[2]-x[0])*(y[1]-y[0]);
+    if(!(area > 0 || area < 0)) return;
+    /* Triangles are not culled, clockwise triangles are turned into counter
+     * clockwise ones. */
+    if(area < 0){
+        order[1] = 2;
+        order[2] = 1;
+        area = -area;
+    }
+    /* Get the pixels whose centers may be covered by the triangle */
+    min_x = max_x = x[0];
+    min_y = max_y = y[0];
+    for(i=1;i<3;i++){
+        if(x[i] < min_x) min_x = x[i];
+        if(x[i] > max_x) max_x = x[i];
+        if(y[i] < min_y) min_y = y[i];
+        if(y[i] > max_y) max_y = y[i];
+    }
+    min_x = ceil(min_x-0.5f);
+    min_y = ceil(min_y-0.5f);
+    max_x = floor(max_x-0.5f);
+    max_y = floor(max_y-0.5f);
+    if(min_x < _ge_soft.view_x) min_x = _ge_soft.view_x;
+    if(min_y < _ge_soft.view_y) min_y = _ge_soft.view_y;
+    if(min_x < 0) min_x = 0;
+    if(min_y < 0) min_y = 0;
+    if(max_x > _ge_soft.view_x+_ge_soft.view_w-1){
+        max_x = _ge_soft.view_x+_ge_soft.view_w-1;
+    }
+    if(max_y > _ge_soft.view_y+_ge_soft.view_h-1){
+        max_y = _ge_soft.view_y+_ge_soft.view_h-1;
+    }
+    if(max_x > target->width-1) max_x = target->width-1;
+    if(max_y > target->height-1) max_y = target->height-1;
+    if(min_x > max_x || min_y > max_y) return;
+    
+    if(_ge_soft.tri_num >= GE_SOFT_BATCH_MAX) _ge_soft_raster_bins();
+    tri = _ge_soft.tris+_ge_soft.tri_num++;
+    tri->min_x = min_x;
+    tri->min_y = min_y;
+    tri->max_x = max_x;
+    tri->max_y = max_y;
+    tri->state = state;
+    tri->inv_area = 1/area;
+    for(i=0;i<3;i++){
+        /* The edge in front of the vertex i */
+        a = order[(i+1)%3];
+        b = order[(i+2)%3];
+        tri->edge[i][0] = y[a]-y[b];
+        tri->edge[i][1] = x[b]-x[a];
+        tri->edge[i][2] = -(tri->edge[i][0]*x[a]+tri->edge[i][1]*y[a]);
+        tri->top_left[i] = tri->edge[i][0] > 0 ||
+                           (tri->edge[i][0] == 0 && tri->edge[i][1] < 0);
+        tri->z[i] = z[order[i]];
+        tri->inv_w[i] = inv_w[order[i]];
+        for(a=0;(size_t)a<varying_num;a++){
+            tri->varyings[i][a] = v[order[i]][4+a]*inv_w[order[i]];
+        }
+    }
+    _ge_soft_bin(tri);
+}
+
+/* Clip a triangle against the near plane */
+static void _ge_soft_triangle(GESoftState *state, float *v[3]) {
+    float clipped[_GE_SOFT_CLIP_MAX][4+GE_SOFT_VARYING_MAX];
+    float *polygon[_GE_SOFT_CLIP_MAX];
+    float *tri[3];
+    float d[3];
+    float t;
+    size_t stride = _GE_SOFT_STRIDE(state->shader);
+    size_t num = 0;
+    size_t i, n, a, b;
+    int inside = 0;
+    for(i=0;i<3;i++){
+        d[i] = v[i][2]+v[i][3];
+        if(d[i] >= 0 && v[i][3] > 0) inside++;
+    }
+    _ge_soft.triangles++;
+    if(inside == 3){
+        _ge_soft_setup(state, v);
+        return;
+    }
+    if(!inside) return;
+    /* Sutherland-Hodgman clipping with a single plane */
+    for(i=0;i<3;i++){
+        a = i;
+        b = (i+1)%3;
+        if(d[a] >= 0){
+            memcpy(clipped[num], v[a], stride*sizeof(float));
+            polygon[num] = clipped[num];
+            num++;
+        }
+        if((d[a] >= 0) != (d[b] >= 0)){
+            t = d[a]/(d[a]-d[b]);
+            for(n=0;n<stride;n++){
+                clipped[num][n] = v[a][n]+(v[b][n]-v[a][n])*t;
+            }
+            polygon[num] = clipped[num];
+            num++;
+        }
+    }
+    for(i=0;i<num;i++){
+        if(polygon[i][3] <= 0) return;
+    }
+    for(i=1;i+1<num;i++){
+        tri[0] = polygon[0];
+        tri[1] = polygon[i];
+        tri[2] = polygon[i+1];
+        _ge_soft_setup(state, tri);
+    }
+}
+
+void _ge_soft_draw(GESoftBuffer *indices, size_t num) {
+    GESoftProgram *program = _ge_soft.program;
+    GESoftShader *shader;
+    GESoftState *state;
+    GESoftAttrib *attrib;
+    float attr[GE_SOFT_ATTR_MAX][4];
+    float *v[3];
+    float *new;
+    unsigned int *index = NULL;
+    size_t vertex_num = num;
+    size_t stride;
+    size_t i, n;
+    int loc;
+    
+    if(program == NULL || _ge_soft.target == NULL) return;
+    shader = program->shader;
+    stride = _GE_SOFT_STRIDE(shader);
+    
+    if(indices){
+        index = indices->data;
+        if(num > indices->size) num = indices->size;
+        vertex_num = 0;
+        for(i=0;i<num;i++){
+            if(index[i] >= vertex_num) vertex_num = index[i]+1;
+        }
+    }
+    if(vertex_num*stride > _ge_soft.vertex_max){
+        new = realloc(_ge_soft.vertices, vertex_num*stride*sizeof(float));
+        if(new == NULL) return;
+        _ge_soft.vertices = new;
+        _ge_soft.vertex_max = vertex_num*stride;
+    }
+    
+    state = _ge_soft_state_new(program);
+    if(state == NULL) return;
+    
+    /* Run the vertex shader on all the vertices */
+    for(i=0;i<vertex_num;i++){
+        for(n=0;n<shader->attr_num;n++){
+            attr[n][0] = attr[n][1] = attr[n][2] = 0;
+            attr[n][3] = 1;
+            loc = program->attr_loc[n];
+            if(loc < 0) continue;
+            attrib = _ge_soft.attribs+loc;
+            if(!attrib->enabled || attrib->buffer == NULL) continue;
+            if(attrib->offset+i*attrib->stride+attrib->item_size >
+               attrib->buffer->size){
+                continue;
+            }
+            memcpy(attr[n], (float*)attrib->buffer->data+attrib->offset+
+                   i*attrib->stride,
+                   (attrib->item_size < 4 ? attrib->item_size : 4)*
+                   sizeof(float));
+        }
+        shader->vertex(state, attr, _ge_soft.vertices+i*stride,
+                       _ge_soft.vertices+i*stride+4);
+    }
+    
+    for(i=0;i+2<num;i+=3){
+        for(n=0;n<3;n++){
+            v[n] = _ge_soft.vertices+(index ? index[i+n] : i+n)*stride;
+        }
+        _ge_soft_triangle(state, v);
+    }
+}
+
+void _ge_soft_raster_free(void) {
+    size_t i;
+    _ge_soft_flush();
+#if GE_SOFT_THREADS
+    if(_ge_soft.thread_num > 1){
+        pthread_mutex_lock(&_ge_soft_mutex);
+        _ge_soft_quit = 1;
+        pthread_cond_broadcast(&_ge_soft_start);
+        pthread_mutex_unlock(&_ge_soft_mutex);
+        for(i=0;i<_ge_soft.thread_num-1;i++){
+            pthread_join(_ge_soft_threads[i], NULL);
+        }
+        _ge_soft_sync_free();
+    }
+#endif
+    _ge_soft.thread_num = 1;
+    for(i=0;i<_ge_soft.bin_num;i++) free(_ge_soft.bins[i].tris);
+    free(_ge_soft.bins);
+    _ge_soft.bins = NULL;
+    _ge_soft.bin_num = 0;
+    free(_ge_soft.tris);
+    _ge_soft.tris = NULL;
+    free(_ge_soft.vertices);
+    _ge_soft.vertices = NULL;
+    _ge_soft.vertex_max = 0;
+    ge_arena_free(&_ge_soft.states);
+}
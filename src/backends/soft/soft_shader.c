@@ -0,0 +1,556 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <soft.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <mibiengine2/errors.h>
+
+#define _GE_SOFT_TYPE_NUM 10
+
+#define _GE_SOFT_UNIT(state, n) \
+    ((state)->units[(size_t)(state)->uniform[n][0]%GE_SOFT_TEX_UNITS])
+
+/* Ports of the shaders in the shaders folder. */
+
+static char *_ge_soft_std3d_attrs[] = {
+    "ge_vertex",
+    "ge_uv",
+    "ge_normal"
+};
+
+static char *_ge_soft_std3d_uniforms[] = {
+    "ge_projection_mat",
+    "ge_view_mat",
+    "ge_model_mat",
+    "ge_normal_mat",
+    "ge_texture",
+    "ge_uv_max"
+};
+
+static char *_ge_soft_std2d_attrs[] = {
+    "ge_vertex",
+    "ge_uv"
+};
+
+static char *_ge_soft_std2d_uniforms[] = {
+    "ge_projection_mat",
+    "ge_view_mat",
+    "ge_model_mat",
+    "ge_texture",
+    "ge_uv_max"
+};
+
+static char *_ge_soft_fb_attrs[] = {
+    "vertex",
+    "uv"
+};
+
+static char *_ge_soft_fb_uniforms[] = {
+    "size",
+    "color"
+};
+
+static float _ge_soft_zero[16];
+
+static void _ge_soft_mat4_mul(float *dest, float *a, float *b) {
+    size_t c, r, k;
+    float v;
+    for(c=0;c<4;c++){
+        for(r=0;r<4;r++){
+            v = 0;
+            for(k=0;k<4;k++) v += a[k*4+r]*b[c*4+k];
+            dest[c*4+r] = v;
+        }
+    }
+}
+
+static void _ge_soft_mat4_vec(float *dest, float *m, float *v) {
+    size_t r;
+    for(r=0;r<4;r++){
+        dest[r] = m[r]*v[0]+m[4+r]*v[1]+m[8+r]*v[2]+m[12+r]*v[3];
+    }
+}
+
+static float _ge_soft_mod(float x, float y) {
+    if(y == 0) return 0;
+    return x-y*(float)floor(x/y);
+}
+
+static void _ge_soft_mvp_prepare(GESoftState *state) {
+    float tmp[16];
+    /* uniform[0..2] are the projection, view and model matrices */
+    _ge_soft_mat4_mul(tmp, state->uniform[0], state->uniform[1]);
+    _ge_soft_mat4_mul(state->scratch, tmp, state->uniform[2]);
+}
+
+static void _ge_soft_std3d_vertex(GESoftState *state,
+                                  float attr[GE_SOFT_ATTR_MAX][4], float *pos,
+                                  float *varyings) {
+    float *m = state->uniform[3];
+    float *n = attr[2];
+    float l;
+    size_t r;
+    _ge_soft_mat4_vec(pos, state->scratch, attr[0]);
+    /* frag_pos */
+    varyings[0] = pos[0];
+    varyings[1] = pos[1];
+    varyings[2] = pos[2];
+    /* frag_uv */
+    varyings[3] = attr[1][0];
+    varyings[4] = attr[1][1];
+    /* frag_normal */
+    for(r=0;r<3;r++){
+        varyings[5+r] = m[r]*n[0]+m[3+r]*n[1]+m[6+r]*n[2];
+    }
+    l = (float)sqrt(varyings[5]*varyings[5]+varyings[6]*varyings[6]+
+                    varyings[7]*varyings[7]);
+    if(l > 0){
+        for(r=0;r<3;r++) varyings[5+r] /= l;
+    }
+}
+
+static int _ge_soft_std3d_fragment(GESoftState *state, float *varyings,
+                                   float *color) {
+    float *uv_max = state->uniform[5];
+    float u, v;
+    float dir[3];
+    float l, diffuse, specular, light;
+    size_t i;
+    u = _ge_soft_mod(varyings[3]*uv_max[0], uv_max[0]);
+    v = uv_max[1]-_ge_soft_mod(varyings[4]*uv_max[1], uv_max[1]);
+    _ge_soft_sample(_GE_SOFT_UNIT(state, 4), u, v, color);
+    /* The light and the camera are both at the origin, so the half vector is
+     * the direction to the light. */
+    l = (float)sqrt(varyings[0]*varyings[0]+varyings[1]*varyings[1]+
+                    varyings[2]*varyings[2]);
+    for(i=0;i<3;i++) dir[i] = l > 0 ? -varyings[i]/l : 0;
+    diffuse = dir[0]*varyings[5]+dir[1]*varyings[6]+dir[2]*varyings[7];
+    if(diffuse < 0) diffuse = 0;
+    /* pow(diffuse, 32) */
+    specular = diffuse*diffuse;
+    for(i=0;i<4;i++) specular *= specular;
+    light = diffuse+specular+0.3;
+    for(i=0;i<4;i++) color[i] *= light;
+    return 1;
+}
+
+static void _ge_soft_std2d_vertex(GESoftState *state,
+                                  float attr[GE_SOFT_ATTR_MAX][4], float *pos,
+                                  float *varyings) {
+    _ge_soft_mat4_vec(pos, state->scratch, attr[0]);
+    varyings[0] = attr[1][0];
+    varyings[1] = attr[1][1];
+}
+
+static int _ge_soft_std2d_fragment(GESoftState *state, float *varyings,
+                                   float *color) {
+    float *uv_max = state->uniform[4];
+    _ge_soft_sample(_GE_SOFT_UNIT(state, 3),
+                    _ge_soft_mod(varyings[0]*uv_max[0], uv_max[0]),
+                    _ge_soft_mod(varyings[1]*uv_max[1], uv_max[1]), color);
+    return 1;
+}
+
+static void _ge_soft_fb_vertex(GESoftState *state,
+                               float attr[GE_SOFT_ATTR_MAX][4], float *pos,
+                               float *varyings) {
+    float *size = state->uniform[0];
+    varyings[0] = attr[1][0]*size[0];
+    varyings[1] = size[1]-attr[1][1]*size[1];
+    pos[0] = attr[0][0];
+    pos[1] = attr[0][1];
+    pos[2] = 1;
+    pos[3] = 1;
+}
+
+static int _ge_soft_fb_fragment(GESoftState *state, float *varyings,
+                                float *color) {
+    /* The blur of fragment_fb.frag is smaller than a texel at the default
+     * window size, so it is left out. */
+    _ge_soft_sample(_GE_SOFT_UNIT(state, 1), varyings[0], varyings[1], color);
+    return 1;
+}
+
+static GESoftShader _ge_soft_shaders[] = {
+    {
+        "std3d", 8,
+        _ge_soft_std3d_attrs, 3,
+        _ge_soft_std3d_uniforms, 6,
+        _ge_soft_mvp_prepare,
+        _ge_soft_std3d_vertex,
+        _ge_soft_std3d_fragment
+    },
+    {
+        "std2d", 2,
+        _ge_soft_std2d_attrs, 2,
+        _ge_soft_std2d_uniforms, 5,
+        _ge_soft_mvp_prepare,
+        _ge_soft_std2d_vertex,
+        _ge_soft_std2d_fragment
+    },
+    {
+        "fb", 2,
+        _ge_soft_fb_attrs, 2,
+        _ge_soft_fb_uniforms, 2,
+        NULL,
+        _ge_soft_fb_vertex,
+        _ge_soft_fb_fragment
+    }
+};
+
+#define _GE_SOFT_SHADER_NUM (sizeof(_ge_soft_shaders)/sizeof(GESoftShader))
+
+void _ge_soft_sample(GESoftTexture *texture, float u, float v,
+                     float *color) {
+    float x, y;
+    float fx, fy;
+    float texels[4][4];
+    int tx[2], ty[2];
+    size_t i, n;
+    unsigned char *c;
+    if(texture == NULL || texture->width <= 0 || texture->height <= 0){
+        color[0] = color[1] = color[2] = 0;
+        color[3] = 1;
+        return;
+    }
+    x = u*texture->width;
+    y = v*texture->height;
+    if(texture->linear){
+        x -= 0.5;
+        y -= 0.5;
+    }
+    tx[0] = (int)floor(x);
+    ty[0] = (int)floor(y);
+    fx = x-tx[0];
+    fy = y-ty[0];
+    /* GL_REPEAT */
+    tx[0] %= texture->width;
+    if(tx[0] < 0) tx[0] += texture->width;
+    ty[0] %= texture->height;
+    if(ty[0] < 0) ty[0] += texture->height;
+    tx[1] = tx[0]+1 < texture->width ? tx[0]+1 : 0;
+    ty[1] = ty[0]+1 < texture->height ? ty[0]+1 : 0;
+    for(i=0;i<(texture->linear ? 4u : 1u);i++){
+        n = ty[i>>1]*texture->width+tx[i&1];
+        if(texture->depth){
+            texels[i][0] = texels[i][1] = texels[i][2] = texture->depth[n];
+            texels[i][3] = 1;
+        }else{
+            c = texture->color+n*4;
+            texels[i][0] = c[0]*(1/255.0f);
+            texels[i][1] = c[1]*(1/255.0f);
+            texels[i][2] = c[2]*(1/255.0f);
+            texels[i][3] = c[3]*(1/255.0f);
+        }
+    }
+    if(!texture->linear){
+        memcpy(color, texels[0], sizeof(float)*4);
+        return;
+    }
+    for(i=0;i<4;i++){
+        color[i] = (texels[0][i]*(1-fx)+texels[1][i]*fx)*(1-fy)+
+                   (texels[2][i]*(1-fx)+texels[3][i]*fx)*fy;
+    }
+}
+
+GESoftShader *_ge_soft_shader_find(char *name) {
+    size_t i;
+    for(i=0;i<_GE_SOFT_SHADER_NUM;i++){
+        if(!strcmp(_ge_soft_shaders[i].name, name)) return _ge_soft_shaders+i;
+    }
+    return NULL;
+}
+
+int _ge_soft_program_attr(GESoftProgram *program, char *name) {
+    size_t i;
+    if(program == NULL) return -1;
+    for(i=0;i<program->attr_num;i++){
+        if(!strcmp(program->attrs[i], name)) return i;
+    }
+    return -1;
+}
+
+int _ge_soft_program_uniform(GESoftProgram *program, char *name) {
+    size_t i;
+    if(program == NULL) return -1;
+    for(i=0;i<program->uniform_num;i++){
+        if(!strcmp(program->uniforms[i].name, name)) return i;
+    }
+    return -1;
+}
+
+GESoftState *_ge_soft_state_new(GESoftProgram *program) {
+    GESoftState *state;
+    GESoftShader *shader = program->shader;
+    float *uniforms;
+    size_t i;
+    int loc;
+    state = ge_arena_alloc(&_ge_soft.states, 1, sizeof(GESoftState));
+    if(state == NULL) return NULL;
+    uniforms = ge_arena_alloc(&_ge_soft.states, program->uniform_size+1,
+                              sizeof(float));
+    if(uniforms == NULL) return NULL;
+    _ge_soft.state_num++;
+    memcpy(uniforms, program->values, program->uniform_size*sizeof(float));
+    state->shader = shader;
+    for(i=0;i<shader->uniform_num;i++){
+        loc = program->uniform_loc[i];
+        state->uniform[i] = loc < 0 ? _ge_soft_zero :
+                            uniforms+program->uniforms[loc].offset;
+    }
+    memcpy(state->units, _ge_soft.units, sizeof(state->units));
+    state->depth_test = _ge_soft.depth_test;
+    state->blend = _ge_soft.blend;
+    if(shader->prepare) shader->prepare(state);
+    return state;
+}
+
+static void _ge_soft_shader_parse(GESoftProgram *program, char *source,
+                                  char *name) {
+    char *types[_GE_SOFT_TYPE_NUM] = {
+        "float",
+        "int",
+        "bool",
+        "vec2",
+        "vec3",
+        "vec4",
+        "mat2",
+        "mat3",
+        "mat4",
+        "sampler2D"
+    };
+    size_t type_sizes[_GE_SOFT_TYPE_NUM] = {
+        1, 1, 1, 2, 3, 4, 4, 9, 16, 1
+    };
+    char tokens[4][GE_SOFT_NAME_SZ];
+    char *type, *var;
+    char *line;
+    size_t i;
+    int n;
+    for(line=source;line;line=strchr(line, '\n')){
+        while(*line == '\n' || *line == ' ' || *line == '\t') line++;
+        if(!strncmp(line, "#pragma", 7)){
+            sscanf(line, "#pragma ge_soft %31s", name);
+            continue;
+        }
+        if(strncmp(line, "attribute", 9) && strncmp(line, "uniform", 7)){
+            continue;
+        }
+        n = sscanf(line, "%31s %31s %31s %31s", tokens[0], tokens[1],
+                   tokens[2], tokens[3]);
+        if(n < 3) continue;
+        /* Skip the precision qualifier */
+        if(!strcmp(tokens[1], "lowp") || !strcmp(tokens[1], "mediump") ||
+           !strcmp(tokens[1], "highp")){
+            if(n < 4) continue;
+            type = tokens[2];
+            var = tokens[3];
+        }else{
+            type = tokens[1];
+            var = tokens[2];
+        }
+        var[strcspn(var, ";[")] = '\0';
+        if(tokens[0][0] == 'a'){
+            if(program->attr_num >= GE_SOFT_ATTR_MAX) continue;
+            if(_ge_soft_program_attr(program, var) >= 0) continue;
+            strcpy(program->attrs[program->attr_num++], var);
+            continue;
+        }
+        if(program->uniform_num >= GE_SOFT_UNIFORM_MAX) continue;
+        if(_ge_soft_program_uniform(program, var) >= 0) continue;
+        for(i=0;i<_GE_SOFT_TYPE_NUM;i++){
+            if(!strcmp(types[i], type)) break;
+        }
+        if(i >= _GE_SOFT_TYPE_NUM) continue;
+        strcpy(program->uniforms[program->uniform_num].name, var);
+        program->uniforms[program->uniform_num].offset = program->uniform_size;
+        program->uniforms[program->uniform_num].size = type_sizes[i];
+        program->uniform_size += type_sizes[i];
+        program->uniform_num++;
+    }
+}
+
+static int _ge_soft_shader_match(GESoftProgram *program,
+                                 GESoftShader *shader) {
+    size_t i;
+    for(i=0;i<shader->attr_num;i++){
+        if(_ge_soft_program_attr(program, shader->attr_names[i]) < 0){
+            return 0;
+        }
+    }
+    for(i=0;i<shader->uniform_num;i++){
+        if(_ge_soft_program_uniform(program, shader->uniform_names[i]) < 0){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+char *_ge_soft_shader_init(GEShader *shader, char *vertex_source,
+                           char *fragment_source) {
+    static char log[GE_SHADER_LOG_SIZE];
+    char name[GE_SOFT_NAME_SZ] = "";
+    GESoftProgram *program;
+    size_t i;
+    
+    program = malloc(sizeof(GESoftProgram));
+    if(program == NULL) return "Failed to allocate shader program";
+    program->attr_num = 0;
+    program->uniform_num = 0;
+    program->uniform_size = 0;
+    program->shader = NULL;
+    
+    _ge_soft_shader_parse(program, vertex_source, name);
+    _ge_soft_shader_parse(program, fragment_source, name);
+    
+    /* Use the shader given with #pragma ge_soft or the first one that uses
+     * attributes and uniforms declared in the sources */
+    if(*name){
+        program->shader = _ge_soft_shader_find(name);
+        if(program->shader == NULL){
+            sprintf(log, "Unknown software shader \"%s\"", name);
+            free(program);
+            return log;
+        }
+    }else{
+        for(i=0;i<_GE_SOFT_SHADER_NUM;i++){
+            if(_ge_soft_shader_match(program, _ge_soft_shaders+i)){
+                program->shader = _ge_soft_shaders+i;
+                break;
+            }
+        }
+        if(program->shader == NULL){
+            free(program);
+            return "No matching software shader, choose one with "
+                   "#pragma ge_soft <name>";
+        }
+    }
+    for(i=0;i<program->shader->attr_num;i++){
+        program->attr_loc[i] = _ge_soft_program_attr(program,
+                                            program->shader->attr_names[i]);
+    }
+    for(i=0;i<program->shader->uniform_num;i++){
+        program->uniform_loc[i] = _ge_soft_program_uniform(program,
+                                            program->shader->uniform_names[i]);
+    }
+    
+    program->values = calloc(program->uniform_size+1, sizeof(float));
+    if(program->values == NULL){
+        free(program);
+        return "Failed to allocate uniforms";
+    }
+    shader->shader_program = _ge_soft_object_add(program);
+    if(!shader->shader_program){
+        free(program->values);
+        free(program);
+        return "Failed to add shader program";
+    }
+    shader->vertex_shader = 0;
+    shader->fragment_shader = 0;
+    return NULL;
+}
+
+void _ge_soft_shader_use(GEShader *shader) {
+    _ge_soft.program = _ge_soft_object_get(shader->shader_program);
+}
+
+GEShaderPos _ge_soft_shader_get_pos(GEShader *shader, char *name) {
+    GEShaderPos pos;
+    pos.attr = -1;
+    pos.size = 1;
+    pos.pos = _ge_soft_program_uniform(_ge_soft_object_get(
+                                            shader->shader_program), name);
+    return pos;
+}
+
+void _ge_soft_shader_load(GEShaderPos *pos, float *values, size_t num) {
+    GESoftProgram *program = _ge_soft.program;
+    GESoftUniform *uniform;
+    if(program == NULL || pos->pos < 0 ||
+       (size_t)pos->pos >= program->uniform_num){
+        return;
+    }
+    uniform = program->uniforms+pos->pos;
+    memcpy(program->values+uniform->offset, values,
+           (num < uniform->size ? num : uniform->size)*sizeof(float));
+}
+
+void _ge_soft_shader_load_mat4(GEShaderPos *pos, GEMat4 *mat) {
+    _ge_soft_shader_load(pos, mat->mat, 16);
+}
+
+void _ge_soft_shader_load_mat3(GEShaderPos *pos, GEMat3 *mat) {
+    _ge_soft_shader_load(pos, mat->mat, 9);
+}
+
+void _ge_soft_shader_load_vec4(GEShaderPos *pos, GEVec4 *vec) {
+    float values[4];
+    values[0] = vec->x;
+    values[1] = vec->y;
+    values[2] = vec->z;
+    values[3] = vec->w;
+    _ge_soft_shader_load(pos, values, 4);
+}
+
+void _ge_soft_shader_load_vec3(GEShaderPos *pos, GEVec3 *vec) {
+    float values[3];
+    values[0] = vec->x;
+    values[1] = vec->y;
+    values[2] = vec->z;
+    _ge_soft_shader_load(pos, values, 3);
+}
+
+void _ge_soft_shader_load_vec2(GEShaderPos *pos, GEVec2 *vec) {
+    float values[2];
+    values[0] = vec->x;
+    values[1] = vec->y;
+    _ge_soft_shader_load(pos, values, 2);
+}
+
+void _ge_soft_shader_free(GEShader *shader) {
+    GESoftProgram *program = _ge_soft_object_get(shader->shader_program);
+    if(program == NULL) return;
+    /* The draw calls that were not rasterized yet have their own copy of the
+     * uniforms, so the program can be freed right away. */
+    if(_ge_soft.program == program) _ge_soft.program = NULL;
+    free(program->values);
+    free(program);
+    _ge_soft_object_remove(shader->shader_program);
+    shader->shader_program = 0;
+}
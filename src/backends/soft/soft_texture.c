@@ -0,0 +1,235 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <soft.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mibiengine2/errors.h>
+
+GESoftTexture *_ge_soft_texture_new(int w, int h, int depth, int linear) {
+    GESoftTexture *texture;
+    texture = malloc(sizeof(GESoftTexture));
+    if(texture == NULL) return NULL;
+    texture->color = NULL;
+    texture->depth = NULL;
+    texture->width = 0;
+    texture->height = 0;
+    texture->linear = linear;
+    texture->owned = 1;
+    texture->is_depth = depth;
+    if(_ge_soft_texture_resize(texture, w, h)){
+        free(texture);
+        return NULL;
+    }
+    return texture;
+}
+
+int _ge_soft_texture_resize(GESoftTexture *texture, int w, int h) {
+    void *new;
+    size_t size = (size_t)w*h;
+    if(texture->is_depth){
+        new = realloc(texture->depth, (size ? size : 1)*sizeof(float));
+        if(new == NULL) return GE_E_OUT_OF_MEM;
+        texture->depth = new;
+    }else{
+        new = realloc(texture->color, (size ? size : 1)*4);
+        if(new == NULL) return GE_E_OUT_OF_MEM;
+        texture->color = new;
+    }
+    texture->width = w;
+    texture->height = h;
+    return GE_E_NONE;
+}
+
+void _ge_soft_texture_delete(GESoftTexture *texture) {
+    size_t i;
+    if(texture == NULL) return;
+    for(i=0;i<GE_SOFT_TEX_UNITS;i++){
+        if(_ge_soft.units[i] == texture) _ge_soft.units[i] = NULL;
+    }
+    if(texture->owned){
+        free(texture->color);
+        free(texture->depth);
+    }
+    free(texture);
+}
+
+void _ge_soft_texture_layout(int width, int height, int mipmap,
+                             int *data_width, int *data_height) {
+    /* Textures of any size are sampled the same way */
+    (void)mipmap;
+    *data_width = width;
+    *data_height = height;
+}
+
+static int _ge_soft_texture_copy(GETexture *texture, GEImage *image) {
+    texture->width = image->width;
+    texture->height = image->height;
+    if(image->data_width && !image->flip == !texture->flip &&
+       image->file.data == NULL){
+        /* The image was decoded in the layout of a texture, take its pixels
+         * over */
+        texture->data_width = image->data_width;
+        texture->data_height = image->data_height;
+        texture->uv_max.x = image->width/(float)texture->data_width;
+        texture->uv_max.y = image->height/(float)texture->data_height;
+        texture->data = image->data;
+        image->data = NULL;
+        return GE_E_NONE;
+    }
+    /* Make a copy of the texture in RGBA color format, the file it may be
+     * mapped from can be unmapped while it is used */
+    texture->data_width = image->width;
+    texture->data_height = image->height;
+    texture->uv_max.x = 1;
+    texture->uv_max.y = 1;
+    texture->data = calloc((size_t)texture->data_width*texture->data_height,
+                           4);
+    if(texture->data == NULL){
+        return GE_E_OUT_OF_MEM;
+    }
+    ge_image_copy_texture(image, texture->data, texture->data_width,
+                          texture->data_height, texture->flip);
+    return GE_E_NONE;
+}
+
+int _ge_soft_texture_init(GETexture *texture, GEImage *image, int linear,
+                          int flip, int mipmap) {
+    GESoftTexture *soft_texture;
+    texture->flip = flip;
+    /* The software renderer only samples the first level */
+    texture->mipmap = mipmap;
+    texture->format = GE_IMAGE_FORMAT_RGBA8;
+    if(_ge_soft_texture_copy(texture, image)) return GE_E_OUT_OF_MEM;
+    /* The texture data is sampled directly, it isn't copied another time */
+    soft_texture = malloc(sizeof(GESoftTexture));
+    if(soft_texture == NULL){
+        free(texture->data);
+        texture->data = NULL;
+        return GE_E_OUT_OF_MEM;
+    }
+    soft_texture->color = texture->data;
+    soft_texture->depth = NULL;
+    soft_texture->width = texture->data_width;
+    soft_texture->height = texture->data_height;
+    soft_texture->linear = linear;
+    soft_texture->owned = 0;
+    soft_texture->is_depth = 0;
+    texture->id = _ge_soft_object_add(soft_texture);
+    if(!texture->id){
+        free(soft_texture);
+        free(texture->data);
+        texture->data = NULL;
+        return GE_E_OUT_OF_MEM;
+    }
+    return GE_E_NONE;
+}
+
+int _ge_soft_texture_update(GETexture *texture, GEImage *image) {
+    GESoftTexture *soft_texture = _ge_soft_object_get(texture->id);
+    if(soft_texture == NULL) return GE_E_UNKNOWN;
+    if(texture->data != NULL && (int)image->width == texture->width &&
+       (int)image->height == texture->height){
+        return _ge_soft_texture_update_region(texture, image, 0, 0,
+                                              image->width, image->height);
+    }
+    /* Rasterize the triangles that still sample the old texture */
+    _ge_soft_flush();
+    free(texture->data);
+    if(_ge_soft_texture_copy(texture, image)){
+        soft_texture->color = NULL;
+        soft_texture->width = 0;
+        soft_texture->height = 0;
+        return GE_E_OUT_OF_MEM;
+    }
+    soft_texture->color = texture->data;
+    soft_texture->width = texture->data_width;
+    soft_texture->height = texture->data_height;
+    return GE_E_NONE;
+}
+
+int _ge_soft_texture_update_region(GETexture *texture, GEImage *image,
+                                   int x, int y, int w, int h) {
+    if(texture->data == NULL || (int)image->width != texture->width ||
+       (int)image->height != texture->height){
+        return _ge_soft_texture_update(texture, image);
+    }
+    /* Rasterize the triangles that still sample the old pixels */
+    _ge_soft_flush();
+    ge_image_copy_region(image, texture->data, texture->data_width,
+                         texture->data_height, texture->flip, x, y, w, h);
+    return GE_E_NONE;
+}
+
+void _ge_soft_texture_memory(GETexture *texture, size_t *gpu, size_t *cpu) {
+    /* The pixels are sampled from the copy on the CPU */
+    *gpu = 0;
+    *cpu = 0;
+    if(texture->data != NULL){
+        *cpu = (size_t)texture->data_width*texture->data_height*4;
+    }
+}
+
+int _ge_soft_texture_residency(GETexture *texture, GEImage *image, int lod) {
+    /* There is no other copy of the pixels that could be evicted, and only
+     * the first level is sampled, so it is always loaded in full */
+    (void)lod;
+    texture->lod = 0;
+    if(image != NULL) return _ge_soft_texture_update(texture, image);
+    return GE_E_NONE;
+}
+
+void _ge_soft_texture_release(GETexture *texture) {
+    /* The copy of the pixels is the one that gets sampled */
+    (void)texture;
+}
+
+void _ge_soft_texture_use(GETexture *texture, GEShaderPos *pos, size_t n) {
+    float unit;
+    if(n >= GE_SOFT_TEX_UNITS) n = GE_SOFT_TEX_UNITS-1;
+    _ge_soft.units[n] = _ge_soft_object_get(texture->id);
+    unit = n;
+    _ge_soft_shader_load(pos, &unit, 1);
+}
+
+void _ge_soft_texture_free(GETexture *texture) {
+    _ge_soft_flush();
+    _ge_soft_texture_delete(_ge_soft_object_get(texture->id));
+    _ge_soft_object_remove(texture->id);
+    texture->id = 0;
+    free(texture->data);
+    texture->data = NULL;
+}
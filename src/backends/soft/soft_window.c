@@ -0,0 +1,212 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <soft.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mibiengine2/errors.h>
+
+static void _ge_soft_window_output(char *file) {
+    GESoftTexture *color = _ge_soft.window.color;
+    FILE *fp;
+    int x, y;
+    fp = fopen(file, "wb");
+    if(fp == NULL){
+        fprintf(stderr, "Failed to open \"%s\"!\n", file);
+        return;
+    }
+    /* Rows are stored from the bottom to the top, like with OpenGL */
+    fprintf(fp, "P6\n%d %d\n255\n", color->width, color->height);
+    for(y=color->height-1;y>=0;y--){
+        for(x=0;x<color->width;x++){
+            fwrite(color->color+((size_t)y*color->width+x)*4, 1, 3, fp);
+        }
+    }
+    fclose(fp);
+}
+
+int _ge_soft_window_init(GEWindow *window, char *title) {
+    int rc;
+    (void)title;
+    rc = _ge_soft_raster_init();
+    if(rc) return rc;
+    _ge_soft.window.width = GE_SOFT_WINDOW_WIDTH;
+    _ge_soft.window.height = GE_SOFT_WINDOW_HEIGHT;
+    _ge_soft.window.color = _ge_soft_texture_new(GE_SOFT_WINDOW_WIDTH,
+                                                 GE_SOFT_WINDOW_HEIGHT, 0, 0);
+    _ge_soft.window.depth = _ge_soft_texture_new(GE_SOFT_WINDOW_WIDTH,
+                                                 GE_SOFT_WINDOW_HEIGHT, 1, 0);
+    if(_ge_soft.window.color == NULL || _ge_soft.window.depth == NULL){
+        _ge_soft_texture_delete(_ge_soft.window.color);
+        _ge_soft_texture_delete(_ge_soft.window.depth);
+        _ge_soft_raster_free();
+        return GE_E_OUT_OF_MEM;
+    }
+    _ge_soft_use_target(&_ge_soft.window);
+    _ge_soft_window_view(window, GE_SOFT_WINDOW_WIDTH, GE_SOFT_WINDOW_HEIGHT);
+    _ge_soft_window_clear(window, 0, 0, 0, 0);
+    
+    window->egl.display = NULL;
+    window->egl.surface = NULL;
+    window->egl.config = NULL;
+    window->egl.context = NULL;
+    window->platform.display = NULL;
+    window->platform.window = NULL;
+    window->platform.wm_delete_window = NULL;
+    memset(window->platform.keys_down, 0, GE_K_AMOUNT);
+    window->platform.mouse_x = 0;
+    window->platform.mouse_y = 0;
+    
+    window->draw = NULL;
+    window->resize = NULL;
+    window->keyevent = NULL;
+    window->mouseevent = NULL;
+    return GE_E_NONE;
+}
+
+int _ge_soft_window_set_data(GEWindow *window, void *data) {
+    window->data = data;
+    return GE_E_NONE;
+}
+
+int _ge_soft_window_cap_framerate(GEWindow *window, int cap) {
+    (void)window;
+    (void)cap;
+    return GE_E_NONE;
+}
+
+void _ge_soft_window_depth_test(GEWindow *window, int depth_test) {
+    (void)window;
+    _ge_soft.depth_test = depth_test != 0;
+}
+
+void _ge_soft_window_blending(GEWindow *window, int blend) {
+    (void)window;
+    _ge_soft.blend = blend != 0;
+}
+
+unsigned long _ge_soft_window_ms(GEWindow *window) {
+    struct timespec time;
+    (void)window;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_nsec/(unsigned long)(1e6)+time.tv_sec*1000;
+}
+
+int _ge_soft_window_key_pressed(GEWindow *window, GEKey key) {
+    if(key >= 0 && key < GE_K_AMOUNT){
+        return window->platform.keys_down[key];
+    }
+    return 0;
+}
+
+void _ge_soft_window_mainloop(GEWindow *window) {
+    unsigned long int frames = GE_SOFT_WINDOW_FRAMES;
+    unsigned long int i;
+    struct timespec start, end;
+    double ms;
+    char *env;
+    
+    env = getenv("GE_SOFT_FRAMES");
+    if(env && atol(env) > 0) frames = atol(env);
+    
+    if(window->resize != NULL){
+        window->resize(window->data, GE_SOFT_WINDOW_WIDTH,
+                       GE_SOFT_WINDOW_HEIGHT);
+    }
+    
+    _ge_soft.triangles = 0;
+    /* The monotonic clock doesn't jump when the system time changes */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(i=0;i<frames;i++){
+        if(window->draw != NULL) window->draw(window->data);
+        _ge_soft_flush();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ms = (end.tv_sec-start.tv_sec)*1e3+(end.tv_nsec-start.tv_nsec)/1e6;
+    
+    printf("Software backend: %lu frames, %lu triangles in %.3f ms "
+           "(%.0f triangles/s, %lu threads)\n", frames, _ge_soft.triangles,
+           ms, _ge_soft.triangles/(ms > 0 ? ms/1e3 : 1e-6),
+           (unsigned long int)_ge_soft.thread_num);
+    
+    env = getenv("GE_SOFT_OUTPUT");
+    if(env) _ge_soft_window_output(env);
+}
+
+void _ge_soft_window_clear(GEWindow *window, float r, float g, float b,
+                           float a) {
+    GESoftTarget *target = _ge_soft.target;
+    unsigned char color[4];
+    size_t i, size;
+    (void)window;
+    if(target == NULL) return;
+    _ge_soft_flush();
+    size = (size_t)target->width*target->height;
+    color[0] = (r < 0 ? 0 : r > 1 ? 1 : r)*255+0.5f;
+    color[1] = (g < 0 ? 0 : g > 1 ? 1 : g)*255+0.5f;
+    color[2] = (b < 0 ? 0 : b > 1 ? 1 : b)*255+0.5f;
+    color[3] = (a < 0 ? 0 : a > 1 ? 1 : a)*255+0.5f;
+    if(target->color){
+        for(i=0;i<size;i++) memcpy(target->color->color+i*4, color, 4);
+    }
+    if(target->depth){
+        for(i=0;i<size;i++) target->depth->depth[i] = 1;
+    }
+}
+
+void _ge_soft_window_view(GEWindow *window, int w, int h) {
+    (void)window;
+    _ge_soft.view_x = 0;
+    _ge_soft.view_y = 0;
+    _ge_soft.view_w = w;
+    _ge_soft.view_h = h;
+}
+
+void _ge_soft_window_free(GEWindow *window) {
+    (void)window;
+    _ge_soft_raster_free();
+    _ge_soft_texture_delete(_ge_soft.window.color);
+    _ge_soft.window.color = NULL;
+    _ge_soft_texture_delete(_ge_soft.window.depth);
+    _ge_soft.window.depth = NULL;
+    free(_ge_soft.objects);
+    _ge_soft.objects = NULL;
+    _ge_soft.object_num = 0;
+}
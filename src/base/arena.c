@@ -59,11 +59,11 @@ int ge_arena_init(GEArena *arena, size_t chunk_min) {
 
 void *ge_arena_alloc(GEArena *arena, size_t num, size_t size) {
     size_t align = arena->size%size ? size-(arena->size%size) : 0;
-    size_t new_size = arena->size+align+size*num;
+    size_t start = arena->size+align;
 
     void *new;
 
-    if(new_size > arena->chunk_size){
+    if(start+size*num > arena->chunk_size){
         size_t chunk_size = size*num > arena->chunk_min ?
                             size*num : arena->chunk_min;
 
@@ -82,12 +82,10 @@ void *ge_arena_alloc(GEArena *arena, size_t num, size_t size) {
         arena->chunk++;
         arena->chunk_size = chunk_size;
 
-        arena->size = 0;
-
-        new_size = size*num;
+        start = 0;
     }
-    new = (char*)arena->chunks[arena->chunk]+align;
-    arena->size = new_size;
+    new = (char*)arena->chunks[arena->chunk]+start;
+    arena->size = start+size*num;
     return new;
 }
 
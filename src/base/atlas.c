@@ -0,0 +1,431 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <mibiengine2/base/atlas.h>
+
+#include <mibiengine2/base/mipmap.h>
+
+#include <mibiengine2/errors.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int x, y;
+    int w, h;
+} GEAtlasSpace;
+
+typedef struct {
+    /* The index of the image */
+    size_t index;
+    /* The size of the image with its padding */
+    int w, h;
+    /* The position of the image with its padding once it is packed */
+    int x, y;
+    int rotated;
+} GEAtlasItem;
+
+/* Sort the items from the one with the longest side to the one with the
+ * shortest, as the big images are harder to fit in the space that is left */
+static int _ge_atlas_compare(const void *a, const void *b) {
+    const GEAtlasItem *item_a = a;
+    const GEAtlasItem *item_b = b;
+    int side_a = item_a->w > item_a->h ? item_a->w : item_a->h;
+    int side_b = item_b->w > item_b->h ? item_b->w : item_b->h;
+    if(side_a != side_b) return side_b-side_a;
+    if(item_a->w*item_a->h != item_b->w*item_b->h){
+        return item_b->w*item_b->h-item_a->w*item_a->h;
+    }
+    return item_a->index < item_b->index ? -1 : item_a->index > item_b->index;
+}
+
+/* _ge_atlas_score
+ *
+ * Score a free space for a rectangle with the best short side fit heuristic.
+ *
+ * space:      The free space.
+ * w:          The width of the rectangle.
+ * h:          The height of the rectangle.
+ * short_side: Set to the shortest side left free if the rectangle fits.
+ * long_side:  Set to the longest side left free if the rectangle fits.
+ * Returns 1 if the rectangle fits in the space and 0 otherwise.
+ */
+static int _ge_atlas_score(GEAtlasSpace *space, int w, int h,
+                           int *short_side, int *long_side) {
+    int left_w = space->w-w;
+    int left_h = space->h-h;
+    if(left_w < 0 || left_h < 0) return 0;
+    *short_side = left_w < left_h ? left_w : left_h;
+    *long_side = left_w < left_h ? left_h : left_w;
+    return 1;
+}
+
+/* _ge_atlas_split
+ *
+ * Split the free spaces that overlap a rectangle that got placed into the
+ * spaces that are around it, and remove the spaces contained in others.
+ *
+ * spaces:    The free spaces, that may get reallocated.
+ * space_num: The number of free spaces.
+ * used:      The rectangle that got placed.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+static int _ge_atlas_split(GEAtlasSpace **spaces, size_t *space_num,
+                           GEAtlasSpace *used) {
+    GEAtlasSpace *out;
+    GEAtlasSpace *space;
+    GEAtlasSpace *other;
+    size_t num = 0;
+    size_t i, n;
+    
+    out = malloc((*space_num*4)*sizeof(GEAtlasSpace));
+    if(out == NULL) return GE_E_OUT_OF_MEM;
+    for(i=0;i<*space_num;i++){
+        space = *spaces+i;
+        if(used->x >= space->x+space->w || used->x+used->w <= space->x ||
+           used->y >= space->y+space->h || used->y+used->h <= space->y){
+            out[num++] = *space;
+            continue;
+        }
+        if(used->x > space->x){
+            out[num] = *space;
+            out[num++].w = used->x-space->x;
+        }
+        if(used->x+used->w < space->x+space->w){
+            out[num] = *space;
+            out[num].x = used->x+used->w;
+            out[num++].w = space->x+space->w-used->x-used->w;
+        }
+        if(used->y > space->y){
+            out[num] = *space;
+            out[num++].h = used->y-space->y;
+        }
+        if(used->y+used->h < space->y+space->h){
+            out[num] = *space;
+            out[num].y = used->y+used->h;
+            out[num++].h = space->y+space->h-used->y-used->h;
+        }
+    }
+    
+    /* Remove the spaces that are inside of another one */
+    for(i=0;i<num;i++){
+        space = out+i;
+        for(n=0;n<num;n++){
+            other = out+n;
+            if(n == i) continue;
+            if(space->x >= other->x && space->y >= other->y &&
+               space->x+space->w <= other->x+other->w &&
+               space->y+space->h <= other->y+other->h){
+                out[i] = out[--num];
+                i--;
+                break;
+            }
+        }
+    }
+    
+    free(*spaces);
+    *spaces = out;
+    *space_num = num;
+    return GE_E_NONE;
+}
+
+/* _ge_atlas_pack
+ *
+ * Pack the items in an atlas of a given size with the MaxRects algorithm.
+ *
+ * items:    The items, sorted with _ge_atlas_compare.
+ * item_num: The number of items.
+ * width:    The width of the atlas.
+ * height:   The height of the atlas.
+ * rotate:   Allow rotating the items.
+ * Returns GE_E_NONE (0) on success, GE_E_ATLAS_FULL if the items don't fit
+ * or another error code on failure.
+ */
+static int _ge_atlas_pack(GEAtlasItem *items, size_t item_num, int width,
+                          int height, int rotate) {
+    GEAtlasSpace *spaces;
+    GEAtlasSpace used;
+    GEAtlasItem *item;
+    size_t space_num = 1;
+    size_t i, n;
+    size_t best;
+    int short_side, long_side;
+    int best_short, best_long;
+    int found;
+    int rc;
+    
+    spaces = malloc(sizeof(GEAtlasSpace));
+    if(spaces == NULL) return GE_E_OUT_OF_MEM;
+    spaces->x = spaces->y = 0;
+    spaces->w = width;
+    spaces->h = height;
+    
+    for(i=0;i<item_num;i++){
+        item = items+i;
+        found = 0;
+        best = 0;
+        best_short = best_long = 0;
+        for(n=0;n<space_num;n++){
+            if(_ge_atlas_score(spaces+n, item->w, item->h, &short_side,
+                               &long_side) &&
+               (!found || short_side < best_short ||
+                (short_side == best_short && long_side < best_long))){
+                found = 1;
+                best = n;
+                best_short = short_side;
+                best_long = long_side;
+                item->rotated = 0;
+            }
+            if(rotate && item->w != item->h &&
+               _ge_atlas_score(spaces+n, item->h, item->w, &short_side,
+                               &long_side) &&
+               (!found || short_side < best_short ||
+                (short_side == best_short && long_side < best_long))){
+                found = 1;
+                best = n;
+                best_short = short_side;
+                best_long = long_side;
+                item->rotated = 1;
+            }
+        }
+        if(!found){
+            free(spaces);
+            return GE_E_ATLAS_FULL;
+        }
+        item->x = used.x = spaces[best].x;
+        item->y = used.y = spaces[best].y;
+        used.w = item->rotated ? item->h : item->w;
+        used.h = item->rotated ? item->w : item->h;
+        rc = _ge_atlas_split(&spaces, &space_num, &used);
+        if(rc){
+            free(spaces);
+            return rc;
+        }
+    }
+    
+    free(spaces);
+    return GE_E_NONE;
+}
+
+/* _ge_atlas_copy
+ *
+ * Copy an image to the atlas, and fill its padding with the pixels on its
+ * edges.
+ *
+ * atlas:   The image of the atlas.
+ * pixels:  The RGBA pixels of the image, starting from its top row.
+ * item:    The item of the image, once it is packed.
+ * padding: The padding around the image.
+ * width:   The width of the image.
+ * height:  The height of the image.
+ */
+static void _ge_atlas_copy(GEImage *atlas, unsigned char *pixels,
+                           GEAtlasItem *item, int padding, int width,
+                           int height) {
+    int x, y;
+    int lx, ly;
+    int w = item->rotated ? height : width;
+    int h = item->rotated ? width : height;
+    unsigned char *src;
+    
+    for(y=0;y<h+padding*2;y++){
+        ly = y-padding;
+        ly = ly < 0 ? 0 : ly >= h ? h-1 : ly;
+        for(x=0;x<w+padding*2;x++){
+            lx = x-padding;
+            lx = lx < 0 ? 0 : lx >= w ? w-1 : lx;
+            /* Rotated images are turned by 90 degrees clockwise */
+            if(item->rotated){
+                src = pixels+((size_t)(height-1-lx)*width+ly)*4;
+            }else{
+                src = pixels+((size_t)ly*width+lx)*4;
+            }
+            memcpy(GE_IMAGE_GET_PIXEL_PTR(atlas, item->x+x, item->y+y), src,
+                   4);
+        }
+    }
+}
+
+int ge_atlas_init(GEAtlas *atlas, GEImage **images, size_t image_num,
+                  int padding, int rotate, int max_size, int linear,
+                  int flip) {
+    GEAtlasItem *items;
+    GEAtlasItem *item;
+    GEAtlasRect *rect;
+    GEImage image;
+    unsigned char *pixels = NULL;
+    size_t pixels_size = 0;
+    size_t size;
+    size_t area = 0;
+    size_t i;
+    int width = 1, height = 1;
+    int w, h;
+    int rc;
+    
+    atlas->rects = malloc((image_num ? image_num : 1)*sizeof(GEAtlasRect));
+    if(atlas->rects == NULL) return GE_E_OUT_OF_MEM;
+    items = malloc((image_num ? image_num : 1)*sizeof(GEAtlasItem));
+    if(items == NULL){
+        free(atlas->rects);
+        return GE_E_OUT_OF_MEM;
+    }
+    atlas->rect_num = image_num;
+    
+    /* Start with the smallest size that has enough space for the images */
+    for(i=0;i<image_num;i++){
+        items[i].index = i;
+        items[i].w = images[i]->width+padding*2;
+        items[i].h = images[i]->height+padding*2;
+        items[i].rotated = 0;
+        area += (size_t)items[i].w*items[i].h;
+        w = items[i].w;
+        h = items[i].h;
+        if(rotate){
+            /* The shortest side has to fit in any case */
+            w = h = w < h ? w : h;
+        }
+        while(width < w) width *= 2;
+        while(height < h) height *= 2;
+    }
+    while((size_t)width*height < area){
+        if(width <= height) width *= 2;
+        else height *= 2;
+    }
+    qsort(items, image_num, sizeof(GEAtlasItem), _ge_atlas_compare);
+    
+    /* Grow the atlas until all of the images fit in it */
+    while(1){
+        if(width > max_size || height > max_size){
+            rc = GE_E_ATLAS_FULL;
+            break;
+        }
+        rc = _ge_atlas_pack(items, image_num, width, height, rotate);
+        if(rc != GE_E_ATLAS_FULL) break;
+        if((width <= height && width*2 <= max_size) || height*2 > max_size){
+            width *= 2;
+        }else{
+            height *= 2;
+        }
+    }
+    if(rc){
+        free(items);
+        free(atlas->rects);
+        return rc;
+    }
+    
+    rc = ge_image_empty(&image, width, height);
+    if(rc){
+        free(items);
+        free(atlas->rects);
+        return rc;
+    }
+    for(i=0;i<image_num;i++){
+        item = items+i;
+        w = images[item->index]->width;
+        h = images[item->index]->height;
+        if(!w || !h) continue;
+        size = (size_t)w*h*4;
+        if(size > pixels_size){
+            free(pixels);
+            pixels = malloc(size);
+            if(pixels == NULL){
+                ge_image_free(&image);
+                free(items);
+                free(atlas->rects);
+                return GE_E_OUT_OF_MEM;
+            }
+            pixels_size = size;
+        }
+        memset(pixels, 0, size);
+        ge_image_copy_texture(images[item->index], pixels, w, h, 0);
+        _ge_atlas_copy(&image, pixels, item, padding, w, h);
+    }
+    free(pixels);
+    
+    for(i=0;i<image_num;i++){
+        item = items+i;
+        rect = atlas->rects+item->index;
+        rect->x = item->x+padding;
+        rect->y = item->y+padding;
+        rect->w = images[item->index]->width;
+        rect->h = images[item->index]->height;
+        rect->rotated = item->rotated;
+        rect->flip = flip;
+        w = rect->rotated ? rect->h : rect->w;
+        h = rect->rotated ? rect->w : rect->h;
+        rect->u1 = rect->x/(float)width;
+        rect->u2 = (rect->x+w)/(float)width;
+        if(flip){
+            rect->v1 = 1-(rect->y+h)/(float)height;
+            rect->v2 = 1-rect->y/(float)height;
+        }else{
+            rect->v1 = rect->y/(float)height;
+            rect->v2 = (rect->y+h)/(float)height;
+        }
+    }
+    free(items);
+    
+    atlas->width = width;
+    atlas->height = height;
+    rc = ge_texture_init(&atlas->texture, &image, linear, flip,
+                         GE_MIPMAP_NONE);
+    ge_image_free(&image);
+    if(rc){
+        free(atlas->rects);
+        return rc;
+    }
+    return GE_E_NONE;
+}
+
+void ge_atlas_uv(GEAtlasRect *rect, float u, float v, float *out) {
+    float du = rect->u2-rect->u1;
+    float dv = rect->v2-rect->v1;
+    if(!rect->rotated){
+        out[0] = rect->u1+u*du;
+        out[1] = rect->v1+v*dv;
+    }else if(rect->flip){
+        out[0] = rect->u1+v*du;
+        out[1] = rect->v1+(1-u)*dv;
+    }else{
+        out[0] = rect->u1+(1-v)*du;
+        out[1] = rect->v1+u*dv;
+    }
+}
+
+void ge_atlas_free(GEAtlas *atlas) {
+    ge_texture_free(&atlas->texture);
+    free(atlas->rects);
+    atlas->rects = NULL;
+    atlas->rect_num = 0;
+}
@@ -33,147 +33,704 @@
  */
 
 #include <mibiengine2/base/deflate.h>
+#include <mibiengine2/base/utils.h>
 #include <mibiengine2/errors.h>
 
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include <stdio.h>
 
+#define _GE_DEFLATE_BITBUF_SIZE (sizeof(unsigned long int)*CHAR_BIT)
+
+/* Initial size of the output buffer */
+#define _GE_DEFLATE_OUTPUT_MIN 4096
+
+/* Longest match */
+#define _GE_DEFLATE_MATCH_MAX 258
+/* Bytes that may be written after the end of a match when copying it 8 bytes
+ * at a time */
+#define _GE_DEFLATE_MATCH_SLACK 8
+
+static const unsigned short _ge_deflate_length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+    67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const unsigned char _ge_deflate_length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5,
+    5, 5, 5, 0
+};
+
+static const unsigned short _ge_deflate_dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513,
+    769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const unsigned char _ge_deflate_dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10,
+    11, 11, 12, 12, 13, 13
+};
+
+/* Order in which the code lengths of the code length alphabet are stored */
+static const unsigned char _ge_deflate_clen_order[GE_DEFLATE_CLEN_NUM] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
 int ge_deflate_init(GEDeflate *deflate) {
     deflate->output = NULL;
     deflate->output_size = 0;
-    deflate->cur = 0;
+    deflate->output_cap = 0;
+    deflate->window_size = GE_DEFLATE_WINDOW_MAX;
+    deflate->user_output = 0;
+    deflate->flush = NULL;
+    deflate->flush_data = NULL;
+    deflate->flushed = 0;
+    deflate->check = 1;
     deflate->header_found = 0;
     deflate->adler32_found = 0;
     deflate->bits_left = 0;
-    deflate->new_block = 1;
+    deflate->bits = 0;
+    deflate->state = GE_DEFLATE_S_HEADER;
     deflate->last_block = 0;
     deflate->blocks_finished = 0;
+    deflate->fixed_tables = 0;
+    deflate->index = 0;
+    deflate->length = 0;
+    deflate->stored_left = 0;
     return GE_E_NONE;
 }
 
-#define _GE_DEFLATE_READ_BITS(out, num) \
-    { \
-        out = deflate->bits&((1<<num)-1); \
-        deflate->bits >>= num; \
-        deflate->bits_left -= num; \
+int ge_deflate_set_output(GEDeflate *deflate, unsigned char *buffer,
+                          size_t size, GEDeflateFlush *flush, void *data) {
+    if(flush != NULL && size < GE_DEFLATE_WINDOW_MIN){
+        return GE_E_INVALID_WINDOW_SIZE;
     }
+    if(!deflate->user_output) free(deflate->output);
+    deflate->output = buffer;
+    deflate->output_size = 0;
+    deflate->output_cap = size;
+    deflate->user_output = 1;
+    deflate->flush = flush;
+    deflate->flush_data = data;
+    deflate->flushed = 0;
+    return GE_E_NONE;
+}
 
-int ge_deflate_decompress(GEDeflate *deflate, unsigned char *data,
-                          size_t size) {
-    size_t i = 0;
-    if(!deflate->cur){
-        /* The data is too small */
-        if(size-i < 1) return GE_E_NONE;
-        /* Read the compression method and compression info byte */
-        /* Get the 4 first bits */
-        deflate->cmf = data[i];
-        deflate->compression.method = data[i]&0xF;
-        if(deflate->compression.method != 8){
-            fputs("Unsupported compression method!\n", stderr);
-            return GE_E_UNSUPPORTED_COMPRESSION;
+/* _ge_deflate_huffman
+ *
+ * Build the decoding tables of a canonical huffman code.
+ *
+ * huffman: The tables to fill.
+ * lengths: The code length of each symbol, 0 if the symbol is unused.
+ * num: The number of symbols.
+ * Returns 0 on success or GE_E_INVALID_HUFFMAN_CODE if there are too many
+ * codes of some length. Incomplete codes are allowed.
+ */
+static int _ge_deflate_huffman(GEDeflateHuffman *huffman,
+                               unsigned char *lengths, unsigned int num) {
+    unsigned short offsets[GE_DEFLATE_MAX_BITS+1];
+    unsigned int next[GE_DEFLATE_MAX_BITS+1];
+    unsigned int sym, len, code, rev, i;
+    long int left = 1;
+    
+    memset(huffman->count, 0, sizeof(huffman->count));
+    memset(huffman->fast, 0, sizeof(huffman->fast));
+    for(sym=0;sym<num;sym++){
+        huffman->count[lengths[sym]]++;
+    }
+    huffman->count[0] = 0;
+    
+    for(len=1;len<=GE_DEFLATE_MAX_BITS;len++){
+        left <<= 1;
+        left -= huffman->count[len];
+        if(left < 0){
+            return GE_E_INVALID_HUFFMAN_CODE;
         }
-        /* Get the 4 last bits */
-        deflate->compression.info = (data[i]>>8);
-        deflate->window_size = 1<<(deflate->compression.info+8);
-        if(deflate->compression.info > 7){
-            fputs("Invalid window size!\n", stderr);
-            /* The current ZLIB specification doesn't allow window sizes bigger
-             * than 7. */
-            return GE_E_INVALID_WINDOW_SIZE;
+    }
+    
+    /* Sort the symbols by code */
+    offsets[1] = 0;
+    for(len=1;len<GE_DEFLATE_MAX_BITS;len++){
+        offsets[len+1] = offsets[len]+huffman->count[len];
+    }
+    for(sym=0;sym<num;sym++){
+        if(lengths[sym]) huffman->symbol[offsets[lengths[sym]]++] = sym;
+    }
+    
+    /* Assign the codes and fill the lookup table with the short ones. The
+     * codes are stored starting at their most significant bit, so they are
+     * reversed to index the table with the bits as they come. */
+    code = 0;
+    next[0] = 0;
+    for(len=1;len<=GE_DEFLATE_MAX_BITS;len++){
+        code = (code+huffman->count[len-1])<<1;
+        next[len] = code;
+    }
+    for(sym=0;sym<num;sym++){
+        len = lengths[sym];
+        if(!len || len > GE_DEFLATE_FAST_BITS) continue;
+        code = next[len]++;
+        rev = 0;
+        for(i=0;i<len;i++){
+            rev = (rev<<1)|((code>>i)&1);
         }
-        printf("LZ77 window size: %lu\n", deflate->window_size);
-        deflate->cur++;
-        i++;
-    }
-    if(deflate->cur == 1){
-        /* The data is too small */
-        if(size-i < 1) return GE_E_NONE;
-        /* Read the flags */
-        /* Get the 6th bit */
-        deflate->has_dict = data[i]&(1<<5);
-        /* Get the last two bits */
-        deflate->compression.level = data[i]&((1<<6)|(1<<7));
-        deflate->dict_check = 0;
-        deflate->cur++;
-        i++;
-    }
-    if(deflate->cur >= 2 && deflate->cur < 6 && deflate->has_dict){
-        /* Read the dictionary Adler-32 checksum */
-        for(;deflate->cur<6;deflate->cur++,i++){
-            /* The data is too small */
-            if(size-i < 1) return GE_E_NONE;
-            deflate->dict_check |= data[i]<<((deflate->cur-1)*8);
+        for(i=rev;i<(1<<GE_DEFLATE_FAST_BITS);i+=1<<len){
+            huffman->fast[i] = (sym<<4)|len;
         }
     }
-    /* Decompress the data */
-    if((deflate->cur >= 2 && !deflate->has_dict) ||
-       (deflate->cur >= 6 && deflate->has_dict)){
-        /* Read the data */
-        while(i < size){
-            while(deflate->bits_left < 8){
-                if(size-i < 1) return GE_E_NONE;
-                deflate->bits |= data[i]<<deflate->bits_left;
-                i++;
-                deflate->cur++;
-                deflate->bits_left += 8;
-            }
-#if 0
-            /* Only for testing */
-            if(deflate->bits&1) fputs("1", stdout);
-            else fputs("0", stdout);
-            deflate->bits >>= 1;
-            deflate->bits_left--;
-#endif
-            if(deflate->new_block){
-                if(deflate->last_block){
-                    /* The data was entirely decoded */
-                    deflate->blocks_finished = 1;
-                    break;
+    
+    return GE_E_NONE;
+}
+
+/* _ge_deflate_decode_slow
+ *
+ * Decode a symbol whose code is longer than GE_DEFLATE_FAST_BITS one bit at a
+ * time.
+ *
+ * huffman: The huffman code.
+ * bits: The next bits of the input, at least GE_DEFLATE_MAX_BITS of them.
+ * len: Used to return the length of the code.
+ * Returns the decoded symbol or -1 if the bits don't form a valid code.
+ */
+static int _ge_deflate_decode_slow(GEDeflateHuffman *huffman,
+                                   unsigned long int bits,
+                                   unsigned int *len) {
+    long int code = 0;
+    long int first = 0;
+    long int index = 0;
+    long int count;
+    unsigned int i;
+    
+    for(i=1;i<=GE_DEFLATE_MAX_BITS;i++){
+        code |= bits&1;
+        bits >>= 1;
+        count = huffman->count[i];
+        if(code-count < first){
+            *len = i;
+            return huffman->symbol[index+(code-first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    
+    return -1;
+}
+
+/* _ge_deflate_flush
+ *
+ * Add the data that was decoded since the last flush to the checksum and pass
+ * it to the flush callback.
+ *
+ * deflate: The decoder.
+ * Returns 0 on success or the value returned by the callback.
+ */
+static int _ge_deflate_flush(GEDeflate *deflate) {
+    unsigned char *data = deflate->output+deflate->flushed;
+    size_t size = deflate->output_size-deflate->flushed;
+    
+    if(!size) return GE_E_NONE;
+    deflate->check = ge_utils_adler32_update(deflate->check, data, size);
+    deflate->flushed = deflate->output_size;
+    if(deflate->flush != NULL){
+        return deflate->flush(deflate->flush_data, data, size);
+    }
+    
+    return GE_E_NONE;
+}
+
+/* _ge_deflate_reserve
+ *
+ * Make room for more decompressed data, by growing the output buffer or by
+ * flushing the window and only keeping the data matches can refer to.
+ *
+ * deflate: The decoder.
+ * num: The number of bytes that will be written.
+ * Returns 0 on success or an error code if there is not enough space.
+ */
+static int _ge_deflate_reserve(GEDeflate *deflate, size_t num) {
+    size_t cap;
+    unsigned char *new;
+    int rc;
+    
+    if(deflate->output_size+num <= deflate->output_cap) return GE_E_NONE;
+    
+    if(deflate->flush != NULL){
+        /* Slide the window */
+        rc = _ge_deflate_flush(deflate);
+        if(rc) return rc;
+        if(deflate->output_size > GE_DEFLATE_WINDOW_MAX){
+            memmove(deflate->output, deflate->output+deflate->output_size-
+                    GE_DEFLATE_WINDOW_MAX, GE_DEFLATE_WINDOW_MAX);
+            deflate->output_size = GE_DEFLATE_WINDOW_MAX;
+            deflate->flushed = GE_DEFLATE_WINDOW_MAX;
+        }
+        if(deflate->output_size+num <= deflate->output_cap) return GE_E_NONE;
+    }
+    if(deflate->user_output){
+        fputs("Decompressed data too big!\n", stderr);
+        return GE_E_OUTPUT_FULL;
+    }
+    
+    cap = deflate->output_cap ? deflate->output_cap : _GE_DEFLATE_OUTPUT_MIN;
+    while(cap < deflate->output_size+num) cap *= 2;
+    
+    new = realloc(deflate->output, cap);
+    if(new == NULL){
+        return GE_E_OUT_OF_MEM;
+    }
+    deflate->output = new;
+    deflate->output_cap = cap;
+    
+    return GE_E_NONE;
+}
+
+/* Fill the bit buffer. Once the input runs out it is padded with zero bytes,
+ * reading into the padding means that more input is needed. */
+#define _GE_DEFLATE_FILL() \
+    { \
+        while(bits_left <= _GE_DEFLATE_BITBUF_SIZE-8){ \
+            if(in_pos < size){ \
+                bits |= (unsigned long int)data[in_pos++]<<bits_left; \
+            }else{ \
+                pad += 8; \
+            } \
+            bits_left += 8; \
+        } \
+    }
+
+#define _GE_DEFLATE_NEED(num) \
+    { \
+        if(bits_left < (num)) _GE_DEFLATE_FILL(); \
+    }
+
+#define _GE_DEFLATE_READ_BITS(out, num) \
+    { \
+        _GE_DEFLATE_NEED(num); \
+        out = bits&((1UL<<(num))-1); \
+        bits >>= (num); \
+        bits_left -= (num); \
+    }
+
+/* Skip to the next byte boundary */
+#define _GE_DEFLATE_ALIGN() \
+    { \
+        bits >>= bits_left&7; \
+        bits_left &= ~7U; \
+    }
+
+/* Each step of the decoding reads at most 28 bits, so that the input left
+ * when it is interrupted always fits in the bit buffer. The step is then
+ * decoded again from the saved state on the next call. */
+#define _GE_DEFLATE_SAVE() \
+    { \
+        saved_bits = bits; \
+        saved_left = bits_left-pad; \
+        saved_pos = in_pos; \
+    }
+
+#define _GE_DEFLATE_OVERRUN() (bits_left < pad)
+
+#define _GE_DEFLATE_CHECK() \
+    { \
+        if(_GE_DEFLATE_OVERRUN()) goto SUSPEND; \
+    }
+
+/* Invalid data may just be the padding, in which case the step is decoded
+ * again once the rest of it is available. */
+#define _GE_DEFLATE_ERROR(rc) \
+    { \
+        _GE_DEFLATE_CHECK(); \
+        fputs("Invalid compressed data!\n", stderr); \
+        return rc; \
+    }
+
+#define _GE_DEFLATE_DECODE(huffman, out) \
+    { \
+        unsigned int _entry; \
+        _GE_DEFLATE_NEED(GE_DEFLATE_MAX_BITS); \
+        _entry = (huffman)->fast[bits&((1<<GE_DEFLATE_FAST_BITS)-1)]; \
+        if(_entry){ \
+            out = _entry>>4; \
+            len = _entry&0xF; \
+        }else{ \
+            out = _ge_deflate_decode_slow(huffman, bits, &len); \
+            if(out < 0) _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE); \
+        } \
+        bits >>= len; \
+        bits_left -= len; \
+    }
+
+#define _GE_DEFLATE_RESERVE(num) \
+    { \
+        if(out_size+(num) > out_cap){ \
+            deflate->output_size = out_size; \
+            rc = _ge_deflate_reserve(deflate, num); \
+            if(rc) return rc; \
+            out = deflate->output; \
+            out_size = deflate->output_size; \
+            out_cap = deflate->output_cap; \
+        } \
+    }
+
+int ge_deflate_decompress(GEDeflate *deflate, unsigned char *data,
+                          size_t size) {
+    unsigned char *out = deflate->output;
+    size_t out_size = deflate->output_size;
+    size_t out_cap = deflate->output_cap;
+    size_t in_pos = 0;
+    size_t saved_pos = 0;
+    unsigned long int bits = deflate->bits;
+    unsigned long int saved_bits = bits;
+    unsigned int bits_left = deflate->bits_left;
+    unsigned int saved_left = bits_left;
+    unsigned int pad = 0;
+    unsigned int state = deflate->state;
+    unsigned int length = deflate->length;
+    unsigned int len;
+    unsigned int i, n, rep;
+    unsigned int dist;
+    unsigned int header;
+    size_t copy;
+    int sym;
+    int rc;
+    unsigned char *dst, *src;
+    
+    for(;;){
+        switch(state){
+            case GE_DEFLATE_S_HEADER:
+                _GE_DEFLATE_SAVE();
+                _GE_DEFLATE_READ_BITS(deflate->cmf, 8);
+                _GE_DEFLATE_READ_BITS(header, 8);
+                _GE_DEFLATE_CHECK();
+                deflate->compression.method = deflate->cmf&0xF;
+                deflate->compression.info = deflate->cmf>>4;
+                deflate->has_dict = header&(1<<5);
+                deflate->compression.level = header>>6;
+                if(((unsigned int)deflate->cmf<<8|header)%31){
+                    fputs("Invalid ZLIB header!\n", stderr);
+                    return GE_E_INVALID_ZLIB_HEADER;
                 }
+                if(deflate->compression.method != 8 || deflate->has_dict){
+                    fputs("Unsupported compression method!\n", stderr);
+                    return GE_E_UNSUPPORTED_COMPRESSION;
+                }
+                if(deflate->compression.info > 7){
+                    fputs("Invalid window size!\n", stderr);
+                    /* The current ZLIB specification doesn't allow window
+                     * sizes bigger than 7. */
+                    return GE_E_INVALID_WINDOW_SIZE;
+                }
+                deflate->window_size = 1<<(deflate->compression.info+8);
+                deflate->header_found = 1;
+                state = GE_DEFLATE_S_BLOCK;
+                break;
+            case GE_DEFLATE_S_BLOCK:
                 /* See if it is the last block and get its type */
-                _GE_DEFLATE_READ_BITS(deflate->last_block, 1);
-                _GE_DEFLATE_READ_BITS(deflate->block_type, 2);
-                printf("Block found: last block = %u, block type = %u\n",
-                       deflate->last_block, deflate->block_type);
-                deflate->new_block = 0;
-                deflate->read = 0;
-            }else{
-                switch(deflate->block_type){
+                _GE_DEFLATE_SAVE();
+                _GE_DEFLATE_READ_BITS(n, 1);
+                _GE_DEFLATE_READ_BITS(i, 2);
+                _GE_DEFLATE_CHECK();
+                deflate->last_block = n;
+                switch(i){
                     case 0:
                         /* No compression */
-                        /* Read the length of the data to be read */
-                        i--;
-                        /* The bits should be reloaded once the end of the data
-                         * has been reached */
-                        /**/
+                        _GE_DEFLATE_ALIGN();
+                        state = GE_DEFLATE_S_STORED_LEN;
                         break;
                     case 1:
                         /* Compression with fixed huffman codes */
+                        if(!deflate->fixed_tables){
+                            for(i=0;i<144;i++) deflate->lengths[i] = 8;
+                            for(;i<256;i++) deflate->lengths[i] = 9;
+                            for(;i<280;i++) deflate->lengths[i] = 7;
+                            for(;i<GE_DEFLATE_LITLEN_NUM;i++){
+                                deflate->lengths[i] = 8;
+                            }
+                            _ge_deflate_huffman(&deflate->litlen,
+                                                deflate->lengths,
+                                                GE_DEFLATE_LITLEN_NUM);
+                            for(i=0;i<GE_DEFLATE_DIST_NUM;i++){
+                                deflate->lengths[i] = 5;
+                            }
+                            _ge_deflate_huffman(&deflate->dist,
+                                                deflate->lengths,
+                                                GE_DEFLATE_DIST_NUM);
+                            deflate->fixed_tables = 1;
+                        }
+                        state = GE_DEFLATE_S_LITLEN;
                         break;
                     case 2:
                         /* Compression with dynamic huffman codes */
+                        state = GE_DEFLATE_S_TABLE;
                         break;
                     default:
                         /* block_type 3 is reserved */
                         fputs("Invalid block type!\n", stderr);
                         return GE_E_INVALID_BLOCK_TYPE;
                 }
-            }
+                break;
+            case GE_DEFLATE_S_STORED_LEN:
+                _GE_DEFLATE_SAVE();
+                _GE_DEFLATE_READ_BITS(deflate->stored_left, 16);
+                _GE_DEFLATE_READ_BITS(n, 16);
+                _GE_DEFLATE_CHECK();
+                if((deflate->stored_left^n) != 0xFFFF){
+                    fputs("Invalid stored block length!\n", stderr);
+                    return GE_E_INVALID_STORED_LENGTH;
+                }
+                state = GE_DEFLATE_S_STORED;
+                break;
+            case GE_DEFLATE_S_STORED:
+                /* Empty the bit buffer first, it only contains whole bytes */
+                while(deflate->stored_left && bits_left > pad){
+                    _GE_DEFLATE_RESERVE(1);
+                    out[out_size++] = bits&0xFF;
+                    bits >>= 8;
+                    bits_left -= 8;
+                    deflate->stored_left--;
+                }
+                if(deflate->stored_left){
+                    /* Then read the data directly from the input */
+                    bits = 0;
+                    bits_left = 0;
+                    pad = 0;
+                    while(deflate->stored_left && in_pos < size){
+                        copy = size-in_pos;
+                        if(copy > deflate->stored_left){
+                            copy = deflate->stored_left;
+                        }
+                        if(copy > _GE_DEFLATE_MATCH_MAX){
+                            copy = _GE_DEFLATE_MATCH_MAX;
+                        }
+                        _GE_DEFLATE_RESERVE(copy);
+                        memcpy(out+out_size, data+in_pos, copy);
+                        out_size += copy;
+                        in_pos += copy;
+                        deflate->stored_left -= copy;
+                    }
+                    if(deflate->stored_left){
+                        _GE_DEFLATE_SAVE();
+                        goto SUSPEND;
+                    }
+                }
+                state = deflate->last_block ? GE_DEFLATE_S_CHECK :
+                                              GE_DEFLATE_S_BLOCK;
+                break;
+            case GE_DEFLATE_S_TABLE:
+                _GE_DEFLATE_SAVE();
+                _GE_DEFLATE_READ_BITS(deflate->hlit, 5);
+                _GE_DEFLATE_READ_BITS(deflate->hdist, 5);
+                _GE_DEFLATE_READ_BITS(deflate->hclen, 4);
+                _GE_DEFLATE_CHECK();
+                deflate->hlit += 257;
+                deflate->hdist += 1;
+                deflate->hclen += 4;
+                if(deflate->hlit > 286 || deflate->hdist > 30){
+                    _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                }
+                memset(deflate->lengths, 0, GE_DEFLATE_CLEN_NUM);
+                deflate->index = 0;
+                deflate->fixed_tables = 0;
+                state = GE_DEFLATE_S_CLEN;
+                break;
+            case GE_DEFLATE_S_CLEN:
+                /* Read the code used to compress the code lengths. The
+                 * distance table is only used as temporary storage. */
+                while(deflate->index < deflate->hclen){
+                    _GE_DEFLATE_SAVE();
+                    _GE_DEFLATE_READ_BITS(n, 3);
+                    _GE_DEFLATE_CHECK();
+                    i = _ge_deflate_clen_order[deflate->index++];
+                    deflate->lengths[i] = n;
+                }
+                if(_ge_deflate_huffman(&deflate->dist, deflate->lengths,
+                                       GE_DEFLATE_CLEN_NUM)){
+                    _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                }
+                deflate->index = 0;
+                state = GE_DEFLATE_S_LENGTHS;
+                break;
+            case GE_DEFLATE_S_LENGTHS:
+                /* Read the code lengths */
+                n = deflate->hlit+deflate->hdist;
+                while(deflate->index < n){
+                    _GE_DEFLATE_SAVE();
+                    _GE_DEFLATE_DECODE(&deflate->dist, sym);
+                    i = deflate->index;
+                    if(sym < 16){
+                        _GE_DEFLATE_CHECK();
+                        deflate->lengths[deflate->index++] = sym;
+                        continue;
+                    }
+                    if(sym == 16){
+                        if(!i) _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                        _GE_DEFLATE_READ_BITS(rep, 2);
+                        rep += 3;
+                        len = deflate->lengths[i-1];
+                    }else if(sym == 17){
+                        _GE_DEFLATE_READ_BITS(rep, 3);
+                        rep += 3;
+                        len = 0;
+                    }else{
+                        _GE_DEFLATE_READ_BITS(rep, 7);
+                        rep += 11;
+                        len = 0;
+                    }
+                    _GE_DEFLATE_CHECK();
+                    if(i+rep > n){
+                        _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                    }
+                    memset(deflate->lengths+i, len, rep);
+                    deflate->index += rep;
+                }
+                
+                /* The end of block code is required */
+                if(!deflate->lengths[256]){
+                    _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                }
+                if(_ge_deflate_huffman(&deflate->litlen, deflate->lengths,
+                                       deflate->hlit) ||
+                   _ge_deflate_huffman(&deflate->dist,
+                                       deflate->lengths+deflate->hlit,
+                                       deflate->hdist)){
+                    _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                }
+                state = GE_DEFLATE_S_LITLEN;
+                break;
+            case GE_DEFLATE_S_LITLEN:
+            case GE_DEFLATE_S_DIST:
+                /* Decode the compressed data */
+                for(;;){
+                    if(state == GE_DEFLATE_S_LITLEN){
+                        _GE_DEFLATE_SAVE();
+                        _GE_DEFLATE_DECODE(&deflate->litlen, sym);
+                        if(sym < 256){
+                            _GE_DEFLATE_CHECK();
+                            if(out_size >= out_cap) _GE_DEFLATE_RESERVE(1);
+                            out[out_size++] = sym;
+                            continue;
+                        }
+                        if(sym == 256){
+                            /* End of block */
+                            _GE_DEFLATE_CHECK();
+                            break;
+                        }
+                        
+                        sym -= 257;
+                        if(sym >= 29){
+                            _GE_DEFLATE_ERROR(GE_E_INVALID_HUFFMAN_CODE);
+                        }
+                        n = _ge_deflate_length_extra[sym];
+                        _GE_DEFLATE_NEED(n);
+                        length = _ge_deflate_length_base[sym]+
+                                 (bits&((1UL<<n)-1));
+                        bits >>= n;
+                        bits_left -= n;
+                        _GE_DEFLATE_CHECK();
+                        state = GE_DEFLATE_S_DIST;
+                    }
+                    
+                    _GE_DEFLATE_SAVE();
+                    _GE_DEFLATE_DECODE(&deflate->dist, sym);
+                    if(sym >= 30) _GE_DEFLATE_ERROR(GE_E_INVALID_DISTANCE);
+                    n = _ge_deflate_dist_extra[sym];
+                    _GE_DEFLATE_NEED(n);
+                    dist = _ge_deflate_dist_base[sym]+(bits&((1UL<<n)-1));
+                    bits >>= n;
+                    bits_left -= n;
+                    _GE_DEFLATE_CHECK();
+                    
+                    /* Copy the match */
+                    _GE_DEFLATE_RESERVE(length);
+                    if(dist > out_size){
+                        fputs("Invalid distance!\n", stderr);
+                        return GE_E_INVALID_DISTANCE;
+                    }
+                    dst = out+out_size;
+                    src = dst-dist;
+                    if(dist >= 8 &&
+                       out_cap-out_size >= length+_GE_DEFLATE_MATCH_SLACK){
+                        /* The 8 byte blocks never overlap, the bytes written
+                         * past the end of the match are overwritten
+                         * later. */
+                        for(i=0;i<length;i+=8){
+                            memcpy(dst+i, src+i, 8);
+                        }
+                    }else if(dist == 1){
+                        memset(dst, *src, length);
+                    }else{
+                        for(i=0;i<length;i++){
+                            dst[i] = src[i];
+                        }
+                    }
+                    out_size += length;
+                    state = GE_DEFLATE_S_LITLEN;
+                }
+                if(deflate->last_block){
+                    /* The Adler-32 checksum starts at the next byte */
+                    _GE_DEFLATE_ALIGN();
+                    deflate->blocks_finished = 1;
+                    state = GE_DEFLATE_S_CHECK;
+                }else{
+                    state = GE_DEFLATE_S_BLOCK;
+                }
+                break;
+            case GE_DEFLATE_S_CHECK:
+                /* Read the Adler-32 checksum of the decompressed data */
+                deflate->blocks_finished = 1;
+                _GE_DEFLATE_SAVE();
+                deflate->adler32 = 0;
+                for(i=0;i<4;i++){
+                    _GE_DEFLATE_READ_BITS(n, 8);
+                    deflate->adler32 = deflate->adler32<<8|n;
+                }
+                _GE_DEFLATE_CHECK();
+                deflate->adler32_found = 1;
+                state = GE_DEFLATE_S_DONE;
+                break;
+            default:
+                /* Ignore anything after the end of the stream */
+                bits = 0;
+                bits_left = 0;
+                pad = 0;
+                _GE_DEFLATE_SAVE();
+                saved_pos = size;
+                goto SUSPEND;
         }
     }
-#if 0
-    /* Only for testing */
-    puts("");
-#endif
     
-    if(deflate->blocks_finished){
-        /* Check the integrity of the data with the Adler-32 checksum. */
-        /* TODO */
+SUSPEND:
+    /* All the input has been read: go back to the start of the interrupted
+     * step and keep the bits it has read so far */
+    bits = saved_bits;
+    bits_left = saved_left;
+    for(;saved_pos<size && bits_left<=_GE_DEFLATE_BITBUF_SIZE-8;saved_pos++){
+        bits |= (unsigned long int)data[saved_pos]<<bits_left;
+        bits_left += 8;
+    }
+    deflate->bits = bits;
+    deflate->bits_left = bits_left;
+    deflate->state = state;
+    deflate->length = length;
+    deflate->output_size = out_size;
+    
+    rc = _ge_deflate_flush(deflate);
+    if(rc) return rc;
+    
+    if(deflate->adler32_found && deflate->check != deflate->adler32){
+        /* The data is corrupted */
+        fputs("Invalid Adler-32 checksum!\n", stderr);
+        return GE_E_CHECKSUM;
     }
     return GE_E_NONE;
 }
 
 void ge_deflate_free(GEDeflate *deflate) {
-    /* TODO */
-    (void)deflate;
+    if(!deflate->user_output) free(deflate->output);
+    deflate->output = NULL;
+    deflate->output_size = 0;
+    deflate->output_cap = 0;
 }
-
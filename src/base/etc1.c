@@ -0,0 +1,601 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <mibiengine2/base/etc1.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <mibiengine2/config.h>
+
+#if GE_ETC1_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define _GE_ETC1_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _GE_ETC1_NEON 1
+#endif
+
+/* The minimum number of rows of blocks encoded by each thread */
+#define _GE_ETC1_ROWS_MIN 8
+
+/* The modifiers of each table, pixel indices 0 and 1 add them to the color
+ * of the subblock and pixel indices 2 and 3 subtract them. */
+static const int _ge_etc1_tables[8][2] = {
+    {2, 8}, {5, 17}, {9, 29}, {13, 42},
+    {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+/* The 8 pixels of a subblock, as floats to compute the errors with SIMD
+ * instructions */
+typedef struct {
+    float r[8];
+    float g[8];
+    float b[8];
+} GEEtc1Pixels;
+
+/* The encoding of a subblock */
+typedef struct {
+    /* The quantized color */
+    int color[3];
+    int table;
+    unsigned char indices[8];
+    unsigned long int error;
+} GEEtc1Sub;
+
+/* A part of the image, encoded on its own thread */
+typedef struct {
+    unsigned char *data;
+    unsigned char *rgba;
+    long pitch;
+    int width, height;
+    int quality;
+    int row_start, row_end;
+} GEEtc1Job;
+
+size_t ge_etc1_size(int width, int height) {
+    return (size_t)((width+3)/4)*((height+3)/4)*GE_ETC1_BLOCK_SIZE;
+}
+
+static int _ge_etc1_clamp(int v) {
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+static int _ge_etc1_modifier(int table, int index) {
+    int modifier = _ge_etc1_tables[table][index&1];
+    return index&2 ? -modifier : modifier;
+}
+
+/* Expand a color component stored on 4 or 5 bits to 8 bits */
+static int _ge_etc1_expand(int v, int bits) {
+    return bits == 4 ? v<<4 | v : v<<3 | v>>2;
+}
+
+/* Get the closest color component on 4 or 5 bits */
+static int _ge_etc1_quantize(float v, int bits) {
+    int max = (1<<bits)-1;
+    int q;
+    if(v < 0) v = 0;
+    if(v > 255) v = 255;
+    q = (int)(v*max/255+0.5);
+    return q > max ? max : q;
+}
+
+/* _ge_etc1_eval
+ *
+ * Find the pixel indices that give the smallest error for a subblock.
+ *
+ * pixels:  The pixels of the subblock.
+ * color:   The color of the subblock, on 8 bits.
+ * table:   The table of modifiers.
+ * indices: The pixel indices.
+ * Returns the sum of the squared errors.
+ */
+static unsigned long int _ge_etc1_eval(GEEtc1Pixels *pixels, int *color,
+                                       int table, unsigned char *indices) {
+    float colors[4][3];
+    int i, n;
+#if _GE_ETC1_SSE2
+    __m128 r, g, b;
+    __m128 d, error, mask;
+    __m128 best[2], best_index[2];
+    float errors[8], index[8];
+    float sum = 0;
+#elif _GE_ETC1_NEON
+    float32x4_t r, g, b;
+    float32x4_t d, error;
+    uint32x4_t mask;
+    float32x4_t best[2], best_index[2];
+    float errors[8], index[8];
+    float sum = 0;
+#else
+    float dr, dg, db, error, best;
+    unsigned long int sum = 0;
+#endif
+    
+    for(i=0;i<4;i++){
+        for(n=0;n<3;n++){
+            colors[i][n] = _ge_etc1_clamp(color[n]+
+                                          _ge_etc1_modifier(table, i));
+        }
+    }
+    
+#if _GE_ETC1_SSE2
+    for(n=0;n<2;n++){
+        r = _mm_loadu_ps(pixels->r+n*4);
+        g = _mm_loadu_ps(pixels->g+n*4);
+        b = _mm_loadu_ps(pixels->b+n*4);
+        for(i=0;i<4;i++){
+            d = _mm_sub_ps(r, _mm_set1_ps(colors[i][0]));
+            error = _mm_mul_ps(d, d);
+            d = _mm_sub_ps(g, _mm_set1_ps(colors[i][1]));
+            error = _mm_add_ps(error, _mm_mul_ps(d, d));
+            d = _mm_sub_ps(b, _mm_set1_ps(colors[i][2]));
+            error = _mm_add_ps(error, _mm_mul_ps(d, d));
+            if(!i){
+                best[n] = error;
+                best_index[n] = _mm_setzero_ps();
+                continue;
+            }
+            mask = _mm_cmplt_ps(error, best[n]);
+            best[n] = _mm_min_ps(error, best[n]);
+            best_index[n] = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps(i)),
+                                      _mm_andnot_ps(mask, best_index[n]));
+        }
+        _mm_storeu_ps(errors+n*4, best[n]);
+        _mm_storeu_ps(index+n*4, best_index[n]);
+    }
+#elif _GE_ETC1_NEON
+    for(n=0;n<2;n++){
+        r = vld1q_f32(pixels->r+n*4);
+        g = vld1q_f32(pixels->g+n*4);
+        b = vld1q_f32(pixels->b+n*4);
+        for(i=0;i<4;i++){
+            d = vsubq_f32(r, vdupq_n_f32(colors[i][0]));
+            error = vmulq_f32(d, d);
+            d = vsubq_f32(g, vdupq_n_f32(colors[i][1]));
+            error = vmlaq_f32(error, d, d);
+            d = vsubq_f32(b, vdupq_n_f32(colors[i][2]));
+            error = vmlaq_f32(error, d, d);
+            if(!i){
+                best[n] = error;
+                best_index[n] = vdupq_n_f32(0);
+                continue;
+            }
+            mask = vcltq_f32(error, best[n]);
+            best[n] = vminq_f32(error, best[n]);
+            best_index[n] = vbslq_f32(mask, vdupq_n_f32(i), best_index[n]);
+        }
+        vst1q_f32(errors+n*4, best[n]);
+        vst1q_f32(index+n*4, best_index[n]);
+    }
+#endif
+    
+#if _GE_ETC1_SSE2 || _GE_ETC1_NEON
+    /* The errors are integers below 2^24, so they are exact */
+    for(n=0;n<8;n++){
+        sum += errors[n];
+        indices[n] = (unsigned char)index[n];
+    }
+    return (unsigned long int)sum;
+#else
+    for(n=0;n<8;n++){
+        for(i=0;i<4;i++){
+            dr = pixels->r[n]-colors[i][0];
+            dg = pixels->g[n]-colors[i][1];
+            db = pixels->b[n]-colors[i][2];
+            error = dr*dr+dg*dg+db*db;
+            if(!i || error < best){
+                best = error;
+                indices[n] = i;
+            }
+        }
+        sum += (unsigned long int)best;
+    }
+    return sum;
+#endif
+}
+
+/* _ge_etc1_try
+ *
+ * Try to encode a subblock with a quantized color, with each table.
+ *
+ * pixels: The pixels of the subblock.
+ * color:  The quantized color.
+ * bits:   The number of bits of each component of the color.
+ * sub:    The best encoding found so far, replaced if it is worse.
+ * Returns 1 if a better encoding was found.
+ */
+static int _ge_etc1_try(GEEtc1Pixels *pixels, int *color, int bits,
+                        GEEtc1Sub *sub) {
+    unsigned char indices[8];
+    unsigned long int error;
+    int expanded[3];
+    int table;
+    int found = 0;
+    int i;
+    
+    for(i=0;i<3;i++) expanded[i] = _ge_etc1_expand(color[i], bits);
+    for(table=0;table<8;table++){
+        error = _ge_etc1_eval(pixels, expanded, table, indices);
+        if(error < sub->error){
+            memcpy(sub->color, color, sizeof(sub->color));
+            memcpy(sub->indices, indices, 8);
+            sub->table = table;
+            sub->error = error;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+/* _ge_etc1_search
+ *
+ * Find a good color and table for a subblock.
+ *
+ * pixels:  The pixels of the subblock.
+ * bits:    The number of bits of each component of the color.
+ * quality: The quality of the encoder.
+ * sub:     The encoding of the subblock.
+ */
+static void _ge_etc1_search(GEEtc1Pixels *pixels, int bits, int quality,
+                            GEEtc1Sub *sub) {
+    float *channels[3];
+    float sum;
+    int color[3];
+    int center[3];
+    int max = (1<<bits)-1;
+    int i, n, iter;
+    
+    channels[0] = pixels->r;
+    channels[1] = pixels->g;
+    channels[2] = pixels->b;
+    
+    /* Start from the average color */
+    for(i=0;i<3;i++){
+        for(n=0,sum=0;n<8;n++) sum += channels[i][n];
+        color[i] = _ge_etc1_quantize(sum/8, bits);
+    }
+    sub->error = ULONG_MAX;
+    _ge_etc1_try(pixels, color, bits, sub);
+    
+    if(quality >= GE_ETC1_MEDIUM){
+        /* Move the color to the average of the pixels minus the modifiers
+         * they use, as long as it gets better */
+        for(iter=0;iter<2;iter++){
+            for(i=0;i<3;i++){
+                for(n=0,sum=0;n<8;n++){
+                    sum += channels[i][n]-_ge_etc1_modifier(sub->table,
+                                                            sub->indices[n]);
+                }
+                color[i] = _ge_etc1_quantize(sum/8, bits);
+            }
+            if(!memcmp(color, sub->color, sizeof(color))) break;
+            if(!_ge_etc1_try(pixels, color, bits, sub)) break;
+        }
+        /* Try slightly brighter and darker colors */
+        memcpy(center, sub->color, sizeof(center));
+        for(i=-1;i<=1;i+=2){
+            for(n=0;n<3;n++){
+                color[n] = center[n]+i;
+                if(color[n] < 0 || color[n] > max) break;
+            }
+            if(n == 3) _ge_etc1_try(pixels, color, bits, sub);
+        }
+    }
+    
+    if(quality >= GE_ETC1_HIGH){
+        memcpy(center, sub->color, sizeof(center));
+        for(i=0;i<27;i++){
+            if(i == 13) continue;
+            color[0] = center[0]+i%3-1;
+            color[1] = center[1]+i/3%3-1;
+            color[2] = center[2]+i/9-1;
+            for(n=0;n<3 && color[n] >= 0 && color[n] <= max;n++);
+            if(n < 3) continue;
+            _ge_etc1_try(pixels, color, bits, sub);
+        }
+    }
+}
+
+/* _ge_etc1_pack
+ *
+ * Store the encoding of a block.
+ *
+ * data:  The block.
+ * subs:  The encoding of the two subblocks.
+ * diff:  The colors are stored as a color and a difference on 5 bits
+ *        instead of two colors on 4 bits.
+ * flip:  The subblocks are 4x2 instead of 2x4.
+ */
+static void _ge_etc1_pack(unsigned char *data, GEEtc1Sub *subs, int diff,
+                          int flip) {
+    unsigned int msb = 0, lsb = 0;
+    unsigned int index;
+    int s, k, x, y;
+    int i;
+    
+    for(i=0;i<3;i++){
+        if(diff){
+            data[i] = subs[0].color[i]<<3 |
+                      ((subs[1].color[i]-subs[0].color[i])&7);
+        }else{
+            data[i] = subs[0].color[i]<<4 | subs[1].color[i];
+        }
+    }
+    data[3] = subs[0].table<<5 | subs[1].table<<2 | diff<<1 | flip;
+    
+    for(s=0;s<2;s++){
+        for(k=0;k<8;k++){
+            x = flip ? k/2 : s*2+k/4;
+            y = flip ? s*2+k%2 : k%4;
+            index = subs[s].indices[k];
+            msb |= (index>>1)<<(x*4+y);
+            lsb |= (index&1)<<(x*4+y);
+        }
+    }
+    data[4] = msb>>8;
+    data[5] = msb&0xFF;
+    data[6] = lsb>>8;
+    data[7] = lsb&0xFF;
+}
+
+/* _ge_etc1_encode_block
+ *
+ * Encode a block, trying both orientations of the subblocks and both ways
+ * of storing their colors.
+ *
+ * data:    The block.
+ * block:   The RGB colors of the 4x4 pixels, row by row.
+ * quality: The quality of the encoder.
+ */
+static void _ge_etc1_encode_block(unsigned char *data,
+                                  unsigned char block[16][3], int quality) {
+    GEEtc1Pixels pixels[2];
+    GEEtc1Sub subs[2];
+    GEEtc1Sub best[2];
+    unsigned long int best_error = ULONG_MAX;
+    int best_diff = 0, best_flip = 0;
+    int color[3];
+    int flip, s, k, i;
+    int x, y;
+    int d, fixed;
+    
+    for(flip=0;flip<2;flip++){
+        for(s=0;s<2;s++){
+            for(k=0;k<8;k++){
+                x = flip ? k/2 : s*2+k/4;
+                y = flip ? s*2+k%2 : k%4;
+                pixels[s].r[k] = block[y*4+x][0];
+                pixels[s].g[k] = block[y*4+x][1];
+                pixels[s].b[k] = block[y*4+x][2];
+            }
+        }
+        
+        /* Two colors on 4 bits */
+        _ge_etc1_search(pixels, 4, quality, subs);
+        _ge_etc1_search(pixels+1, 4, quality, subs+1);
+        if(subs[0].error+subs[1].error < best_error){
+            best_error = subs[0].error+subs[1].error;
+            memcpy(best, subs, sizeof(best));
+            best_diff = 0;
+            best_flip = flip;
+        }
+        
+        /* A color on 5 bits and a difference between -4 and 3 */
+        _ge_etc1_search(pixels, 5, quality, subs);
+        _ge_etc1_search(pixels+1, 5, quality, subs+1);
+        fixed = 0;
+        for(i=0;i<3;i++){
+            d = subs[1].color[i]-subs[0].color[i];
+            color[i] = subs[1].color[i];
+            if(d < -4){
+                color[i] = subs[0].color[i]-4;
+                fixed = 1;
+            }else if(d > 3){
+                color[i] = subs[0].color[i]+3;
+                fixed = 1;
+            }
+        }
+        if(fixed){
+            /* The second color is too far away, use the closest one that can
+             * be stored */
+            subs[1].error = ULONG_MAX;
+            _ge_etc1_try(pixels+1, color, 5, subs+1);
+        }
+        if(subs[0].error+subs[1].error < best_error){
+            best_error = subs[0].error+subs[1].error;
+            memcpy(best, subs, sizeof(best));
+            best_diff = 1;
+            best_flip = flip;
+        }
+    }
+    
+    _ge_etc1_pack(data, best, best_diff, best_flip);
+}
+
+/* Encode the rows of blocks of a job. It is the start routine of the
+ * threads. */
+static void *_ge_etc1_encode_rows(void *data) {
+    GEEtc1Job *job = data;
+    unsigned char block[16][3];
+    unsigned char *out;
+    unsigned char *pixel;
+    int bx, by;
+    int x, y, px, py;
+    int blocks_x = (job->width+3)/4;
+    
+    out = job->data+(size_t)job->row_start*blocks_x*GE_ETC1_BLOCK_SIZE;
+    for(by=job->row_start;by<job->row_end;by++){
+        for(bx=0;bx<blocks_x;bx++){
+            /* The pixels outside of the image repeat the last row or
+             * column */
+            for(y=0;y<4;y++){
+                py = by*4+y;
+                if(py >= job->height) py = job->height-1;
+                for(x=0;x<4;x++){
+                    px = bx*4+x;
+                    if(px >= job->width) px = job->width-1;
+                    pixel = job->rgba+py*job->pitch+px*4;
+                    memcpy(block[y*4+x], pixel, 3);
+                }
+            }
+            _ge_etc1_encode_block(out, block, job->quality);
+            out += GE_ETC1_BLOCK_SIZE;
+        }
+    }
+    return job;
+}
+
+/* The number of jobs the rows of blocks are split into */
+static int _ge_etc1_job_num(int rows) {
+#if GE_ETC1_THREADS
+    char *threads;
+    long thread_num = 1;
+    threads = getenv("GE_ETC1_THREADS");
+    if(threads){
+        thread_num = atol(threads);
+    }else{
+#ifdef _SC_NPROCESSORS_ONLN
+        thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    if(thread_num > GE_ETC1_THREAD_MAX) thread_num = GE_ETC1_THREAD_MAX;
+    if(thread_num > rows/_GE_ETC1_ROWS_MIN){
+        thread_num = rows/_GE_ETC1_ROWS_MIN;
+    }
+    if(thread_num < 1) thread_num = 1;
+    return thread_num;
+#else
+    (void)rows;
+    return 1;
+#endif
+}
+
+void ge_etc1_encode(unsigned char *data, unsigned char *rgba, long pitch,
+                    int width, int height, int quality) {
+#if GE_ETC1_THREADS
+    pthread_t threads[GE_ETC1_THREAD_MAX];
+    unsigned char started[GE_ETC1_THREAD_MAX];
+    GEEtc1Job jobs[GE_ETC1_THREAD_MAX];
+#else
+    GEEtc1Job jobs[1];
+#endif
+    int rows = (height+3)/4;
+    int job_num = _ge_etc1_job_num(rows);
+    int i;
+    
+    for(i=0;i<job_num;i++){
+        jobs[i].data = data;
+        jobs[i].rgba = rgba;
+        jobs[i].pitch = pitch;
+        jobs[i].width = width;
+        jobs[i].height = height;
+        jobs[i].quality = quality;
+        jobs[i].row_start = (long)rows*i/job_num;
+        jobs[i].row_end = (long)rows*(i+1)/job_num;
+    }
+    
+#if GE_ETC1_THREADS
+    for(i=1;i<job_num;i++){
+        started[i] = !pthread_create(threads+i, NULL, _ge_etc1_encode_rows,
+                                     jobs+i);
+    }
+    _ge_etc1_encode_rows(jobs);
+    for(i=1;i<job_num;i++){
+        /* Encode it on this thread if the thread could not be created */
+        if(started[i]) pthread_join(threads[i], NULL);
+        else _ge_etc1_encode_rows(jobs+i);
+    }
+#else
+    _ge_etc1_encode_rows(jobs);
+#endif
+}
+
+void ge_etc1_decode(unsigned char *rgba, long pitch, unsigned char *data,
+                    int width, int height) {
+    int colors[2][3];
+    int tables[2];
+    unsigned int msb, lsb;
+    unsigned int index;
+    int diff, flip;
+    int bx, by;
+    int x, y, s, i;
+    int d;
+    unsigned char *pixel;
+    
+    for(by=0;by<height;by+=4){
+        for(bx=0;bx<width;bx+=4,data+=GE_ETC1_BLOCK_SIZE){
+            diff = data[3]>>1&1;
+            flip = data[3]&1;
+            tables[0] = data[3]>>5;
+            tables[1] = data[3]>>2&7;
+            for(i=0;i<3;i++){
+                if(diff){
+                    /* The difference is a signed 3-bit number */
+                    d = (data[i]&7)^4;
+                    d -= 4;
+                    colors[0][i] = _ge_etc1_expand(data[i]>>3, 5);
+                    colors[1][i] = _ge_etc1_expand(((data[i]>>3)+d)&31, 5);
+                }else{
+                    colors[0][i] = _ge_etc1_expand(data[i]>>4, 4);
+                    colors[1][i] = _ge_etc1_expand(data[i]&15, 4);
+                }
+            }
+            msb = data[4]<<8 | data[5];
+            lsb = data[6]<<8 | data[7];
+            for(y=0;y<4 && by+y<height;y++){
+                pixel = rgba+(by+y)*pitch+bx*4;
+                for(x=0;x<4 && bx+x<width;x++,pixel+=4){
+                    s = flip ? y >= 2 : x >= 2;
+                    index = (msb>>(x*4+y)&1)<<1 | (lsb>>(x*4+y)&1);
+                    for(i=0;i<3;i++){
+                        pixel[i] = _ge_etc1_clamp(colors[s][i]+
+                                            _ge_etc1_modifier(tables[s],
+                                                              index));
+                    }
+                    pixel[3] = 255;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <mibiengine2/base/file.h>
+
+#include <mibiengine2/config.h>
+#include <mibiengine2/errors.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#if GE_FILE_USE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static int _ge_file_read(GEFile *file, char *path, int text) {
+    FILE *fp;
+    long size;
+    
+    fp = fopen(path, "rb");
+    if(fp == NULL) return GE_E_FILE;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    rewind(fp);
+    if(size < 0){
+        fclose(fp);
+        return GE_E_FILE;
+    }
+    file->data = malloc(size+1);
+    if(file->data == NULL){
+        fclose(fp);
+        return GE_E_OUT_OF_MEM;
+    }
+    file->size = fread(file->data, 1, size, fp);
+    fclose(fp);
+    if(text) ((char*)file->data)[file->size] = '\0';
+    file->mapped = 0;
+    return GE_E_NONE;
+}
+
+int ge_file_map(GEFile *file, char *path, int text) {
+#if GE_FILE_USE_MMAP
+    struct stat st;
+    long page_size;
+    void *data;
+    int fd;
+    
+    fd = open(path, O_RDONLY);
+    if(fd < 0) return GE_E_FILE;
+    if(fstat(fd, &st)){
+        close(fd);
+        return GE_E_FILE;
+    }
+    page_size = sysconf(_SC_PAGESIZE);
+    /* The end of the last page is filled with zeros, so a text file is
+     * already null terminated unless it ends exactly at the end of a page. */
+    if(st.st_size > 0 && page_size > 0 &&
+       !(text && st.st_size%page_size == 0)){
+        data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data != MAP_FAILED){
+            close(fd);
+            posix_madvise(data, st.st_size, POSIX_MADV_SEQUENTIAL);
+            file->data = data;
+            file->size = st.st_size;
+            file->mapped = 1;
+            return GE_E_NONE;
+        }
+    }
+    close(fd);
+#endif
+    return _ge_file_read(file, path, text);
+}
+
+void ge_file_unmap(GEFile *file) {
+#if GE_FILE_USE_MMAP
+    if(file->mapped){
+        munmap(file->data, file->size);
+        file->data = NULL;
+        return;
+    }
+#endif
+    free(file->data);
+    file->data = NULL;
+}
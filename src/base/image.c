@@ -33,6 +33,11 @@
  */
 
 #include <mibiengine2/base/image.h>
+#include <mibiengine2/base/file.h>
+#include <mibiengine2/base/utils.h>
+#include <mibiengine2/base/etc1.h>
+#include <mibiengine2/base/mipmap.h>
+#include <mibiengine2/base/texture.h>
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -50,8 +55,26 @@
 
 #include <png.h>
 
-int ge_image_init(GEImage *image, char *file) {
-    png_byte header[GE_IMAGE_PNG_HEADER_SIZE];
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t pos;
+} GEImageReader;
+
+static void _ge_image_read(png_structp png_ptr, png_bytep out,
+                           png_size_t size) {
+    GEImageReader *reader = png_get_io_ptr(png_ptr);
+    if(size > reader->size-reader->pos){
+        png_error(png_ptr, "Unexpected end of file");
+    }
+    memcpy(out, reader->data+reader->pos, size);
+    reader->pos += size;
+}
+
+static int _ge_image_open(GEImage *image, char *file, int texture,
+                          int flip) {
+    GEImageReader reader;
+    GEFile png;
     int is_png;
 
     png_structp png_ptr;
@@ -60,14 +83,13 @@ int ge_image_init(GEImage *image, char *file) {
     png_uint_32 i;
 
     /* Check if the file is a png image. */
-    FILE *fp = fopen(file, "rb");
-    if(fp == NULL){
+    if(ge_file_map(&png, file, 0)){
         return GE_E_FILE;
     }
-    fread(header, 1, GE_IMAGE_PNG_HEADER_SIZE, fp);
-    is_png = !png_sig_cmp(header, 0, GE_IMAGE_PNG_HEADER_SIZE);
+    is_png = png.size >= GE_IMAGE_PNG_HEADER_SIZE &&
+             !png_sig_cmp(png.data, 0, GE_IMAGE_PNG_HEADER_SIZE);
     if(!is_png){
-        fclose(fp);
+        ge_file_unmap(&png);
         return GE_E_NOT_PNG;
     }
 
@@ -75,26 +97,30 @@ int ge_image_init(GEImage *image, char *file) {
     png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
                                                  NULL, NULL);
     if(png_ptr == NULL){
-        fclose(fp);
+        ge_file_unmap(&png);
         return GE_E_OUT_OF_MEM;
     }
 
     info_ptr = png_create_info_struct(png_ptr);
     if(info_ptr == NULL){
-        fclose(fp);
+        ge_file_unmap(&png);
         png_destroy_read_struct(&png_ptr, NULL, NULL);
         return GE_E_OUT_OF_MEM;
     }
 
     /* Initialize everything */
     if(setjmp(png_jmpbuf(png_ptr))){
-        fclose(fp);
+        ge_file_unmap(&png);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         return GE_E_UNKNOWN;
     }
 
-    png_init_io(png_ptr, fp);
-    png_set_sig_bytes(png_ptr, 8);
+    /* Read the image directly from the mapped file */
+    reader.data = png.data;
+    reader.size = png.size;
+    reader.pos = GE_IMAGE_PNG_HEADER_SIZE;
+    png_set_read_fn(png_ptr, &reader, _ge_image_read);
+    png_set_sig_bytes(png_ptr, GE_IMAGE_PNG_HEADER_SIZE);
     png_read_info(png_ptr, info_ptr);
 
     /* Get some useful informations about the image */
@@ -111,29 +137,50 @@ int ge_image_init(GEImage *image, char *file) {
     if(png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)){
         png_set_expand(png_ptr);
     }
+    /* The size is stored in the image as locals may be clobbered by
+     * png_error */
+    image->data_width = image->data_height = 0;
+    if(texture){
+        /* Textures are uploaded as 8-bit RGBA */
+        png_set_expand(png_ptr);
+        png_set_strip_16(png_ptr);
+        png_set_gray_to_rgb(png_ptr);
+        png_set_add_alpha(png_ptr, 0xFF, PNG_FILLER_AFTER);
+        ge_texture_layout(image->width, image->height, GE_MIPMAP_NONE,
+                          &image->data_width, &image->data_height);
+    }
 
     png_read_update_info(png_ptr, info_ptr);
 
     /* Read! */
     image->rows = malloc(sizeof(png_bytep)*image->height);
     if(image->rows == NULL){
-        fclose(fp);
+        ge_file_unmap(&png);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         return GE_E_OUT_OF_MEM;
     }
 
-    image->row_bytes = png_get_rowbytes(png_ptr, info_ptr);
-
-    image->data = malloc(image->height*image->row_bytes);
+    if(image->data_width){
+        /* The padding of the texture has to be transparent */
+        image->row_bytes = (long)image->data_width*4;
+        image->data = calloc((size_t)image->data_width*image->data_height,
+                             4);
+    }else{
+        image->row_bytes = png_get_rowbytes(png_ptr, info_ptr);
+        image->data = malloc(image->height*image->row_bytes);
+    }
     if(image->data == NULL){
-        fclose(fp);
+        ge_file_unmap(&png);
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
         free(image->rows);
         return GE_E_OUT_OF_MEM;
     }
+    image->flip = image->data_width && flip;
 
     for(i=0;i<image->height;i++){
-        image->rows[i] = image->data+i*image->row_bytes;
+        image->rows[i] = image->data+(image->flip ?
+                                      image->data_height-1-i : i)*
+                                     image->row_bytes;
     }
 
     png_read_image(png_ptr, image->rows);
@@ -143,8 +190,9 @@ int ge_image_init(GEImage *image, char *file) {
     /* Free everything */
     png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
     free(image->rows);
+    image->rows = NULL;
 
-    fclose(fp);
+    ge_file_unmap(&png);
 
     return GE_E_NONE;
 }
@@ -153,15 +201,591 @@ int ge_image_init(GEImage *image, char *file) {
 
 #include <mibiengine2/base/deflate.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define _GE_IMAGE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _GE_IMAGE_NEON 1
+#endif
+
+#define _GE_IMAGE_GRAY 0
+#define _GE_IMAGE_RGB 2
+#define _GE_IMAGE_PALETTE 3
+#define _GE_IMAGE_GRAY_ALPHA 4
+#define _GE_IMAGE_RGBA 6
+
+/* Size of the window the image data is decompressed into */
+#define _GE_IMAGE_WINDOW_SIZE (GE_DEFLATE_WINDOW_MAX*2)
+
+/* The 7 passes of Adam7 interlacing, followed by a single pass for images
+ * that are not interlaced */
+static const unsigned char _ge_image_start_x[8] = {0, 4, 0, 2, 0, 1, 0, 0};
+static const unsigned char _ge_image_start_y[8] = {0, 0, 4, 0, 2, 0, 1, 0};
+static const unsigned char _ge_image_step_x[8] = {8, 8, 4, 4, 2, 2, 1, 1};
+static const unsigned char _ge_image_step_y[8] = {8, 8, 8, 4, 4, 2, 2, 1};
+
+typedef struct {
+    /* Decoded RGBA pixels, pitch bytes apart, the first row being stored at
+     * the end of the buffer if the image is flipped */
+    unsigned char *out;
+    size_t pitch;
+    /* The size of the texture the image is laid out for, or 0 */
+    int data_width, data_height;
+    int flip;
+    size_t width, height;
+    unsigned char color_type;
+    unsigned char bit_depth;
+    /* Bits per pixel */
+    size_t bits;
+    /* Distance between a byte and the corresponding byte of the previous
+     * pixel, used by the filters */
+    size_t bpp;
+    
+    /* The row being received and the previous row of the same pass, without
+     * their filter type */
+    unsigned char *rows;
+    unsigned char *row;
+    unsigned char *prior;
+    unsigned char filter;
+    size_t row_size;
+    /* Number of bytes of the current row received so far, including the
+     * filter type */
+    size_t filled;
+    
+    int pass;
+    int pass_end;
+    size_t pass_width, pass_height;
+    size_t y;
+    int done;
+    
+    /* RGBA color of each palette index or gray level */
+    unsigned char lut[256*4];
+    /* Transparent color of gray and RGB images */
+    int has_key;
+    unsigned int key[3];
+} GEImageDecoder;
+
+/* _ge_image_pass
+ *
+ * Start the next pass that contains pixels, or finish decoding if there is
+ * none left.
+ *
+ * decoder: The decoder.
+ */
+static void _ge_image_pass(GEImageDecoder *decoder) {
+    size_t start_x, start_y;
+    size_t step_x, step_y;
+    
+    for(;decoder->pass<decoder->pass_end;decoder->pass++){
+        start_x = _ge_image_start_x[decoder->pass];
+        start_y = _ge_image_start_y[decoder->pass];
+        step_x = _ge_image_step_x[decoder->pass];
+        step_y = _ge_image_step_y[decoder->pass];
+        if(decoder->width <= start_x || decoder->height <= start_y) continue;
+        decoder->pass_width = (decoder->width-start_x+step_x-1)/step_x;
+        decoder->pass_height = (decoder->height-start_y+step_y-1)/step_y;
+        decoder->row_size = (decoder->pass_width*decoder->bits+7)/8;
+        decoder->y = 0;
+        /* The first row is filtered as if the previous one was empty */
+        memset(decoder->prior, 0, decoder->row_size);
+        return;
+    }
+    decoder->done = 1;
+}
+
+/* _ge_image_decoder_init
+ *
+ * Prepare the decoding of the image data.
+ *
+ * decoder: The decoder.
+ * ihdr:    The content of the IHDR chunk.
+ * texture: Decode the image in the layout of a texture.
+ * flip:    Flip the rows of the texture.
+ * Returns 0 on success or an error code if the header is invalid.
+ */
+static int _ge_image_decoder_init(GEImageDecoder *decoder,
+                                  unsigned char *ihdr, int texture,
+                                  int flip) {
+    /* Number of channels of each color type */
+    static const unsigned char channels[7] = {1, 0, 3, 1, 2, 0, 4};
+    /* Allowed bit depths of each color type, bit n is set if a depth of 1<<n
+     * is allowed */
+    static const unsigned char depths[7] = {0x1F, 0, 0x18, 0x0F, 0x18, 0,
+                                            0x18};
+    unsigned char compression = ihdr[10];
+    unsigned char filter = ihdr[11];
+    unsigned char interlace = ihdr[12];
+    size_t row_max;
+    unsigned int n;
+    
+    decoder->width = (size_t)ihdr[0]<<24 | (size_t)ihdr[1]<<16 |
+                     (size_t)ihdr[2]<<8 | (size_t)ihdr[3];
+    decoder->height = (size_t)ihdr[4]<<24 | (size_t)ihdr[5]<<16 |
+                      (size_t)ihdr[6]<<8 | (size_t)ihdr[7];
+    decoder->bit_depth = ihdr[8];
+    decoder->color_type = ihdr[9];
+    
+    if(!decoder->width || !decoder->height || compression || filter ||
+       interlace > 1){
+        fputs("Corrupted IHDR chunk!\n", stderr);
+        return GE_E_CORRUPTED_IHDR;
+    }
+    if(decoder->color_type > 6 || !channels[decoder->color_type]){
+        fputs("Invalid color type!\n", stderr);
+        return GE_E_INVALID_COLOR_TYPE;
+    }
+    for(n=0;n<5 && 1U<<n != decoder->bit_depth;n++);
+    if(n == 5 || !(depths[decoder->color_type]&(1<<n))){
+        fputs("Invalid bit depth!\n", stderr);
+        return GE_E_INVALID_BIT_DEPTH;
+    }
+    
+    decoder->bits = channels[decoder->color_type]*decoder->bit_depth;
+    decoder->bpp = (decoder->bits+7)/8;
+    
+    if(texture){
+        if(decoder->width > 1<<30 || decoder->height > 1<<30){
+            return GE_E_OUT_OF_MEM;
+        }
+        ge_texture_layout(decoder->width, decoder->height, GE_MIPMAP_NONE,
+                          &decoder->data_width, &decoder->data_height);
+        if((size_t)decoder->data_width >
+           (size_t)-1/4/decoder->data_height){
+            return GE_E_OUT_OF_MEM;
+        }
+        /* The padding of the texture has to be transparent */
+        decoder->pitch = (size_t)decoder->data_width*4;
+        decoder->flip = flip;
+        decoder->out = calloc((size_t)decoder->data_width*
+                              decoder->data_height, 4);
+    }else{
+        if(decoder->width > (size_t)-1/4/decoder->height){
+            return GE_E_OUT_OF_MEM;
+        }
+        decoder->data_width = decoder->data_height = 0;
+        decoder->pitch = decoder->width*4;
+        decoder->flip = 0;
+        decoder->out = malloc(decoder->width*decoder->height*4);
+    }
+    if(decoder->out == NULL){
+        return GE_E_OUT_OF_MEM;
+    }
+    
+    /* The last pass of interlaced images has full rows */
+    row_max = (decoder->width*decoder->bits+7)/8;
+    decoder->rows = malloc(row_max*2);
+    if(decoder->rows == NULL){
+        return GE_E_OUT_OF_MEM;
+    }
+    decoder->row = decoder->rows;
+    decoder->prior = decoder->rows+row_max;
+    decoder->filled = 0;
+    decoder->done = 0;
+    decoder->has_key = 0;
+    
+    decoder->pass = interlace ? 0 : 7;
+    decoder->pass_end = interlace ? 7 : 8;
+    _ge_image_pass(decoder);
+    
+    return GE_E_NONE;
+}
+
+/* _ge_image_decoder_lut
+ *
+ * Get the colors of the palette or of the gray levels and the transparent
+ * color once the chunks that come before the image data have been read.
+ *
+ * decoder: The decoder.
+ * palette: The content of the PLTE chunk.
+ * palette_size: The number of colors in the palette.
+ * trns: The content of the tRNS chunk.
+ * trns_size: The size of the tRNS chunk.
+ * Returns 0 on success or GE_E_CORRUPTED_PLTE if the palette is missing.
+ */
+static int _ge_image_decoder_lut(GEImageDecoder *decoder,
+                                 unsigned char *palette, size_t palette_size,
+                                 unsigned char *trns, size_t trns_size) {
+    unsigned char *lut = decoder->lut;
+    unsigned int max, v;
+    size_t i;
+    
+    switch(decoder->color_type){
+        case _GE_IMAGE_PALETTE:
+            if(!palette_size){
+                fputs("Palette not found!\n", stderr);
+                return GE_E_CORRUPTED_PLTE;
+            }
+            for(i=0;i<256;i++){
+                if(i < palette_size) memcpy(lut+i*4, palette+i*3, 3);
+                else memset(lut+i*4, 0, 3);
+                lut[i*4+3] = i < trns_size ? trns[i] : 255;
+            }
+            break;
+        case _GE_IMAGE_GRAY:
+            if(trns_size >= 2){
+                decoder->has_key = 1;
+                decoder->key[0] = (unsigned int)trns[0]<<8 | trns[1];
+            }
+            if(decoder->bit_depth > 8) break;
+            /* Scale the gray levels to 8 bits */
+            max = (1U<<decoder->bit_depth)-1;
+            for(v=0;v<=max;v++){
+                memset(lut+v*4, v*255/max, 3);
+                lut[v*4+3] = decoder->has_key && v == decoder->key[0] ? 0 :
+                             255;
+            }
+            break;
+        case _GE_IMAGE_RGB:
+            if(trns_size >= 6){
+                decoder->has_key = 1;
+                for(i=0;i<3;i++){
+                    decoder->key[i] = (unsigned int)trns[i*2]<<8 |
+                                      trns[i*2+1];
+                }
+            }
+            break;
+    }
+    
+    return GE_E_NONE;
+}
+
+/* _ge_image_paeth
+ *
+ * The Paeth predictor: the neighbour closest to a+b-c.
+ */
+static unsigned char _ge_image_paeth(int a, int b, int c) {
+    int pa = abs(b-c);
+    int pb = abs(a-c);
+    int pc = abs(a+b-c-c);
+    
+    if(pa <= pb && pa <= pc) return a;
+    if(pb <= pc) return b;
+    return c;
+}
+
+#if _GE_IMAGE_SSE2
+
+/* The filters that depend on the previous pixel process a pixel at a time,
+ * with one byte or one 16-bit lane per channel. */
+
+static __m128i _ge_image_load(unsigned char *data, size_t bpp) {
+    int v = 0;
+    memcpy(&v, data, bpp);
+    return _mm_cvtsi32_si128(v);
+}
+
+static void _ge_image_store(unsigned char *data, __m128i pixel, size_t bpp) {
+    int v = _mm_cvtsi128_si32(pixel);
+    memcpy(data, &v, bpp);
+}
+
+static void _ge_image_sub_sse2(unsigned char *row, size_t size, size_t bpp) {
+    __m128i a = _mm_setzero_si128();
+    size_t i;
+    
+    for(i=0;i<size;i+=bpp){
+        a = _mm_add_epi8(_ge_image_load(row+i, bpp), a);
+        _ge_image_store(row+i, a, bpp);
+    }
+}
+
+static void _ge_image_avg_sse2(unsigned char *row, unsigned char *prior,
+                               size_t size, size_t bpp) {
+    __m128i ones = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    __m128i b, avg;
+    size_t i;
+    
+    for(i=0;i<size;i+=bpp){
+        b = _ge_image_load(prior+i, bpp);
+        /* _mm_avg_epu8 rounds up */
+        avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                           _mm_and_si128(_mm_xor_si128(a, b), ones));
+        a = _mm_add_epi8(_ge_image_load(row+i, bpp), avg);
+        _ge_image_store(row+i, a, bpp);
+    }
+}
+
+static __m128i _ge_image_abs(__m128i v) {
+    return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v));
+}
+
+static __m128i _ge_image_select(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void _ge_image_paeth_sse2(unsigned char *row, unsigned char *prior,
+                                 size_t size, size_t bpp) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i a = zero;
+    __m128i c = zero;
+    __m128i b, pa, pb, pc, smallest, nearest, d;
+    size_t i;
+    
+    for(i=0;i<size;i+=bpp){
+        b = _mm_unpacklo_epi8(_ge_image_load(prior+i, bpp), zero);
+        /* With p = a+b-c: |p-a| = |b-c|, |p-b| = |a-c| and
+         * |p-c| = |(b-c)+(a-c)| */
+        pa = _mm_sub_epi16(b, c);
+        pb = _mm_sub_epi16(a, c);
+        pc = _ge_image_abs(_mm_add_epi16(pa, pb));
+        pa = _ge_image_abs(pa);
+        pb = _ge_image_abs(pb);
+        smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        /* Ties are broken in favour of a, then b */
+        nearest = _ge_image_select(_mm_cmpeq_epi16(smallest, pa), a,
+                                   _ge_image_select(_mm_cmpeq_epi16(smallest,
+                                                                    pb),
+                                                    b, c));
+        d = _mm_add_epi8(_ge_image_load(row+i, bpp),
+                         _mm_packus_epi16(nearest, nearest));
+        _ge_image_store(row+i, d, bpp);
+        a = _mm_unpacklo_epi8(d, zero);
+        c = b;
+    }
+}
+
+#endif
+
+/* _ge_image_unfilter
+ *
+ * Reverse the filter of a row.
+ *
+ * row: The row to unfilter, in place.
+ * prior: The previous row, already unfiltered.
+ * size: The size of a row.
+ * bpp: The distance to the corresponding byte of the previous pixel.
+ * filter: The filter type of the row.
+ * Returns 0 on success or GE_E_INVALID_FILTER if the filter type is unknown.
+ */
+static int _ge_image_unfilter(unsigned char *row, unsigned char *prior,
+                              size_t size, size_t bpp, unsigned char filter) {
+    size_t i;
+    
+    switch(filter){
+        case 0:
+            /* None */
+            break;
+        case 1:
+            /* Sub */
+#if _GE_IMAGE_SSE2
+            if(bpp == 4 || bpp == 3){
+                _ge_image_sub_sse2(row, size, bpp);
+                break;
+            }
+#endif
+            for(i=bpp;i<size;i++){
+                row[i] += row[i-bpp];
+            }
+            break;
+        case 2:
+            /* Up */
+            i = 0;
+#if _GE_IMAGE_SSE2
+            for(;i+16<=size;i+=16){
+                _mm_storeu_si128((__m128i*)(row+i),
+                                 _mm_add_epi8(
+                                 _mm_loadu_si128((__m128i*)(row+i)),
+                                 _mm_loadu_si128((__m128i*)(prior+i))));
+            }
+#elif _GE_IMAGE_NEON
+            for(;i+16<=size;i+=16){
+                vst1q_u8(row+i, vaddq_u8(vld1q_u8(row+i), vld1q_u8(prior+i)));
+            }
+#endif
+            for(;i<size;i++){
+                row[i] += prior[i];
+            }
+            break;
+        case 3:
+            /* Average */
+#if _GE_IMAGE_SSE2
+            if(bpp == 4 || bpp == 3){
+                _ge_image_avg_sse2(row, prior, size, bpp);
+                break;
+            }
+#endif
+            for(i=0;i<bpp;i++){
+                row[i] += prior[i]>>1;
+            }
+            for(;i<size;i++){
+                row[i] += (row[i-bpp]+prior[i])>>1;
+            }
+            break;
+        case 4:
+            /* Paeth */
+#if _GE_IMAGE_SSE2
+            if(bpp == 4 || bpp == 3){
+                _ge_image_paeth_sse2(row, prior, size, bpp);
+                break;
+            }
+#endif
+            for(i=0;i<bpp;i++){
+                row[i] += prior[i];
+            }
+            for(;i<size;i++){
+                row[i] += _ge_image_paeth(row[i-bpp], prior[i],
+                                          prior[i-bpp]);
+            }
+            break;
+        default:
+            fputs("Invalid filter type!\n", stderr);
+            return GE_E_INVALID_FILTER;
+    }
+    
+    return GE_E_NONE;
+}
+
+/* Read a sample of a 8 or 16-bit image */
+#define _GE_IMAGE_SAMPLE(ptr) \
+    (inc == 2 ? (unsigned int)(ptr)[0]<<8 | (ptr)[1] : (ptr)[0])
+
+/* _ge_image_expand
+ *
+ * Convert the current row to RGBA and write it to its place in the image.
+ *
+ * decoder: The decoder.
+ */
+static void _ge_image_expand(GEImageDecoder *decoder) {
+    int pass = decoder->pass;
+    size_t n = decoder->pass_width;
+    size_t stride = _ge_image_step_x[pass]*4;
+    size_t inc = decoder->bit_depth/8;
+    size_t depth = decoder->bit_depth;
+    size_t k, bit;
+    unsigned int mask;
+    unsigned char *lut = decoder->lut;
+    unsigned char *src = decoder->row;
+    unsigned char *dst;
+    size_t y = _ge_image_start_y[pass]+decoder->y*_ge_image_step_y[pass];
+    
+    if(decoder->flip) y = decoder->data_height-1-y;
+    dst = decoder->out+y*decoder->pitch+_ge_image_start_x[pass]*4;
+    
+    switch(decoder->color_type){
+        case _GE_IMAGE_RGBA:
+            if(depth == 8 && stride == 4){
+                memcpy(dst, src, n*4);
+                break;
+            }
+            for(k=0;k<n;k++,dst+=stride,src+=4*inc){
+                dst[0] = src[0];
+                dst[1] = src[inc];
+                dst[2] = src[inc*2];
+                dst[3] = src[inc*3];
+            }
+            break;
+        case _GE_IMAGE_RGB:
+            for(k=0;k<n;k++,dst+=stride,src+=3*inc){
+                dst[0] = src[0];
+                dst[1] = src[inc];
+                dst[2] = src[inc*2];
+                dst[3] = 255;
+                if(decoder->has_key &&
+                   _GE_IMAGE_SAMPLE(src) == decoder->key[0] &&
+                   _GE_IMAGE_SAMPLE(src+inc) == decoder->key[1] &&
+                   _GE_IMAGE_SAMPLE(src+inc*2) == decoder->key[2]){
+                    dst[3] = 0;
+                }
+            }
+            break;
+        case _GE_IMAGE_GRAY_ALPHA:
+            for(k=0;k<n;k++,dst+=stride,src+=2*inc){
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = src[inc];
+            }
+            break;
+        default:
+            if(depth == 16){
+                /* 16-bit gray */
+                for(k=0;k<n;k++,dst+=stride,src+=2){
+                    dst[0] = dst[1] = dst[2] = src[0];
+                    dst[3] = decoder->has_key &&
+                             _GE_IMAGE_SAMPLE(src) == decoder->key[0] ? 0 :
+                             255;
+                }
+            }else if(depth == 8){
+                for(k=0;k<n;k++,dst+=stride){
+                    memcpy(dst, lut+src[k]*4, 4);
+                }
+            }else{
+                /* Several pixels per byte, starting at the most significant
+                 * bits */
+                mask = (1U<<depth)-1;
+                for(k=0,bit=0;k<n;k++,dst+=stride,bit+=depth){
+                    memcpy(dst, lut+((src[bit>>3]>>(8-depth-(bit&7)))&mask)*4,
+                           4);
+                }
+            }
+    }
+}
+
+/* _ge_image_rows
+ *
+ * Unfilter and expand each row of the image as soon as it is decompressed.
+ * Used as the flush callback of the ZLIB stream.
+ */
+static int _ge_image_rows(void *data, unsigned char *bytes, size_t size) {
+    GEImageDecoder *decoder = data;
+    unsigned char *tmp;
+    size_t n;
+    int rc;
+    
+    while(size){
+        if(decoder->done){
+            fputs("Too much image data!\n", stderr);
+            return GE_E_DECOMPRESSION_FAILED;
+        }
+        if(!decoder->filled){
+            /* Each row starts with its filter type */
+            decoder->filter = *bytes++;
+            size--;
+            decoder->filled = 1;
+            continue;
+        }
+        
+        n = decoder->row_size+1-decoder->filled;
+        if(n > size) n = size;
+        memcpy(decoder->row+decoder->filled-1, bytes, n);
+        bytes += n;
+        size -= n;
+        decoder->filled += n;
+        if(decoder->filled <= decoder->row_size) continue;
+        
+        /* The row is complete */
+        rc = _ge_image_unfilter(decoder->row, decoder->prior,
+                                decoder->row_size, decoder->bpp,
+                                decoder->filter);
+        if(rc) return rc;
+        _ge_image_expand(decoder);
+        
+        tmp = decoder->prior;
+        decoder->prior = decoder->row;
+        decoder->row = tmp;
+        decoder->filled = 0;
+        if(++decoder->y >= decoder->pass_height){
+            decoder->pass++;
+            _ge_image_pass(decoder);
+        }
+    }
+    
+    return GE_E_NONE;
+}
+
 #define _GE_IMAGE_ERROR(rc) \
     { \
-        free(data); \
+        if(data != NULL) ge_file_unmap(&png); \
         data = NULL; \
+        free(decoder.out); \
+        free(decoder.rows); \
+        free(window); \
         ge_deflate_free(&deflate); \
         return rc; \
     }
 
-int ge_image_init(GEImage *image, char *file) {
+static int _ge_image_open(GEImage *image, char *file, int texture,
+                          int flip) {
     unsigned char png_header[GE_IMAGE_PNG_HEADER_SIZE] = {
         0x89,
         0x50, 0x4E, 0x47,
@@ -171,49 +795,39 @@ int ge_image_init(GEImage *image, char *file) {
     };
     
     unsigned char *data = NULL;
+    unsigned char *window = NULL;
     size_t size, chunk_len;
     size_t i;
-    size_t chunk = 0;
-    FILE *fp;
-    unsigned int w, h;
-    unsigned char bit_depth;
-    unsigned char color_type;
-    unsigned char compression;
-    unsigned char filter;
-    unsigned char interlace;
+    unsigned long int crc;
+    GEFile png;
+    int rc;
     
     int ihdr_found = 0;
-    int plte_found = 0;
+    int idat_found = 0;
     int iend_found = 0;
     
     char type[4];
     
     unsigned char palette[256*3];
-    size_t palette_size;
+    size_t palette_size = 0;
+    unsigned char trns[256];
+    size_t trns_size = 0;
     
+    GEImageDecoder decoder;
     GEDeflate deflate;
     
+    decoder.out = NULL;
+    decoder.rows = NULL;
+    
     if(ge_deflate_init(&deflate)){
         return GE_E_DEFLATE_INIT;
     }
     
-    fp = fopen(file, "r");
-    if(fp == NULL){
+    if(ge_file_map(&png, file, 0)){
         _GE_IMAGE_ERROR(GE_E_FILE);
     }
-    
-    fseek(fp, 0, SEEK_END);
-    size = ftell(fp);
-    rewind(fp);
-    
-    data = malloc(size);
-    if(data == NULL){
-        _GE_IMAGE_ERROR(GE_E_OUT_OF_MEM);
-    }
-    
-    fread(data, 1, size, fp);
-    
-    printf("Read %lu bytes\n", size);
+    data = png.data;
+    size = png.size;
     
     if(size < GE_IMAGE_PNG_HEADER_SIZE){
         _GE_IMAGE_ERROR(GE_E_NOT_PNG);
@@ -233,7 +847,8 @@ int ge_image_init(GEImage *image, char *file) {
         if(i+4 > size){
             _GE_IMAGE_ERROR(GE_E_PNG_TOO_SMALL);
         }
-        chunk_len = data[i]<<24 | data[i+1]<<16 | data[i+2]<<8 | data[i+3];
+        chunk_len = (size_t)data[i]<<24 | (size_t)data[i+1]<<16 |
+                    (size_t)data[i+2]<<8 | (size_t)data[i+3];
         i += 4;
         
         if(i+4 > size){
@@ -242,65 +857,82 @@ int ge_image_init(GEImage *image, char *file) {
         memcpy(type, data+i, 4);
         i += 4;
         
-        if(i+chunk_len+4 > size){
+        if(chunk_len > size-i || size-i-chunk_len < 4){
             fputs("Image data too small!\n", stderr);
             _GE_IMAGE_ERROR(GE_E_PNG_TOO_SMALL);
         }
         
+        /* Check if the checksum of the type and the data is correct */
+        crc = (unsigned long int)data[i+chunk_len]<<24 |
+              (unsigned long int)data[i+chunk_len+1]<<16 |
+              (unsigned long int)data[i+chunk_len+2]<<8 |
+              (unsigned long int)data[i+chunk_len+3];
+        if(ge_utils_crc32(data+i-4, chunk_len+4) != crc){
+            fputs("Corrupted chunk!\n", stderr);
+            _GE_IMAGE_ERROR(GE_E_CORRUPTED_CHUNK);
+        }
+        
+        /* The IHDR chunk should be the first chunk, the other chunks need
+         * the decoder it initializes */
+        if(!ihdr_found && memcmp(type, "IHDR", 4)){
+            fputs("IHDR chunk not found!\n", stderr);
+            _GE_IMAGE_ERROR(GE_E_IHDR_NOT_FOUND);
+        }
+        
         if(!memcmp(type, "IHDR", 4)){
-            if(chunk_len != GE_IMAGE_PNG_IHDR_SIZE){
+            if(chunk_len != GE_IMAGE_PNG_IHDR_SIZE || ihdr_found){
                 fputs("Corrupted IHDR chunk!\n", stderr);
                 _GE_IMAGE_ERROR(GE_E_CORRUPTED_IHDR);
             }
             
-            w = data[i]<<24 | data[i+1]<<16 | data[i+2]<<8 | data[i+3];
-            i += 4;
-            
-            h = data[i]<<24 | data[i+1]<<16 | data[i+2]<<8 | data[i+3];
-            i += 4;
-            
-            bit_depth = data[i++];
-            color_type = data[i++];
-            compression = data[i++];
-            filter = data[i++];
-            interlace = data[i++];
-            
-            printf("IHDR: %u, %u - %u, %u, %u, %u, %u\n", w, h, bit_depth,
-                   color_type, compression, filter, interlace);
+            rc = _ge_image_decoder_init(&decoder, data+i, texture, flip);
+            if(rc){
+                _GE_IMAGE_ERROR(rc);
+            }
             
-            if((bit_depth&(bit_depth-1)) || bit_depth > 8){
-                fputs("Invalid bit depth!\n", stderr);
-                _GE_IMAGE_ERROR(GE_E_INVALID_BIT_DEPTH);
+            /* The image data is decoded as it is decompressed */
+            window = malloc(_GE_IMAGE_WINDOW_SIZE);
+            if(window == NULL){
+                _GE_IMAGE_ERROR(GE_E_OUT_OF_MEM);
             }
+            ge_deflate_set_output(&deflate, window, _GE_IMAGE_WINDOW_SIZE,
+                                  _ge_image_rows, &decoder);
             
             ihdr_found = 1;
         }else if(!memcmp(type, "PLTE", 4)){
-            puts("Palette found!");
-            if(chunk_len > (size_t)((1<<bit_depth)*3) || chunk_len%3){
-                puts("Bad palette size");
+            if(chunk_len > 256*3 || chunk_len%3){
+                fputs("Bad palette size!\n", stderr);
                 _GE_IMAGE_ERROR(GE_E_CORRUPTED_PLTE);
             }
             palette_size = chunk_len/3;
             memcpy(palette, data+i, chunk_len);
-            i += chunk_len;
+        }else if(!memcmp(type, "tRNS", 4)){
+            /* Transparency */
+            trns_size = chunk_len < 256 ? chunk_len : 256;
+            memcpy(trns, data+i, trns_size);
         }else if(!memcmp(type, "IDAT", 4)){
-            puts("Image data found!");
-            if(i+chunk_len > size){
-                fputs("Image too small!\n", stderr);
-                _GE_IMAGE_ERROR(GE_E_PNG_TOO_SMALL);
+            if(!idat_found){
+                rc = _ge_image_decoder_lut(&decoder, palette, palette_size,
+                                           trns, trns_size);
+                if(rc){
+                    _GE_IMAGE_ERROR(rc);
+                }
+                idat_found = 1;
             }
-            printf("i: %d\n", i);
-            if(ge_deflate_decompress(&deflate, data+i, chunk_len)){
+            rc = ge_deflate_decompress(&deflate, data+i, chunk_len);
+            if(rc){
                 fputs("Decompression failed!\n", stderr);
-                _GE_IMAGE_ERROR(GE_E_DECOMPRESSION_FAILED);
+                _GE_IMAGE_ERROR(rc);
             }
-            i += chunk_len;
         }else if(!memcmp(type, "IEND", 4)){
-            puts("Image end found!");
             /* The IEND chunk should be empty */
             if(chunk_len != 0){
                 _GE_IMAGE_ERROR(GE_E_CORRUPTED_IEND);
             }
+            if(!deflate.adler32_found || !decoder.done){
+                fputs("Incomplete image data!\n", stderr);
+                _GE_IMAGE_ERROR(GE_E_DECOMPRESSION_FAILED);
+            }
             iend_found = 1;
         }else{
             if(isupper(type[0])){
@@ -311,33 +943,376 @@ int ge_image_init(GEImage *image, char *file) {
             if(isupper(type[1])){
                 /* It is a standardized chunk */
             }
-            i += chunk_len;
-        }
-        
-        /* The IHDR chunk should be the first chunk */
-        if(!chunk && !ihdr_found){
-            fputs("IHDR chunk not found!\n", stderr);
-            _GE_IMAGE_ERROR(GE_E_IHDR_NOT_FOUND);
         }
-        
-        /* Check if the checksum is correct */
-        /* TODO */
+        i += chunk_len;
         i += 4;
         
-        chunk++;
-        
         /* The IEND chunk marks the end of a PNG file */
         if(iend_found) break;
     }
     
-    free(data);
+    if(!iend_found){
+        fputs("IEND chunk not found!\n", stderr);
+        _GE_IMAGE_ERROR(GE_E_PNG_TOO_SMALL);
+    }
+    
+    /* The image is always decoded to 8-bit RGBA */
+    image->width = decoder.width;
+    image->height = decoder.height;
+    image->bit_depth = 8;
+    image->color_type = _GE_IMAGE_RGBA;
+    image->data = decoder.out;
+    image->rows = NULL;
+    image->row_bytes = decoder.pitch;
+    image->data_width = decoder.data_width;
+    image->data_height = decoder.data_height;
+    image->flip = decoder.flip;
+    
+    ge_file_unmap(&png);
+    free(decoder.rows);
+    free(window);
     ge_deflate_free(&deflate);
     
-    return GE_E_UNKNOWN;
+    return GE_E_NONE;
 }
 
 #endif
 
+int ge_image_init(GEImage *image, char *file) {
+    image->format = GE_IMAGE_FORMAT_RGBA8;
+    image->levels = 1;
+    image->file.data = NULL;
+    return _ge_image_open(image, file, 0, 0);
+}
+
+int ge_image_init_texture(GEImage *image, char *file, int flip) {
+    image->format = GE_IMAGE_FORMAT_RGBA8;
+    image->levels = 1;
+    image->file.data = NULL;
+    return _ge_image_open(image, file, 1, flip);
+}
+
+#define _GE_IMAGE_GETEX_VERSION 2
+#define _GE_IMAGE_GETEX_TMP ".tmp"
+
+/* The header at the start of a .getex file, followed by the mip levels from
+ * the largest to the smallest, as RGBA rows or ETC1 blocks of the size of
+ * the level. The files are converted for the machine that loads them, so
+ * everything is stored in the native byte order. */
+typedef struct {
+    /* "GETEX", the version of the format and sizeof(unsigned long) */
+    char magic[8];
+    unsigned long int width;
+    unsigned long int height;
+    unsigned long int data_width;
+    unsigned long int data_height;
+    unsigned long int format;
+    unsigned long int levels;
+    unsigned long int flip;
+} GEImageGetexHeader;
+
+static void _ge_image_getex_magic(char *magic) {
+    memcpy(magic, "GETEX", 5);
+    magic[5] = 0;
+    magic[6] = _GE_IMAGE_GETEX_VERSION;
+    magic[7] = sizeof(unsigned long int);
+}
+
+size_t ge_image_level_size(int format, int width, int height) {
+    if(format == GE_IMAGE_FORMAT_ETC1) return ge_etc1_size(width, height);
+    return (size_t)width*height*4;
+}
+
+/* Returns the number of bytes taken by the first levels mip levels of a
+ * texture of width*height pixels. */
+static size_t _ge_image_levels_size(int format, int width, int height,
+                                    size_t levels) {
+    size_t bytes = 0;
+    for(;levels--;){
+        bytes += ge_image_level_size(format, width, height);
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    return bytes;
+}
+
+void ge_image_levels(GEImage *image, GEImage *view, int first) {
+    int i;
+    *view = *image;
+    for(i=0;i<first;i++){
+        view->data += ge_image_level_size(view->format, view->data_width,
+                                          view->data_height);
+        view->data_width = view->data_width > 1 ? view->data_width/2 : 1;
+        view->data_height = view->data_height > 1 ? view->data_height/2 : 1;
+        /* Round up to keep the padding of the level in proportion */
+        view->width = (view->width+1)/2;
+        view->height = (view->height+1)/2;
+    }
+    view->levels -= first;
+    if(view->format == GE_IMAGE_FORMAT_ETC1){
+        view->row_bytes = ge_etc1_size(view->data_width, 4);
+    }else{
+        view->row_bytes = (long)view->data_width*4;
+    }
+}
+
+/* Returns 1 if num is a power of two */
+static int _ge_image_power_of_two(unsigned long int num) {
+    return num && !(num&(num-1));
+}
+
+int ge_image_init_getex(GEImage *image, char *file) {
+    GEImageGetexHeader *header;
+    char magic[8];
+    
+    if(ge_file_map(&image->file, file, 0)){
+        image->file.data = NULL;
+        return GE_E_FILE;
+    }
+    header = image->file.data;
+    _ge_image_getex_magic(magic);
+    if(image->file.size < sizeof(GEImageGetexHeader) ||
+       memcmp(header->magic, magic, 8) ||
+       (header->format != GE_IMAGE_FORMAT_RGBA8 &&
+        header->format != GE_IMAGE_FORMAT_ETC1) ||
+       !header->width || !header->height ||
+       header->data_width > 1<<30 || header->data_height > 1<<30 ||
+       header->data_width < header->width ||
+       header->data_height < header->height){
+        ge_file_unmap(&image->file);
+        image->file.data = NULL;
+        return GE_E_GETEX_INVALID;
+    }
+    /* Only complete mip chains of power of two sizes can be used */
+    if((header->levels != 1 &&
+        (header->levels != (unsigned long int)
+                           ge_mipmap_levels(header->data_width,
+                                            header->data_height) ||
+         !_ge_image_power_of_two(header->data_width) ||
+         !_ge_image_power_of_two(header->data_height))) ||
+       header->data_width > (size_t)-1/4/header->data_height ||
+       _ge_image_levels_size(header->format, header->data_width,
+                             header->data_height, header->levels) >
+       image->file.size-sizeof(GEImageGetexHeader)){
+        ge_file_unmap(&image->file);
+        image->file.data = NULL;
+        return GE_E_GETEX_INVALID;
+    }
+    
+    image->width = header->width;
+    image->height = header->height;
+    image->bit_depth = 8;
+    image->color_type = 6; /* RGBA */
+    image->data = (unsigned char*)image->file.data+
+                  sizeof(GEImageGetexHeader);
+    image->rows = NULL;
+    image->format = header->format;
+    image->data_width = header->data_width;
+    image->data_height = header->data_height;
+    /* The rows of ETC1 images are rows of blocks */
+    if(image->format == GE_IMAGE_FORMAT_ETC1){
+        image->row_bytes = ge_etc1_size(image->data_width, 4);
+    }else{
+        image->row_bytes = (long)image->data_width*4;
+    }
+    image->flip = header->flip != 0;
+    image->levels = header->levels;
+    
+    return GE_E_NONE;
+}
+
+/* _ge_image_copy_etc1
+ *
+ * Decode the blocks of an ETC1 image that contain a rectangle, and copy the
+ * pixels of the rectangle as ge_image_copy_region does.
+ *
+ * image:  The ETC1 image to copy.
+ * out:    The width*height RGBA pixels of the texture.
+ * width:  The width of the texture.
+ * height: The height of the texture.
+ * flip:   Store the rows from the bottom of the texture.
+ * x:      The position of the rectangle on the X axis, in the image.
+ * y:      The position of the rectangle on the Y axis, in the image.
+ * w:      The width of the rectangle, that has to be inside of the image.
+ * h:      The height of the rectangle, that has to be inside of the image.
+ */
+static void _ge_image_copy_etc1(GEImage *image, unsigned char *out,
+                                int width, int height, int flip, int x,
+                                int y, int w, int h) {
+    unsigned char block[4*4*4];
+    unsigned char *dst;
+    int data_width = image->data_width ? image->data_width :
+                                         (int)image->width;
+    int data_height = image->data_height ? image->data_height :
+                                           (int)image->height;
+    int blocks_w = (data_width+3)/4;
+    int first, last;
+    int bx, by;
+    int row, i, n;
+    
+    /* The rows of the rectangle in the compressed data, that are stored from
+     * the bottom if the image is flipped */
+    first = image->flip ? data_height-y-h : y;
+    last = first+h-1;
+    for(by=first/4*4;by<=last;by+=4){
+        for(bx=x/4*4;bx<x+w;bx+=4){
+            ge_etc1_decode(block, 4*4, image->data+
+                           ((size_t)(by/4)*blocks_w+bx/4)*GE_ETC1_BLOCK_SIZE,
+                           4, 4);
+            for(n=0;n<4;n++){
+                row = by+n;
+                if(row < first || row > last) continue;
+                i = image->flip ? data_height-1-row : row;
+                dst = out+(size_t)(flip ? height-1-i : i)*width*4;
+                for(i=0;i<4;i++){
+                    if(bx+i < x || bx+i >= x+w) continue;
+                    memcpy(dst+(size_t)(bx+i)*4, block+(n*4+i)*4, 4);
+                }
+            }
+        }
+    }
+}
+
+void ge_image_copy_texture(GEImage *image, unsigned char *out, int width,
+                           int height, int flip) {
+    ge_image_copy_region(image, out, width, height, flip, 0, 0, image->width,
+                         image->height);
+}
+
+void ge_image_copy_region(GEImage *image, unsigned char *out, int width,
+                          int height, int flip, int x, int y, int w, int h) {
+    size_t i, n;
+    size_t bytes;
+    unsigned char *row;
+    unsigned char *dst;
+    long pitch = (long)width*4;
+    
+    if(image->format == GE_IMAGE_FORMAT_ETC1){
+        _ge_image_copy_etc1(image, out, width, height, flip, x, y, w, h);
+        return;
+    }
+    if(image->data_width == width && image->data_height == height &&
+       !image->flip == !flip && (unsigned int)w == image->width &&
+       (unsigned int)h == image->height){
+        memcpy(out, image->data, (size_t)width*height*4);
+        return;
+    }
+    
+    bytes = image->data_width ? 4 : image->row_bytes/image->width;
+    for(i=y;i<(size_t)(y+h);i++){
+        row = image->data+(image->flip ? image->data_height-1-i : i)*
+                          image->row_bytes+x*bytes;
+        dst = out+(flip ? height-1-i : i)*pitch+x*4;
+        if(bytes == 4){
+            memcpy(dst, row, (size_t)w*4);
+            continue;
+        }
+        for(n=0;n<(size_t)w;n++,dst+=4,row+=bytes){
+            memcpy(dst, row, bytes <= 4 ? bytes : 4);
+            if(bytes < 4) memset(dst+bytes, 255, 4-bytes);
+        }
+    }
+}
+
+int ge_image_save_getex(GEImage *image, char *file, int flip, int mipmaps,
+                        int format, int quality) {
+    GEImageGetexHeader header;
+    unsigned char *data;
+    unsigned char *level;
+    unsigned char *compressed;
+    unsigned char *out;
+    int width, height;
+    size_t i;
+    size_t len;
+    char *path;
+    FILE *fp;
+    int failed;
+    int rc;
+    
+    memset(&header, 0, sizeof(GEImageGetexHeader));
+    _ge_image_getex_magic(header.magic);
+    header.width = image->width;
+    header.height = image->height;
+    /* The layout works on any backend, whatever the extensions it has */
+    width = image->width;
+    height = image->height;
+    if(mipmaps){
+        width = ge_utils_power_of_two(width);
+        height = ge_utils_power_of_two(height);
+    }
+    header.data_width = width;
+    header.data_height = height;
+    header.format = format;
+    header.levels = mipmaps ? ge_mipmap_levels(width, height) : 1;
+    header.flip = flip != 0;
+    
+    data = calloc(_ge_image_levels_size(GE_IMAGE_FORMAT_RGBA8, width, height,
+                                        header.levels), 1);
+    if(data == NULL) return GE_E_OUT_OF_MEM;
+    ge_image_copy_texture(image, data, width, height, flip);
+    if(mipmaps){
+        rc = ge_mipmap_chain(data, width, height, mipmaps);
+        if(rc){
+            free(data);
+            return rc;
+        }
+    }
+    
+    if(format == GE_IMAGE_FORMAT_ETC1){
+        compressed = malloc(_ge_image_levels_size(format, width, height,
+                                                  header.levels));
+        if(compressed == NULL){
+            free(data);
+            return GE_E_OUT_OF_MEM;
+        }
+        level = data;
+        out = compressed;
+        for(i=0;i<header.levels;i++){
+            ge_etc1_encode(out, level, (long)width*4, width, height,
+                           quality);
+            level += (size_t)width*height*4;
+            out += ge_image_level_size(format, width, height);
+            width = width > 1 ? width/2 : 1;
+            height = height > 1 ? height/2 : 1;
+        }
+        free(data);
+        data = compressed;
+    }
+    
+    len = strlen(file);
+    path = malloc(len+sizeof(_GE_IMAGE_GETEX_TMP));
+    if(path == NULL){
+        free(data);
+        return GE_E_OUT_OF_MEM;
+    }
+    memcpy(path, file, len);
+    memcpy(path+len, _GE_IMAGE_GETEX_TMP, sizeof(_GE_IMAGE_GETEX_TMP));
+    
+    /* Write it to a temporary file first, to never leave a partially written
+     * file behind. */
+    fp = fopen(path, "wb");
+    if(fp == NULL){
+        free(path);
+        free(data);
+        return GE_E_FILE;
+    }
+    fwrite(&header, sizeof(GEImageGetexHeader), 1, fp);
+    fwrite(data, 1, _ge_image_levels_size(format, header.data_width,
+                                          header.data_height, header.levels),
+           fp);
+    failed = ferror(fp);
+    if(fclose(fp)) failed = 1;
+    if(failed || rename(path, file)){
+        remove(path);
+        free(path);
+        free(data);
+        return GE_E_FILE;
+    }
+    free(path);
+    free(data);
+    return GE_E_NONE;
+}
+
 int ge_image_empty(GEImage *image, int width, int height) {
     image->data = calloc(width*height*4, 1);
     if(image->data == NULL){
@@ -346,11 +1321,21 @@ int ge_image_empty(GEImage *image, int width, int height) {
     image->width = width;
     image->height = height;
     image->row_bytes = width*4;
+    image->format = GE_IMAGE_FORMAT_RGBA8;
+    image->data_width = image->data_height = 0;
+    image->flip = 0;
+    image->levels = 1;
+    image->file.data = NULL;
     return GE_E_NONE;
 }
 
 void ge_image_free(GEImage *image) {
-    free(image->data);
+    if(image->file.data != NULL){
+        ge_file_unmap(&image->file);
+        image->file.data = NULL;
+    }else{
+        free(image->data);
+    }
     image->data = NULL;
 }
 
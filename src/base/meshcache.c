@@ -0,0 +1,291 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <mibiengine2/base/meshcache.h>
+#include <mibiengine2/base/utils.h>
+#include <mibiengine2/base/file.h>
+
+#include <mibiengine2/errors.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define _GE_MESHCACHE_VERSION 1
+#define _GE_MESHCACHE_TMP ".tmp"
+/* The alignment of the arrays in the file */
+#define _GE_MESHCACHE_ALIGN 16
+#define _GE_MESHCACHE_ALIGNED(n) \
+    (((n)+_GE_MESHCACHE_ALIGN-1)/_GE_MESHCACHE_ALIGN*_GE_MESHCACHE_ALIGN)
+
+/* The header at the start of a .gemesh file. The file is only meant to be
+ * read on the machine that wrote it, so everything is stored in the native
+ * byte order. */
+typedef struct {
+    /* "GEMESH", the version of the format and sizeof(unsigned long) */
+    char magic[8];
+    unsigned long int source_size;
+    unsigned long int source_mtime;
+    unsigned long int source_hash;
+    unsigned long int vertex_num;
+    unsigned long int index_num;
+    unsigned long int item_sizes[GE_MESHCACHE_ITEM_NUM];
+    /* The position of the arrays from the start of the file */
+    unsigned long int vertex_offset;
+    unsigned long int index_offset;
+} GEMeshCacheHeader;
+
+static void _ge_meshcache_magic(char *magic) {
+    memcpy(magic, "GEMESH", 6);
+    magic[6] = _GE_MESHCACHE_VERSION;
+    magic[7] = sizeof(unsigned long int);
+}
+
+/* Returns the path of the cache file of file, with room to append
+ * _GE_MESHCACHE_TMP. */
+static char *_ge_meshcache_path(char *file) {
+    size_t len = strlen(file);
+    char *path;
+    path = malloc(len+sizeof(GE_MESHCACHE_EXT)+sizeof(_GE_MESHCACHE_TMP)-1);
+    if(path == NULL) return NULL;
+    memcpy(path, file, len);
+    memcpy(path+len, GE_MESHCACHE_EXT, sizeof(GE_MESHCACHE_EXT));
+    return path;
+}
+
+static unsigned long int _ge_meshcache_stride(unsigned long int *item_sizes) {
+    unsigned long int stride = 0;
+    size_t i;
+    for(i=0;i<GE_MESHCACHE_ITEM_NUM;i++) stride += item_sizes[i];
+    return stride;
+}
+
+/* Check that the arrays described by the header are inside of the file */
+static int _ge_meshcache_check(GEMeshCacheHeader *header, size_t size) {
+    unsigned long int vertex_size;
+    vertex_size = _ge_meshcache_stride(header->item_sizes)*sizeof(float);
+    if(!vertex_size || !header->item_sizes[0]) return 0;
+    if(header->vertex_offset%_GE_MESHCACHE_ALIGN ||
+       header->index_offset%_GE_MESHCACHE_ALIGN){
+        return 0;
+    }
+    if(header->vertex_offset > size || header->index_offset > size) return 0;
+    if(header->vertex_num > (size-header->vertex_offset)/vertex_size){
+        return 0;
+    }
+    if(header->index_num > (size-header->index_offset)/sizeof(unsigned int)){
+        return 0;
+    }
+    return 1;
+}
+
+/* Check that the cache was generated from the current source file. The
+ * modification time is only trusted if the cache was written after the
+ * second in which the source was last modified, because the source may have
+ * been modified again during the same second. */
+static int _ge_meshcache_up_to_date(GEMeshCacheHeader *header, char *file,
+                                    char *path, struct stat *st,
+                                    struct stat *cache_st) {
+    FILE *fp;
+    GEFile source;
+    size_t size;
+    unsigned long int hash;
+    GEMeshCacheHeader new_header;
+    
+    if(header->source_size != (unsigned long int)st->st_size) return 0;
+    if(header->source_mtime == (unsigned long int)st->st_mtime &&
+       st->st_mtime < cache_st->st_mtime){
+        return 1;
+    }
+    
+    /* The file may just have been touched or copied, compare its hash */
+    if(ge_file_map(&source, file, 0)) return 0;
+    size = source.size;
+    hash = ge_utils_adler32(source.data, size);
+    ge_file_unmap(&source);
+    if(size != header->source_size || hash != header->source_hash) return 0;
+    
+    /* Store the new modification time (which also updates the modification
+     * time of the cache), so that the file does not need to be hashed on the
+     * next run. */
+    new_header = *header;
+    new_header.source_mtime = st->st_mtime;
+    fp = fopen(path, "r+b");
+    if(fp != NULL){
+        fwrite(&new_header, sizeof(GEMeshCacheHeader), 1, fp);
+        fclose(fp);
+    }
+    return 1;
+}
+
+int ge_meshcache_load(GEMeshCache *cache, char *file) {
+    struct stat st;
+    struct stat cache_st;
+    GEMeshCacheHeader *header;
+    char magic[8];
+    char *path;
+    int fd;
+    size_t i;
+    int rc = GE_E_MESHCACHE_INVALID;
+    
+    cache->map = NULL;
+    if(stat(file, &st)) return GE_E_FILE;
+    path = _ge_meshcache_path(file);
+    if(path == NULL) return GE_E_OUT_OF_MEM;
+    fd = open(path, O_RDONLY);
+    if(fd < 0){
+        free(path);
+        return GE_E_FILE;
+    }
+    if(fstat(fd, &cache_st) ||
+       (size_t)cache_st.st_size < sizeof(GEMeshCacheHeader)){
+        close(fd);
+        free(path);
+        return GE_E_MESHCACHE_INVALID;
+    }
+    cache->map_size = cache_st.st_size;
+    cache->map = mmap(NULL, cache->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(cache->map == MAP_FAILED){
+        cache->map = NULL;
+        free(path);
+        return GE_E_FILE;
+    }
+    
+    header = cache->map;
+    _ge_meshcache_magic(magic);
+    if(!memcmp(header->magic, magic, 8) &&
+       _ge_meshcache_check(header, cache->map_size) &&
+       _ge_meshcache_up_to_date(header, file, path, &st, &cache_st)){
+        cache->vertices = (float*)((char*)cache->map+header->vertex_offset);
+        cache->indices = (unsigned int*)((char*)cache->map+
+                                         header->index_offset);
+        cache->vertex_num = header->vertex_num;
+        cache->index_num = header->index_num;
+        for(i=0;i<GE_MESHCACHE_ITEM_NUM;i++){
+            cache->item_sizes[i] = header->item_sizes[i];
+        }
+        rc = GE_E_NONE;
+    }
+    free(path);
+    if(rc) ge_meshcache_free(cache);
+    return rc;
+}
+
+/* Write size bytes of padding */
+static void _ge_meshcache_pad(FILE *fp, size_t size) {
+    static const char zeros[_GE_MESHCACHE_ALIGN] = {0};
+    fwrite(zeros, 1, size, fp);
+}
+
+int ge_meshcache_save(char *file, char *source, size_t source_size,
+                      float *vertices, size_t vertex_num, size_t *item_sizes,
+                      unsigned int *indices, size_t index_num) {
+    struct stat st;
+    GEMeshCacheHeader header;
+    char *path;
+    char *tmp_path;
+    FILE *fp;
+    size_t i;
+    size_t vertex_size;
+    int failed;
+    
+    if(stat(file, &st)) return GE_E_FILE;
+    
+    memset(&header, 0, sizeof(GEMeshCacheHeader));
+    _ge_meshcache_magic(header.magic);
+    header.source_size = source_size;
+    header.source_mtime = st.st_mtime;
+    header.source_hash = ge_utils_adler32((unsigned char*)source,
+                                          source_size);
+    header.vertex_num = vertex_num;
+    header.index_num = index_num;
+    for(i=0;i<GE_MESHCACHE_ITEM_NUM;i++){
+        header.item_sizes[i] = item_sizes[i];
+    }
+    vertex_size = vertex_num*_ge_meshcache_stride(header.item_sizes)*
+                  sizeof(float);
+    header.vertex_offset = _GE_MESHCACHE_ALIGNED(sizeof(GEMeshCacheHeader));
+    header.index_offset = _GE_MESHCACHE_ALIGNED(header.vertex_offset+
+                                                vertex_size);
+    
+    path = _ge_meshcache_path(file);
+    if(path == NULL) return GE_E_OUT_OF_MEM;
+    tmp_path = _ge_meshcache_path(file);
+    if(tmp_path == NULL){
+        free(path);
+        return GE_E_OUT_OF_MEM;
+    }
+    strcat(tmp_path, _GE_MESHCACHE_TMP);
+    
+    /* Write it to a temporary file first, to never leave a partially written
+     * cache behind. */
+    fp = fopen(tmp_path, "wb");
+    if(fp == NULL){
+        free(tmp_path);
+        free(path);
+        return GE_E_FILE;
+    }
+    fwrite(&header, sizeof(GEMeshCacheHeader), 1, fp);
+    _ge_meshcache_pad(fp, header.vertex_offset-sizeof(GEMeshCacheHeader));
+    fwrite(vertices, 1, vertex_size, fp);
+    _ge_meshcache_pad(fp, header.index_offset-header.vertex_offset-
+                      vertex_size);
+    fwrite(indices, sizeof(unsigned int), index_num, fp);
+    failed = ferror(fp);
+    if(fclose(fp)) failed = 1;
+    if(failed || rename(tmp_path, path)){
+        remove(tmp_path);
+        free(tmp_path);
+        free(path);
+        return GE_E_FILE;
+    }
+    free(tmp_path);
+    free(path);
+    return GE_E_NONE;
+}
+
+void ge_meshcache_free(GEMeshCache *cache) {
+    if(cache->map == NULL) return;
+    munmap(cache->map, cache->map_size);
+    cache->map = NULL;
+}
@@ -0,0 +1,387 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <mibiengine2/base/mipmap.h>
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <mibiengine2/errors.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define _GE_MIPMAP_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _GE_MIPMAP_NEON 1
+#endif
+
+#define _GE_MIPMAP_PI 3.14159265358979323846
+
+/* The number of taps of the Kaiser filter, centered between the two source
+ * pixels of each destination pixel. */
+#define _GE_MIPMAP_KAISER_TAPS 8
+/* The shape of the Kaiser window, higher values attenuate the aliasing more
+ * but blur more. */
+#define _GE_MIPMAP_KAISER_BETA 4.0
+
+/* The size of the table converting linear colors back to sRGB */
+#define _GE_MIPMAP_SRGB_SIZE 4096
+
+/* A separable filter halving the size of a level */
+typedef struct {
+    /* The offsets of the taps from the first source pixel of each
+     * destination pixel */
+    int offsets[_GE_MIPMAP_KAISER_TAPS];
+    float weights[_GE_MIPMAP_KAISER_TAPS];
+    int taps;
+    /* The value of each channel as it is filtered */
+    float linear[256];
+    /* The sRGB value of each linear color, or NULL to round the colors */
+    unsigned char *srgb;
+} GEMipmapFilter;
+
+int ge_mipmap_levels(int width, int height) {
+    int levels;
+    for(levels=1;width>1||height>1;levels++){
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    return levels;
+}
+
+size_t ge_mipmap_size(int width, int height) {
+    size_t bytes = (size_t)width*height*4;
+    while(width > 1 || height > 1){
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+        bytes += (size_t)width*height*4;
+    }
+    return bytes;
+}
+
+/* _ge_mipmap_box_row
+ *
+ * Compute a row of the next level with a box filter, each pixel being the
+ * average of 2x2 pixels.
+ *
+ * dst:   The row of the next level.
+ * row0:  The first row of the previous level.
+ * row1:  The second row of the previous level.
+ * width: The width of the next level.
+ * step:  The distance in pixels between the two columns averaged, 0 if the
+ *        previous level is a single column.
+ */
+static void _ge_mipmap_box_row(unsigned char *dst, unsigned char *row0,
+                               unsigned char *row1, size_t width,
+                               size_t step) {
+    size_t x = 0;
+    size_t c;
+#if _GE_MIPMAP_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i two = _mm_set1_epi16(2);
+    __m128i a, b;
+    __m128i lo, hi;
+    __m128i sum;
+    if(step){
+        /* Average 4x2 pixels into 2 pixels at a time */
+        for(;x+2<=width;x+=2,dst+=8,row0+=16,row1+=16){
+            a = _mm_loadu_si128((__m128i*)row0);
+            b = _mm_loadu_si128((__m128i*)row1);
+            lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                               _mm_unpacklo_epi8(b, zero));
+            hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                               _mm_unpackhi_epi8(b, zero));
+            sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi),
+                                _mm_unpackhi_epi64(lo, hi));
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+            _mm_storel_epi64((__m128i*)dst, _mm_packus_epi16(sum, sum));
+        }
+    }
+#elif _GE_MIPMAP_NEON
+    uint16x8_t lo, hi;
+    uint16x8_t sum;
+    uint8x16_t a, b;
+    if(step){
+        /* Average 4x2 pixels into 2 pixels at a time */
+        for(;x+2<=width;x+=2,dst+=8,row0+=16,row1+=16){
+            a = vld1q_u8(row0);
+            b = vld1q_u8(row1);
+            lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+            hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+            sum = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)),
+                               vadd_u16(vget_low_u16(hi),
+                                        vget_high_u16(hi)));
+            vst1_u8(dst, vrshrn_n_u16(sum, 2));
+        }
+    }
+#endif
+    step *= 4;
+    for(;x<width;x++,dst+=4,row0+=step*2,row1+=step*2){
+        for(c=0;c<4;c++){
+            dst[c] = (row0[c]+row0[step+c]+row1[c]+row1[step+c]+2)>>2;
+        }
+    }
+}
+
+static void _ge_mipmap_box(unsigned char *dst, unsigned char *src,
+                           size_t width, size_t height) {
+    size_t dst_width = width > 1 ? width/2 : 1;
+    size_t dst_height = height > 1 ? height/2 : 1;
+    size_t pitch = width*4;
+    size_t y;
+    for(y=0;y<dst_height;y++,dst+=dst_width*4){
+        _ge_mipmap_box_row(dst, src+y*2*pitch,
+                           src+(height > 1 ? y*2+1 : 0)*pitch, dst_width,
+                           width > 1);
+    }
+}
+
+/* Returns the modified Bessel function of the first kind of order 0 */
+static double _ge_mipmap_bessel(double x) {
+    double sum = 1;
+    double term = 1;
+    int k;
+    for(k=1;k<32;k++){
+        term *= x/(2*k);
+        sum += term*term;
+    }
+    return sum;
+}
+
+/* Returns the weight of the Kaiser filter at a distance in source pixels
+ * from the center of a destination pixel. */
+static double _ge_mipmap_kaiser(double distance) {
+    double t = distance/(_GE_MIPMAP_KAISER_TAPS/2);
+    double x = distance/2*_GE_MIPMAP_PI;
+    double sinc = x != 0 ? sin(x)/x : 1;
+    if(t >= 1 || t <= -1) return 0;
+    return sinc*_ge_mipmap_bessel(_GE_MIPMAP_KAISER_BETA*sqrt(1-t*t))/
+           _ge_mipmap_bessel(_GE_MIPMAP_KAISER_BETA);
+}
+
+/* _ge_mipmap_filter_init
+ *
+ * Initialize a filter.
+ *
+ * filter: The filter to initialize.
+ * type:   The filter type and flags, as passed to ge_mipmap_generate.
+ * srgb:   The space for the table converting linear colors back to sRGB.
+ */
+static void _ge_mipmap_filter_init(GEMipmapFilter *filter, int type,
+                                   unsigned char *srgb) {
+    double sum = 0;
+    double value;
+    int i;
+    if(type&GE_MIPMAP_KAISER){
+        filter->taps = _GE_MIPMAP_KAISER_TAPS;
+        for(i=0;i<filter->taps;i++){
+            filter->offsets[i] = i-filter->taps/2+1;
+            filter->weights[i] = _ge_mipmap_kaiser(filter->offsets[i]-0.5);
+            sum += filter->weights[i];
+        }
+        for(i=0;i<filter->taps;i++) filter->weights[i] /= sum;
+    }else{
+        filter->taps = 2;
+        filter->offsets[0] = 0;
+        filter->offsets[1] = 1;
+        filter->weights[0] = filter->weights[1] = 0.5;
+    }
+    filter->srgb = NULL;
+    for(i=0;i<256;i++) filter->linear[i] = i;
+    if(type&GE_MIPMAP_GAMMA){
+        /* Keep the linear colors between 0 and 255 */
+        for(i=0;i<256;i++){
+            value = i/255.0;
+            filter->linear[i] = (value <= 0.04045 ? value/12.92 :
+                                 pow((value+0.055)/1.055, 2.4))*255;
+        }
+        for(i=0;i<_GE_MIPMAP_SRGB_SIZE;i++){
+            value = i/(double)(_GE_MIPMAP_SRGB_SIZE-1);
+            value = value <= 0.0031308 ? value*12.92 :
+                    1.055*pow(value, 1/2.4)-0.055;
+            srgb[i] = (unsigned char)(value*255+0.5);
+        }
+        filter->srgb = srgb;
+    }
+}
+
+/* _ge_mipmap_sum
+ *
+ * Compute the weighted sum of some RGBA pixels stored as floats.
+ *
+ * out:     The resulting pixel.
+ * taps:    The pixel of each tap.
+ * weights: The weight of each tap.
+ * n:       The number of taps.
+ */
+static void _ge_mipmap_sum(float *out, float **taps, const float *weights,
+                           int n) {
+    int i;
+#if _GE_MIPMAP_SSE2
+    __m128 sum = _mm_setzero_ps();
+    for(i=0;i<n;i++){
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(taps[i]),
+                                         _mm_set1_ps(weights[i])));
+    }
+    _mm_storeu_ps(out, sum);
+#elif _GE_MIPMAP_NEON
+    float32x4_t sum = vdupq_n_f32(0);
+    for(i=0;i<n;i++){
+        sum = vmlaq_n_f32(sum, vld1q_f32(taps[i]), weights[i]);
+    }
+    vst1q_f32(out, sum);
+#else
+    int c;
+    for(c=0;c<4;c++) out[c] = 0;
+    for(i=0;i<n;i++){
+        for(c=0;c<4;c++) out[c] += taps[i][c]*weights[i];
+    }
+#endif
+}
+
+/* Returns the index of a source pixel, clamped to the edges */
+static size_t _ge_mipmap_clamp(long i, size_t size) {
+    if(i < 0) return 0;
+    if((size_t)i >= size) return size-1;
+    return i;
+}
+
+/* Convert a filtered channel back to 8 bits */
+static unsigned char _ge_mipmap_store(GEMipmapFilter *filter, float value,
+                                      int alpha) {
+    if(value <= 0) return 0;
+    if(value >= 255) return 255;
+    if(filter->srgb != NULL && !alpha){
+        return filter->srgb[(size_t)(value*((_GE_MIPMAP_SRGB_SIZE-1)/255.0)+
+                                     0.5)];
+    }
+    return (unsigned char)(value+0.5);
+}
+
+/* _ge_mipmap_separable
+ *
+ * Compute the next level with a separable filter, filtering the rows then
+ * the columns with the pixels stored as floats.
+ *
+ * dst:    The next level.
+ * src:    The previous level.
+ * width:  The width of the previous level.
+ * height: The height of the previous level.
+ * filter: The filter.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+static int _ge_mipmap_separable(unsigned char *dst, unsigned char *src,
+                                size_t width, size_t height,
+                                GEMipmapFilter *filter) {
+    size_t dst_width = width > 1 ? width/2 : 1;
+    size_t dst_height = height > 1 ? height/2 : 1;
+    float *row;
+    float *tmp;
+    float *taps[_GE_MIPMAP_KAISER_TAPS];
+    float pixel[4];
+    size_t x, y;
+    size_t c;
+    int i;
+    
+    /* The source row as floats, then the rows filtered horizontally */
+    row = malloc((width+dst_width*height)*4*sizeof(float));
+    if(row == NULL) return GE_E_OUT_OF_MEM;
+    tmp = row+width*4;
+    
+    for(y=0;y<height;y++){
+        for(x=0;x<width*4;x++,src++){
+            row[x] = (x&3) == 3 ? *src : filter->linear[*src];
+        }
+        for(x=0;x<dst_width;x++){
+            for(i=0;i<filter->taps;i++){
+                taps[i] = row+_ge_mipmap_clamp((long)x*2+filter->offsets[i],
+                                               width)*4;
+            }
+            _ge_mipmap_sum(tmp+(y*dst_width+x)*4, taps, filter->weights,
+                           filter->taps);
+        }
+    }
+    
+    for(y=0;y<dst_height;y++){
+        for(i=0;i<filter->taps;i++){
+            taps[i] = tmp+_ge_mipmap_clamp((long)y*2+filter->offsets[i],
+                                           height)*dst_width*4;
+        }
+        for(x=0;x<dst_width;x++){
+            _ge_mipmap_sum(pixel, taps, filter->weights, filter->taps);
+            for(i=0;i<filter->taps;i++) taps[i] += 4;
+            for(c=0;c<4;c++,dst++){
+                *dst = _ge_mipmap_store(filter, pixel[c], c == 3);
+            }
+        }
+    }
+    
+    free(row);
+    return GE_E_NONE;
+}
+
+int ge_mipmap_generate(unsigned char *dst, unsigned char *src, int width,
+                       int height, int filter) {
+    GEMipmapFilter separable;
+    unsigned char srgb[_GE_MIPMAP_SRGB_SIZE];
+    if(!(filter&(GE_MIPMAP_KAISER|GE_MIPMAP_GAMMA))){
+        _ge_mipmap_box(dst, src, width, height);
+        return GE_E_NONE;
+    }
+    _ge_mipmap_filter_init(&separable, filter, srgb);
+    return _ge_mipmap_separable(dst, src, width, height, &separable);
+}
+
+int ge_mipmap_chain(unsigned char *data, int width, int height, int filter) {
+    GEMipmapFilter separable;
+    unsigned char srgb[_GE_MIPMAP_SRGB_SIZE];
+    unsigned char *next;
+    int rc;
+    /* Only initialize the filter once for all the levels */
+    _ge_mipmap_filter_init(&separable, filter, srgb);
+    while(width > 1 || height > 1){
+        next = data+(size_t)width*height*4;
+        if(!(filter&(GE_MIPMAP_KAISER|GE_MIPMAP_GAMMA))){
+            _ge_mipmap_box(next, data, width, height);
+        }else{
+            rc = _ge_mipmap_separable(next, data, width, height, &separable);
+            if(rc) return rc;
+        }
+        data = next;
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    return GE_E_NONE;
+}
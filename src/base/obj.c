@@ -32,21 +32,56 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include <mibiengine2/base/obj.h>
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <limits.h>
 #include <math.h>
 
+#include <mibiengine2/config.h>
 #include <mibiengine2/errors.h>
 
+#if GE_OBJ_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 typedef struct {
     long vertex;
     long uv;
     long normal;
+    /* The indices that are relative to the start of their chunk (bit 0 for
+     * the vertex, bit 1 for the uv coordinates and bit 2 for the normal) */
+    unsigned char relative;
 } GEObjIndexGroup;
 
+/* A part of the file, parsed on its own thread */
+typedef struct {
+    char *start;
+    char *end;
+    
+    float *vertices;
+    float *uv;
+    float *normals;
+    GEObjIndexGroup *indices;
+    
+    size_t vertex_num;
+    size_t uv_num;
+    size_t normal_num;
+    size_t index_num;
+    
+    size_t vertex_max_num;
+    size_t uv_max_num;
+    size_t normal_max_num;
+    size_t index_max_num;
+    
+    int rc;
+} GEObjChunk;
+
 #define _GE_OBJ_FREE() \
     { \
         ge_obj_free(obj); \
@@ -70,10 +105,10 @@ typedef struct {
         normals = NULL; \
         free(indices); \
         indices = NULL; \
-        free(vertices_used); \
-        vertices_used = NULL; \
-        free(new_index); \
-        new_index = NULL; \
+        free(table); \
+        table = NULL; \
+        free(groups); \
+        groups = NULL; \
     }
 
 #define _GE_OBJ_RESIZE(ptr, sz, max, type, err) \
@@ -99,19 +134,38 @@ typedef struct {
         _GE_OBJ_GROW_IF_NEEDED(ptr, sz, max, type, err); \
     }
 
-#define _GE_OBJ_ATOI(s, n) sscanf(s, "%ld", &n)
-#define _GE_OBJ_FTOI(s, n) sscanf(s, "%f", &n)
-/* Convert vertex indices to GEObjIndexGroup */
-#define _GE_OBJ_VTOG(s, g) \
+#define _GE_OBJ_IS_SPACE(c) ((c) < 0x21 || (c) > 0x7e)
+#define _GE_OBJ_IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define _GE_OBJ_IS_KEYWORD(tok, tok_end, str) \
+    ((size_t)(tok_end-tok) == sizeof(str)-1 && \
+     !memcmp(tok, str, sizeof(str)-1))
+#define _GE_OBJ_FTOI(s, end, n) _ge_obj_parse_float(s, end, &n)
+
+/* Add an item to an array of the chunk being parsed */
+#define _GE_OBJ_CHUNK_ADD(ptr, sz, max, type, x) \
     { \
-        g.vertex = 0; \
-        g.uv = 0; \
-        g.normal = 0; \
-        sscanf(s, "%ld/%ld/%ld", &g.vertex, &g.uv, &g.normal); \
-        g.vertex--; \
-        g.uv--; \
-        g.normal--; \
+        ptr[sz] = x; \
+        _GE_OBJ_GROW(ptr, sz, max, type, { \
+            chunk->rc = GE_E_OUT_OF_MEM; \
+            return chunk; \
+        }); \
     }
+#define _GE_OBJ_ADD_VERTEX(x) \
+    _GE_OBJ_CHUNK_ADD(chunk->vertices, chunk->vertex_num, \
+                      chunk->vertex_max_num, float, x)
+#define _GE_OBJ_ADD_UV(x) \
+    _GE_OBJ_CHUNK_ADD(chunk->uv, chunk->uv_num, chunk->uv_max_num, float, x)
+#define _GE_OBJ_ADD_NORMAL(x) \
+    _GE_OBJ_CHUNK_ADD(chunk->normals, chunk->normal_num, \
+                      chunk->normal_max_num, float, x)
+#define _GE_OBJ_ADD_GROUP(x) \
+    _GE_OBJ_CHUNK_ADD(chunk->indices, chunk->index_num, \
+                      chunk->index_max_num, GEObjIndexGroup, x)
+
+/* The biggest mantissa that can still be multiplied by 10 */
+#define _GE_OBJ_MANTISSA_MAX ((ULONG_MAX-9)/10)
+/* The biggest integer that can still be multiplied by 10 */
+#define _GE_OBJ_LONG_MAX ((LONG_MAX-9)/10)
 
 #define _GE_OBJ_ADD(ptr, sz, max, type, x) \
     { \
@@ -123,46 +177,452 @@ typedef struct {
         }); \
     }
 
+static const double _ge_obj_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Parse an integer at s, without reading at or after end. Returns the
+ * position after the integer, or s if there is no integer. */
+static char *_ge_obj_parse_long(char *s, char *end, long *n) {
+    char *start = s;
+    long value = 0;
+    int neg = 0;
+    if(s < end && (*s == '-' || *s == '+')){
+        neg = *s == '-';
+        s++;
+    }
+    if(s >= end || !_GE_OBJ_IS_DIGIT(*s)) return start;
+    while(s < end && _GE_OBJ_IS_DIGIT(*s)){
+        /* Stop accumulating the digits of huge numbers, the indices are then
+         * out of range and get fixed */
+        if(value <= _GE_OBJ_LONG_MAX) value = value*10+(*s-'0');
+        s++;
+    }
+    *n = neg ? -value : value;
+    return s;
+}
+
+/* Parse a decimal floating point number at s, without reading at or after
+ * end. The digits are accumulated in an integer and scaled once by a power
+ * of ten, which is exact for the mantissas and exponents found in .obj
+ * files. Returns the position after the number, or s if there is no
+ * number. */
+static char *_ge_obj_parse_float(char *s, char *end, float *n) {
+    char *start = s;
+    unsigned long mantissa = 0;
+    int digits = 0;
+    int exp = 0;
+    long exp_value;
+    int neg = 0;
+    double value;
+    char *tmp;
+    if(s < end && (*s == '-' || *s == '+')){
+        neg = *s == '-';
+        s++;
+    }
+    for(;s<end && _GE_OBJ_IS_DIGIT(*s);s++,digits++){
+        /* Ignore the digits that don't fit in the mantissa */
+        if(mantissa <= _GE_OBJ_MANTISSA_MAX){
+            mantissa = mantissa*10+(*s-'0');
+        }else{
+            exp++;
+        }
+    }
+    if(s < end && *s == '.'){
+        for(s++;s<end && _GE_OBJ_IS_DIGIT(*s);s++,digits++){
+            if(mantissa <= _GE_OBJ_MANTISSA_MAX){
+                mantissa = mantissa*10+(*s-'0');
+                exp--;
+            }
+        }
+    }
+    if(!digits) return start;
+    if(s < end && (*s == 'e' || *s == 'E')){
+        tmp = _ge_obj_parse_long(s+1, end, &exp_value);
+        if(tmp != s+1){
+            if(exp_value > 1000) exp_value = 1000;
+            if(exp_value < -1000) exp_value = -1000;
+            exp += exp_value;
+            s = tmp;
+        }
+    }
+    value = (double)mantissa;
+    if(exp < 0){
+        value = exp >= -22 ? value/_ge_obj_pow10[-exp] : value*pow(10, exp);
+    }else if(exp > 0){
+        value = exp <= 22 ? value*_ge_obj_pow10[exp] : value*pow(10, exp);
+    }
+    *n = (float)(neg ? -value : value);
+    return s;
+}
+
+/* Parse a face vertex (v, v/vt, v//vn or v/vt/vn) into 0-based indices, or
+ * -1 for the missing ones. Negative indices count back from the number of
+ * vertices, uv coordinates or normals already parsed in the chunk, given in
+ * counts, and are flagged as relative to the start of the chunk. */
+static void _ge_obj_parse_group(char *s, char *end, GEObjIndexGroup *group,
+                                size_t *counts) {
+    long *values[3];
+    long value;
+    size_t i;
+    values[0] = &group->vertex;
+    values[1] = &group->uv;
+    values[2] = &group->normal;
+    group->vertex = group->uv = group->normal = -1;
+    group->relative = 0;
+    for(i=0;i<3;i++){
+        if(i){
+            if(s >= end || *s != '/') return;
+            s++;
+        }
+        value = 0;
+        s = _ge_obj_parse_long(s, end, &value);
+        if(value > 0){
+            *values[i] = value-1;
+        }else if(value < 0){
+            *values[i] = (long)counts[i]+value;
+            group->relative |= 1<<i;
+        }
+    }
+}
+
+static int _ge_obj_chunk_init(GEObjChunk *chunk, char *start, char *end) {
+    chunk->start = start;
+    chunk->end = end;
+    
+    chunk->vertices = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
+    chunk->uv = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
+    chunk->normals = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
+    chunk->indices = malloc(GE_OBJ_ALLOC_STEP*sizeof(GEObjIndexGroup));
+    
+    chunk->vertex_num = 0;
+    chunk->uv_num = 0;
+    chunk->normal_num = 0;
+    chunk->index_num = 0;
+    
+    chunk->vertex_max_num = GE_OBJ_ALLOC_STEP;
+    chunk->uv_max_num = GE_OBJ_ALLOC_STEP;
+    chunk->normal_max_num = GE_OBJ_ALLOC_STEP;
+    chunk->index_max_num = GE_OBJ_ALLOC_STEP;
+    
+    chunk->rc = GE_E_NONE;
+    if(chunk->vertices == NULL || chunk->uv == NULL ||
+       chunk->normals == NULL || chunk->indices == NULL){
+        chunk->rc = GE_E_OUT_OF_MEM;
+    }
+    return chunk->rc;
+}
+
+static void _ge_obj_chunk_free(GEObjChunk *chunk) {
+    free(chunk->vertices);
+    chunk->vertices = NULL;
+    free(chunk->uv);
+    chunk->uv = NULL;
+    free(chunk->normals);
+    chunk->normals = NULL;
+    free(chunk->indices);
+    chunk->indices = NULL;
+}
+
+/* Parse the lines of a chunk. It is the start routine of the threads. */
+static void *_ge_obj_parse(void *_chunk) {
+    GEObjChunk *chunk = _chunk;
+    /* The tokens of the current line, they point into the data */
+    char *line[GE_OBJ_TOK_MAX];
+    char *line_end[GE_OBJ_TOK_MAX];
+    size_t line_len;
+    size_t n;
+    size_t counts[3];
+    char *cur;
+    char *next;
+    char *end;
+    void *new;
+    
+    float tmp = 0;
+    GEObjIndexGroup gtmp;
+    
+    for(cur=chunk->start;cur<chunk->end;cur=next){
+        /* Find the end of the line */
+        end = memchr(cur, '\n', chunk->end-cur);
+        if(end == NULL) end = chunk->end;
+        next = end+1;
+        /* Ignore the comments */
+        n = end-cur;
+        end = memchr(cur, '#', n);
+        if(end == NULL) end = cur+n;
+        /* Split the line into tokens, without copying them */
+        line_len = 0;
+        while(cur < end){
+            while(cur < end && _GE_OBJ_IS_SPACE(*cur)) cur++;
+            if(cur >= end) break;
+            if(line_len < GE_OBJ_TOK_MAX) line[line_len] = cur;
+            while(cur < end && !_GE_OBJ_IS_SPACE(*cur)) cur++;
+            if(line_len < GE_OBJ_TOK_MAX) line_end[line_len] = cur;
+            line_len++;
+        }
+        if(!line_len) continue;
+        /* Decode the line */
+        if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "v")){
+            if(line_len == 4){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_FTOI(line[2], line_end[2], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_FTOI(line[3], line_end[3], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_ADD_VERTEX(1.0);
+            }else if(line_len == 5){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_FTOI(line[2], line_end[2], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_FTOI(line[3], line_end[3], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+                _GE_OBJ_FTOI(line[4], line_end[4], tmp);
+                _GE_OBJ_ADD_VERTEX(tmp);
+            }else{
+                /* Invalid data */
+#if GE_OBJ_DEBUG
+                fprintf(stderr, "Invalid vertex: length: %ld\n",
+                        line_len);
+#endif
+            }
+        }else if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "vt")){
+            if(line_len == 2){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+                _GE_OBJ_ADD_UV(1.0);
+                _GE_OBJ_ADD_UV(1.0);
+            }else if(line_len == 3){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+                _GE_OBJ_FTOI(line[2], line_end[2], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+                _GE_OBJ_ADD_UV(1.0);
+            }else if(line_len == 4){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+                _GE_OBJ_FTOI(line[2], line_end[2], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+                _GE_OBJ_FTOI(line[3], line_end[3], tmp);
+                _GE_OBJ_ADD_UV(tmp);
+            }else{
+                /* Invalid data */
+#if GE_OBJ_DEBUG
+                fprintf(stderr, "Invalid uv coordinate: length: %ld\n",
+                        line_len);
+#endif
+            }
+        }else if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "vn")){
+            if(line_len == 4){
+                _GE_OBJ_FTOI(line[1], line_end[1], tmp);
+                _GE_OBJ_ADD_NORMAL(tmp);
+                _GE_OBJ_FTOI(line[2], line_end[2], tmp);
+                _GE_OBJ_ADD_NORMAL(tmp);
+                _GE_OBJ_FTOI(line[3], line_end[3], tmp);
+                _GE_OBJ_ADD_NORMAL(tmp);
+            }else{
+                /* Invalid data */
+#if GE_OBJ_DEBUG
+                fprintf(stderr, "Invalid normal: length: %ld\n",
+                        line_len);
+#endif
+            }
+        }else if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "vp")){
+            /* TODO */
+#if GE_OBJ_DEBUG
+            fputs("Parameter space vertices are currently "
+                  "unsupported!", stderr);
+#endif
+        }else if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "f")){
+            /* TODO: Support other shapes than triangles */
+#if GE_OBJ_DEBUG
+            if(line_len > 4){
+                fputs("Other shapes than triangles are currently "
+                      "unsupported!", stderr);
+            }else if(line_len == 4){
+#else
+            if(line_len == 4){
+#endif
+                /* Load the triangle */
+                counts[0] = chunk->vertex_num/4;
+                counts[1] = chunk->uv_num/3;
+                counts[2] = chunk->normal_num/3;
+                for(n=1;n<4;n++){
+                    _ge_obj_parse_group(line[n], line_end[n], &gtmp, counts);
+                    _GE_OBJ_ADD_GROUP(gtmp);
+                }
+            }
+        }else if(_GE_OBJ_IS_KEYWORD(line[0], line_end[0], "l")){
+            /* TODO */
+#if GE_OBJ_DEBUG
+            fputs("Lines are currently unsupported!", stderr);
+#endif
+        }else{
+#if GE_OBJ_DEBUG
+            fprintf(stderr, "Unknown line starting with \"%.*s\"!\n",
+                    (int)(line_end[0]-line[0]), line[0]);
+#endif
+        }
+    }
+    chunk->rc = GE_E_NONE;
+    return chunk;
+}
+
+/* The number of chunks the data is split into */
+static size_t _ge_obj_chunk_num(size_t size) {
+#if GE_OBJ_THREADS
+    char *threads;
+    long thread_num = 1;
+    threads = getenv("GE_OBJ_THREADS");
+    if(threads){
+        thread_num = atol(threads);
+    }else{
+#ifdef _SC_NPROCESSORS_ONLN
+        thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    }
+    if(thread_num > GE_OBJ_THREAD_MAX) thread_num = GE_OBJ_THREAD_MAX;
+    if((size_t)thread_num > size/GE_OBJ_CHUNK_MIN){
+        thread_num = size/GE_OBJ_CHUNK_MIN;
+    }
+    if(thread_num < 1) thread_num = 1;
+    return thread_num;
+#else
+    (void)size;
+    return 1;
+#endif
+}
+
+/* Parse the chunks, on their own threads if possible */
+static void _ge_obj_parse_chunks(GEObjChunk *chunks, size_t chunk_num) {
+#if GE_OBJ_THREADS
+    pthread_t threads[GE_OBJ_THREAD_MAX];
+    unsigned char started[GE_OBJ_THREAD_MAX];
+    size_t i;
+    for(i=1;i<chunk_num;i++){
+        started[i] = !pthread_create(threads+i, NULL, _ge_obj_parse,
+                                     chunks+i);
+    }
+    _ge_obj_parse(chunks);
+    for(i=1;i<chunk_num;i++){
+        /* Parse it on this thread if the thread could not be created */
+        if(started[i]) pthread_join(threads[i], NULL);
+        else _ge_obj_parse(chunks+i);
+    }
+#else
+    size_t i;
+    for(i=0;i<chunk_num;i++) _ge_obj_parse(chunks+i);
+#endif
+}
+
+/* Concatenate the arrays of the chunks into the arrays of the first chunk,
+ * offsetting the relative indices by the number of items in the previous
+ * chunks. */
+static int _ge_obj_merge(GEObjChunk *chunks, size_t chunk_num) {
+    GEObjChunk merged;
+    GEObjChunk *chunk;
+    GEObjIndexGroup *group;
+    size_t i, n;
+    long vertex_base = 0;
+    long uv_base = 0;
+    long normal_base = 0;
+    
+    if(chunk_num < 2) return GE_E_NONE;
+    merged = chunks[0];
+    merged.vertex_max_num = merged.uv_max_num = 0;
+    merged.normal_max_num = merged.index_max_num = 0;
+    for(i=0;i<chunk_num;i++){
+        merged.vertex_max_num += chunks[i].vertex_num;
+        merged.uv_max_num += chunks[i].uv_num;
+        merged.normal_max_num += chunks[i].normal_num;
+        merged.index_max_num += chunks[i].index_num;
+    }
+    /* Keep room for one more item, like while parsing, which is also the
+     * placeholder used when there are no uv coords or no normals */
+    merged.vertex_max_num += 4;
+    merged.uv_max_num += 3;
+    merged.normal_max_num += 3;
+    merged.index_max_num++;
+    merged.vertices = malloc(merged.vertex_max_num*sizeof(float));
+    merged.uv = malloc(merged.uv_max_num*sizeof(float));
+    merged.normals = malloc(merged.normal_max_num*sizeof(float));
+    merged.indices = malloc(merged.index_max_num*sizeof(GEObjIndexGroup));
+    if(merged.vertices == NULL || merged.uv == NULL ||
+       merged.normals == NULL || merged.indices == NULL){
+        _ge_obj_chunk_free(&merged);
+        return GE_E_OUT_OF_MEM;
+    }
+    merged.vertex_num = merged.uv_num = merged.normal_num = 0;
+    merged.index_num = 0;
+    for(i=0;i<chunk_num;i++){
+        chunk = chunks+i;
+        memcpy(merged.vertices+merged.vertex_num, chunk->vertices,
+               chunk->vertex_num*sizeof(float));
+        memcpy(merged.uv+merged.uv_num, chunk->uv,
+               chunk->uv_num*sizeof(float));
+        memcpy(merged.normals+merged.normal_num, chunk->normals,
+               chunk->normal_num*sizeof(float));
+        group = merged.indices+merged.index_num;
+        memcpy(group, chunk->indices,
+               chunk->index_num*sizeof(GEObjIndexGroup));
+        if(i){
+            for(n=0;n<chunk->index_num;n++,group++){
+                if(!group->relative) continue;
+                if(group->relative&1) group->vertex += vertex_base;
+                if(group->relative&2) group->uv += uv_base;
+                if(group->relative&4) group->normal += normal_base;
+            }
+        }
+        merged.vertex_num += chunk->vertex_num;
+        merged.uv_num += chunk->uv_num;
+        merged.normal_num += chunk->normal_num;
+        merged.index_num += chunk->index_num;
+        vertex_base = merged.vertex_num/4;
+        uv_base = merged.uv_num/3;
+        normal_base = merged.normal_num/3;
+        _ge_obj_chunk_free(chunk);
+    }
+    chunks[0] = merged;
+    return GE_E_NONE;
+}
+
+static size_t _ge_obj_hash(GEObjIndexGroup *group) {
+    size_t h;
+    h = (size_t)group->vertex*73856093UL;
+    h ^= (size_t)group->uv*19349663UL;
+    h ^= (size_t)group->normal*83492791UL;
+    return h^(h>>16);
+}
+
 int ge_obj_init(GEObj *obj, char *data, size_t size) {
-    /* TODO: Support relative indices */
     size_t i;
     size_t n;
-    char line[GE_OBJ_TOK_MAX][GE_OBJ_TOK_SZ];
-    int in_comment = 0;
-    size_t line_len = 0;
-    int in_data = 1;
-    size_t token_pos = 0;
-    char c;
+    char *cur;
+    char *end;
+    char *data_end = data+size;
     void *new;
     float len;
+    int rc = GE_E_NONE;
     
-    float tmp;
-    GEObjIndexGroup gtmp;
+    GEObjChunk chunks[GE_OBJ_THREAD_MAX];
+    size_t chunk_num;
     
     float *vertices;
     float *uv;
     float *normals;
     GEObjIndexGroup *indices;
     
-    char *vertices_used = NULL;
-    size_t *new_index = NULL;
-    
-    size_t vertex_num = 0;
-    size_t uv_num = 0;
-    size_t normal_num = 0;
-    size_t index_num = 0;
+    size_t *table = NULL;
+    size_t table_size;
+    size_t h;
+    GEObjIndexGroup *groups = NULL;
     
-    size_t vertex_max_num = GE_OBJ_ALLOC_STEP;
-    size_t uv_max_num = GE_OBJ_ALLOC_STEP;
-    size_t normal_max_num = GE_OBJ_ALLOC_STEP;
-    size_t index_max_num = GE_OBJ_ALLOC_STEP;
-    
-    int found;
-    
-    vertices = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
-    uv = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
-    normals = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
-    indices = malloc(GE_OBJ_ALLOC_STEP*sizeof(GEObjIndexGroup));
+    size_t vertex_num;
+    size_t uv_num;
+    size_t normal_num;
+    size_t index_num;
     
     obj->vertices = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
     obj->uv_coords = malloc(GE_OBJ_ALLOC_STEP*sizeof(float));
@@ -179,161 +639,52 @@ int ge_obj_init(GEObj *obj, char *data, size_t size) {
     obj->normal_max_num = GE_OBJ_ALLOC_STEP;
     obj->index_max_num = GE_OBJ_ALLOC_STEP;
     
-    for(i=0;i<size;i++){
-        c = data[i];
-        if(c == '\n'){
-            if(line_len || token_pos){
-                if(in_data){
-                    line[line_len][token_pos] = '\0';
-                    line_len++;
-                    if(line_len >= GE_OBJ_TOK_MAX) line_len = GE_OBJ_TOK_MAX-1;
-                }
-                /* Decode the line */
-                if(!strcmp(line[0], "v")){
-                    if(line_len == 4){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[2], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[3], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, 1.0);
-                    }else if(line_len == 5){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[2], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[3], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[4], tmp);
-                        _GE_OBJ_ADD(vertices, vertex_num, vertex_max_num,
-                                    float, tmp);
-                    }else{
-                        /* Invalid data */
-#if GE_OBJ_DEBUG
-                        fprintf(stderr, "Invalid vertex: length: %ld\n",
-                                line_len);
-#endif
-                    }
-                }else if(!strcmp(line[0], "vt")){
-                    if(line_len == 2){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, 1.0);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, 1.0);
-                    }else if(line_len == 3){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                        _GE_OBJ_FTOI(line[2], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, 1.0);
-                    }else if(line_len == 4){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                        _GE_OBJ_FTOI(line[2], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                        _GE_OBJ_FTOI(line[3], tmp);
-                        _GE_OBJ_ADD(uv, uv_num, uv_max_num, float, tmp);
-                    }else{
-                        /* Invalid data */
-#if GE_OBJ_DEBUG
-                        fprintf(stderr, "Invalid uv coordinate: length: %ld\n",
-                                line_len);
-#endif
-                    }
-                }else if(!strcmp(line[0], "vn")){
-                    if(line_len == 4){
-                        _GE_OBJ_FTOI(line[1], tmp);
-                        _GE_OBJ_ADD(normals, normal_num, normal_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[2], tmp);
-                        _GE_OBJ_ADD(normals, normal_num, normal_max_num,
-                                    float, tmp);
-                        _GE_OBJ_FTOI(line[3], tmp);
-                        _GE_OBJ_ADD(normals, normal_num, normal_max_num,
-                                    float, tmp);
-                    }else{
-                        /* Invalid data */
-#if GE_OBJ_DEBUG
-                        fprintf(stderr, "Invalid normal: length: %ld\n",
-                                line_len);
-#endif
-                    }
-                }else if(!strcmp(line[0], "vp")){
-                    /* TODO */
-#if GE_OBJ_DEBUG
-                    fputs("Parameter space vertices are currently "
-                          "unsupported!", stderr);
-#endif
-                }else if(!strcmp(line[0], "f")){
-                    /* TODO: Support other shapes than triangles */
-#if GE_OBJ_DEBUG
-                    if(line_len > 4){
-                        fputs("Other shapes than triangles are currently "
-                              "unsupported!", stderr);
-                    }else if(line_len == 4){
-#else
-                    if(line_len == 4){
-#endif
-                        /* Load the triangle */
-                        _GE_OBJ_VTOG(line[1], gtmp);
-                        _GE_OBJ_ADD(indices, index_num, index_max_num,
-                                    GEObjIndexGroup, gtmp);
-                        _GE_OBJ_VTOG(line[2], gtmp);
-                        _GE_OBJ_ADD(indices, index_num, index_max_num,
-                                    GEObjIndexGroup, gtmp);
-                        _GE_OBJ_VTOG(line[3], gtmp);
-                        _GE_OBJ_ADD(indices, index_num, index_max_num,
-                                    GEObjIndexGroup, gtmp);
-                    }
-                }else if(!strcmp(line[0], "l")){
-                    /* TODO */
-#if GE_OBJ_DEBUG
-                    fputs("Lines are currently unsupported!", stderr);
-#endif
-                }else{
-#if GE_OBJ_DEBUG
-                    fprintf(stderr, "Unknown line starting with \"%s\"!\n",
-                            line[0]);
-#endif
-                }
-            }
-            /* Reset the position in the line */
-            line_len = 0;
-            token_pos = 0;
-            /* We're not in a comment anymore, if we were in a comment in the
-             * first place. */
-            in_comment = 0;
-            continue;
+    /* Split the data into chunks of whole lines, parse them in parallel and
+     * put the results back together in order. */
+    chunk_num = _ge_obj_chunk_num(size);
+    cur = data;
+    for(i=0;i<chunk_num;i++){
+        end = data_end;
+        if(i+1 < chunk_num){
+            end = data+size/chunk_num*(i+1);
+            if(end < cur) end = cur;
+            end = memchr(end, '\n', data_end-end);
+            end = end == NULL ? data_end : end+1;
         }
-        if(!in_comment){
-            if(c == '#'){
-                in_comment = 1;
-                continue;
-            }
-            if(c < 0x21 || c > 0x7e){
-                if(in_data && token_pos){
-                  line[line_len][token_pos] = '\0';
-                  line_len++;
-                  if(line_len >= GE_OBJ_TOK_MAX) line_len = GE_OBJ_TOK_MAX-1;
-                }
-                token_pos = 0;
-                in_data = 0;
-                continue;
-            }
-            line[line_len][token_pos] = c;
-            token_pos++;
-            if(token_pos >= GE_OBJ_TOK_SZ) token_pos = GE_OBJ_TOK_SZ-1;
-            in_data = 1;
+        if(_ge_obj_chunk_init(chunks+i, cur, end)) rc = GE_E_OUT_OF_MEM;
+        cur = end;
+    }
+    if(rc == GE_E_NONE){
+        _ge_obj_parse_chunks(chunks, chunk_num);
+        for(i=0;i<chunk_num;i++){
+            if(chunks[i].rc) rc = chunks[i].rc;
         }
     }
+    if(rc == GE_E_NONE) rc = _ge_obj_merge(chunks, chunk_num);
+    if(rc){
+        for(i=0;i<chunk_num;i++) _ge_obj_chunk_free(chunks+i);
+        ge_obj_free(obj);
+        return rc;
+    }
+    
+    vertices = chunks[0].vertices;
+    uv = chunks[0].uv;
+    normals = chunks[0].normals;
+    indices = chunks[0].indices;
+    
+    vertex_num = chunks[0].vertex_num;
+    uv_num = chunks[0].uv_num;
+    normal_num = chunks[0].normal_num;
+    index_num = chunks[0].index_num;
+    
+    /* Use a zero placeholder for the missing vertices, uv coords and
+     * normals, as the indices get fixed to 0 */
+    if(vertex_num < 4){
+        vertices[0] = vertices[1] = vertices[2] = vertices[3] = 0;
+    }
+    if(uv_num < 3) uv[0] = uv[1] = uv[2] = 0;
+    if(normal_num < 3) normals[0] = normals[1] = normals[2] = 0;
+    
     /* Normalize the normals */
     n = normal_num/3;
     for(i=0;i<n*3;i+=3){
@@ -344,10 +695,15 @@ int ge_obj_init(GEObj *obj, char *data, size_t size) {
         normals[i+2] /= len;
     }
     /* Generate the arrays in the GEObj struct */
-    /* TODO: Optimize this! */
-    vertices_used = calloc(vertex_num/4, 1);
-    new_index = calloc(index_num, sizeof(size_t));
-    if(vertices_used == NULL || new_index == NULL){
+    /* Each different (vertex, uv, normal) triple becomes a vertex. They are
+     * looked up in an open addressing hash table that is never more than half
+     * full, which stores the index of the vertex plus one (0 if the slot is
+     * empty), and groups stores the triple of each vertex. */
+    table_size = 1;
+    while(table_size < index_num*2) table_size <<= 1;
+    table = calloc(table_size, sizeof(size_t));
+    groups = malloc((index_num ? index_num : 1)*sizeof(GEObjIndexGroup));
+    if(table == NULL || groups == NULL){
         _GE_OBJ_FREE();
         _GE_OBJ_FREE_LOCAL();
         return GE_E_OUT_OF_MEM;
@@ -372,86 +728,52 @@ int ge_obj_init(GEObj *obj, char *data, size_t size) {
 #endif
             indices[i].normal = 0;
         }
-        /* If this vertice was already used, check if it must be added because
-         * it is using different normal or uv indices than the previous one */
-        if(vertices_used[indices[i].vertex]){
-            /* Search the previously added vertex or vertices with the same
-             * vertex index */
-            found = 0;
-            for(n=0;n<i;n++){
-                if(indices[n].vertex == indices[i].vertex &&
-                   indices[n].uv == indices[i].uv &&
-                   indices[n].normal == indices[i].normal){
-                    found = 1;
-                    break;
-                }
+        /* Search the vertex, it may have already been added */
+        h = _ge_obj_hash(indices+i)&(table_size-1);
+        while(table[h]){
+            n = table[h]-1;
+            if(groups[n].vertex == indices[i].vertex &&
+               groups[n].uv == indices[i].uv &&
+               groups[n].normal == indices[i].normal){
+                break;
             }
-            if(found){
-                _GE_OBJ_ADD(obj->indices, obj->index_num, obj->index_max_num,
-                            float, new_index[n]);
-                new_index[i] = new_index[n];
-            }else{
-                /* Add the vertex and its index */
-                _GE_OBJ_ADD(obj->indices, obj->index_num, obj->index_max_num,
-                            float, obj->vertex_num/4);
-                new_index[i] = obj->vertex_num/4;
-                _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                            obj->vertex_max_num, float,
-                            vertices[indices[i].vertex*4]);
-                _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                            obj->vertex_max_num, float,
-                            vertices[indices[i].vertex*4+1]);
-                _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                            obj->vertex_max_num, float,
-                            vertices[indices[i].vertex*4+2]);
-                _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                            obj->vertex_max_num, float,
-                            vertices[indices[i].vertex*4+3]);
-                _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                            uv[indices[i].uv*3]);
-                _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                            uv[indices[i].uv*3+1]);
-                _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                            uv[indices[i].uv*3+2]);
-                _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                            float, normals[indices[i].normal*3]);
-                _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                            float, normals[indices[i].normal*3+1]);
-                _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                            float, normals[indices[i].normal*3+2]);
-            }
-        }else{
-            /* Add the vertex and its index */
+            h = (h+1)&(table_size-1);
+        }
+        if(table[h]){
             _GE_OBJ_ADD(obj->indices, obj->index_num, obj->index_max_num,
-                        float, obj->vertex_num/4);
-            new_index[i] = obj->vertex_num/4;
-            _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                        obj->vertex_max_num, float,
-                        vertices[indices[i].vertex*4]);
-            _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                        obj->vertex_max_num, float,
-                        vertices[indices[i].vertex*4+1]);
-            _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                        obj->vertex_max_num, float,
-                        vertices[indices[i].vertex*4+2]);
-            _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
-                        obj->vertex_max_num, float,
-                        vertices[indices[i].vertex*4+3]);
-            _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                        uv[indices[i].uv*3]);
-            _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                        uv[indices[i].uv*3+1]);
-            _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
-                        uv[indices[i].uv*3+2]);
-            _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                        float, normals[indices[i].normal*3]);
-            _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                        float, normals[indices[i].normal*3+1]);
-            _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
-                        float, normals[indices[i].normal*3+2]);
-            /* The vertex has been used */
-            vertices_used[indices[i].vertex] = 1;
+                        unsigned int, table[h]-1);
+            continue;
         }
+        /* Add the vertex and its index */
+        n = obj->vertex_num/4;
+        groups[n] = indices[i];
+        table[h] = n+1;
+        _GE_OBJ_ADD(obj->indices, obj->index_num, obj->index_max_num,
+                    unsigned int, n);
+        _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
+                    obj->vertex_max_num, float,
+                    vertices[indices[i].vertex*4]);
+        _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
+                    obj->vertex_max_num, float,
+                    vertices[indices[i].vertex*4+1]);
+        _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
+                    obj->vertex_max_num, float,
+                    vertices[indices[i].vertex*4+2]);
+        _GE_OBJ_ADD(obj->vertices, obj->vertex_num,
+                    obj->vertex_max_num, float,
+                    vertices[indices[i].vertex*4+3]);
+        _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
+                    uv[indices[i].uv*3]);
+        _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
+                    uv[indices[i].uv*3+1]);
+        _GE_OBJ_ADD(obj->uv_coords, obj->uv_num, obj->uv_max_num, float,
+                    uv[indices[i].uv*3+2]);
+        _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
+                    float, normals[indices[i].normal*3]);
+        _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
+                    float, normals[indices[i].normal*3+1]);
+        _GE_OBJ_ADD(obj->normals, obj->normal_num, obj->normal_max_num,
+                    float, normals[indices[i].normal*3+2]);
     }
 #if GE_OBJ_DEBUG
     printf("-- INDICES LOADED: %ld\n", obj->index_num);
@@ -51,36 +51,51 @@ void _ge_stdmodel_after_free(void *_model, void *extra) {
     model->extra[GE_STDMODEL_INHERIT_LEVEL] = NULL;
 }
 
-int ge_stdmodel_init(GEModel *model, void *indices, void *vertices,
-                     GEType index_type, GEType vertex_type, size_t index_num,
-                     size_t vertex_num, size_t item_size, int updatable,
-                     void *extra) {
+static GEStdModel *_ge_stdmodel_new(GEModel *model, void *indices,
+                                    void *vertices, GEType index_type,
+                                    GEType vertex_type, size_t index_num,
+                                    size_t vertex_num, size_t item_size,
+                                    int updatable, void *extra, int *rc) {
     size_t i;
     GEStdModel *stdmodel;
+    GEModelArrayAttr *attrs[GE_STDMODEL_ARRAY_NUM];
     
     stdmodel = malloc(sizeof(GEStdModel));
     if(stdmodel == NULL){
-        return GE_E_OUT_OF_MEM;
+        *rc = GE_E_OUT_OF_MEM;
+        return NULL;
     }
     
     /* TODO: Don't store updatable separately from model. */
     stdmodel->updatable = updatable;
+    stdmodel->interleaved = 0;
     
+    attrs[0] = &stdmodel->vertex_pos;
+    attrs[1] = &stdmodel->color_pos;
+    attrs[2] = &stdmodel->uv_pos;
+    attrs[3] = &stdmodel->normal_pos;
     for(i=0;i<GE_STDMODEL_ARRAY_NUM;i++){
         stdmodel->arrays[i] = NULL;
         stdmodel->array_attrs[i] = NULL;
+        attrs[i]->pos = -1;
+        attrs[i]->item_size = 0;
+        attrs[i]->stride = 0;
+        attrs[i]->offset = 0;
+        attrs[i]->next = NULL;
     }
     
     if(ge_modelarray_init(&stdmodel->vertex_array, vertices, vertex_type,
                           vertex_num, item_size, updatable)){
         free(stdmodel);
-        return GE_E_MODELARRAY_INIT;
+        *rc = GE_E_MODELARRAY_INIT;
+        return NULL;
     }
     if(ge_model_init(model, stdmodel->arrays, GE_STDMODEL_ARRAY_NUM,
                      indices, index_type, index_num, updatable, stdmodel)){
         ge_modelarray_free(&stdmodel->vertex_array);
         free(stdmodel);
-        return GE_E_MODEL_INIT;
+        *rc = GE_E_MODEL_INIT;
+        return NULL;
     }
     
     stdmodel->arrays[0] = &stdmodel->vertex_array;
@@ -88,13 +103,15 @@ int ge_stdmodel_init(GEModel *model, void *indices, void *vertices,
     if(ge_model_set_attr(model, &stdmodel->attr)){
         ge_model_free(model);
         free(stdmodel);
-        return GE_E_SET_ATTR;
+        *rc = GE_E_SET_ATTR;
+        return NULL;
     }
     if(ge_model_set_callbacks(model, NULL, NULL, NULL, _ge_stdmodel_after_free,
                               1)){
         ge_model_free(model);
         free(stdmodel);
-        return GE_E_SET_CALLBACKS;
+        *rc = GE_E_SET_CALLBACKS;
+        return NULL;
     }
 #if GE_STDMODEL_INHERIT_LEVEL+1 >= GE_MODEL_INHERIT_MAX
     Stop compiling right now!
@@ -102,9 +119,56 @@ int ge_stdmodel_init(GEModel *model, void *indices, void *vertices,
     model->extra[GE_STDMODEL_INHERIT_LEVEL+1] = extra;
     
     stdmodel->array_attrs[0] = &stdmodel->vertex_pos;
-    stdmodel->array_attrs[1] = NULL;
-    stdmodel->array_attrs[2] = NULL;
-    stdmodel->array_attrs[3] = NULL;
+    *rc = GE_E_NONE;
+    return stdmodel;
+}
+
+int ge_stdmodel_init(GEModel *model, void *indices, void *vertices,
+                     GEType index_type, GEType vertex_type, size_t index_num,
+                     size_t vertex_num, size_t item_size, int updatable,
+                     void *extra) {
+    int rc;
+    _ge_stdmodel_new(model, indices, vertices, index_type, vertex_type,
+                     index_num, vertex_num, item_size, updatable, extra, &rc);
+    return rc;
+}
+
+int ge_stdmodel_init_interleaved(GEModel *model, void *indices, void *data,
+                                 GEType index_type, GEType type,
+                                 size_t index_num, size_t vertex_num,
+                                 size_t *item_sizes, int updatable,
+                                 void *extra) {
+    size_t i, stride = 0, offset = 0;
+    int rc;
+    GEStdModel *stdmodel;
+    GEModelArrayAttr *attrs[GE_STDMODEL_ARRAY_NUM];
+    GEModelArrayAttr *last = NULL;
+    
+    for(i=0;i<GE_STDMODEL_ARRAY_NUM;i++) stride += item_sizes[i];
+    if(!item_sizes[0]) return GE_E_STDMODEL_INIT;
+    
+    stdmodel = _ge_stdmodel_new(model, indices, data, index_type, type,
+                                index_num, vertex_num*stride, stride,
+                                updatable, extra, &rc);
+    if(stdmodel == NULL) return rc;
+    stdmodel->interleaved = 1;
+    
+    attrs[0] = &stdmodel->vertex_pos;
+    attrs[1] = &stdmodel->color_pos;
+    attrs[2] = &stdmodel->uv_pos;
+    attrs[3] = &stdmodel->normal_pos;
+    /* Only the vertex array is used by the model, the other attributes are
+     * read from it after the vertex position. */
+    for(i=0;i<GE_STDMODEL_ARRAY_NUM;i++){
+        if(!item_sizes[i]) continue;
+        attrs[i]->item_size = item_sizes[i];
+        attrs[i]->stride = stride;
+        attrs[i]->offset = offset;
+        offset += item_sizes[i];
+        if(last != NULL) last->next = attrs[i];
+        last = attrs[i];
+        stdmodel->array_attrs[i] = attrs[i];
+    }
     return GE_E_NONE;
 }
 
@@ -163,18 +227,21 @@ int ge_stdmodel_update_vertices(GEModel *model, void *data, size_t size) {
 int ge_stdmodel_update_color(GEModel *model, void *data, size_t size) {
     GEStdModel *stdmodel = model->extra[GE_STDMODEL_INHERIT_LEVEL];
     if(stdmodel->array_attrs[1] == NULL) return GE_E_NOT_ADDED_YET;
+    if(stdmodel->interleaved) return GE_E_INTERLEAVED;
     return ge_modelarray_update(&stdmodel->color_array, data, size);
 }
 
 int ge_stdmodel_update_uv_coords(GEModel *model, void *data, size_t size) {
     GEStdModel *stdmodel = model->extra[GE_STDMODEL_INHERIT_LEVEL];
     if(stdmodel->array_attrs[2] == NULL) return GE_E_NOT_ADDED_YET;
+    if(stdmodel->interleaved) return GE_E_INTERLEAVED;
     return ge_modelarray_update(&stdmodel->uv_array, data, size);
 }
 
 int ge_stdmodel_update_normals(GEModel *model, void *data, size_t size) {
     GEStdModel *stdmodel = model->extra[GE_STDMODEL_INHERIT_LEVEL];
     if(stdmodel->array_attrs[3] == NULL) return GE_E_NOT_ADDED_YET;
+    if(stdmodel->interleaved) return GE_E_INTERLEAVED;
     return ge_modelarray_update(&stdmodel->normal_array, data, size);
 }
 
@@ -33,6 +33,8 @@
  */
 
 #include <mibiengine2/base/texture.h>
+#include <mibiengine2/base/texturemanager.h>
+#include <mibiengine2/base/texturestream.h>
 
 #include <mibiengine2/base/utils.h>
 
@@ -43,19 +45,91 @@
 #include <stdlib.h>
 #include <string.h>
 
-int ge_texture_init(GETexture *texture, GEImage *image, int linear, int flip) {
-    return GE_BACKENDLIST_GET(texture_init)(texture, image, linear, flip);
+int ge_texture_init(GETexture *texture, GEImage *image, int linear, int flip,
+                    int mipmap) {
+    texture->linear = linear;
+    texture->levels = 1;
+    texture->lod = 0;
+    texture->manager = NULL;
+    texture->last_use = 0;
+    texture->stream = NULL;
+    return GE_BACKENDLIST_GET(texture_init)(texture, image, linear, flip,
+                                            mipmap);
+}
+
+void ge_texture_layout(int width, int height, int mipmap, int *data_width,
+                       int *data_height) {
+    GE_BACKENDLIST_GET(texture_layout)(width, height, mipmap, data_width,
+                                       data_height);
+}
+
+int ge_texture_init_getex(GETexture *texture, char *file, int linear) {
+    GEImage image;
+    int rc;
+    rc = ge_image_init_getex(&image, file);
+    if(rc) return rc;
+    /* The texture doesn't need the file anymore once it is created */
+    rc = ge_texture_init(texture, &image, linear, image.flip,
+                         GE_MIPMAP_NONE);
+    ge_image_free(&image);
+    return rc;
 }
 
 int ge_texture_update(GETexture *texture, GEImage *image) {
+    int rc;
+    if(texture->stream != NULL){
+        ge_texture_stream_remove(texture);
+        /* The levels that didn't get streamed yet are replaced as well */
+        if(texture->lod > 0) texture->lod = 0;
+    }
+    if(texture->manager != NULL){
+        rc = ge_texture_manager_changed(texture);
+        if(rc) return rc;
+    }
     return GE_BACKENDLIST_GET(texture_update)(texture, image);
 }
 
+int ge_texture_update_region(GETexture *texture, GEImage *image, int x,
+                             int y, int w, int h) {
+    int rc;
+    /* Only keep the part of the rectangle that is inside of the image */
+    if(x < 0){
+        w += x;
+        x = 0;
+    }
+    if(y < 0){
+        h += y;
+        y = 0;
+    }
+    if(x >= (int)image->width || y >= (int)image->height) return GE_E_NONE;
+    if(w > (int)image->width-x) w = image->width-x;
+    if(h > (int)image->height-y) h = image->height-y;
+    if(w <= 0 || h <= 0) return GE_E_NONE;
+    if(texture->stream != NULL){
+        ge_texture_stream_remove(texture);
+        /* The levels that didn't get streamed yet are replaced as well */
+        if(texture->lod > 0) texture->lod = 0;
+    }
+    if(texture->manager != NULL){
+        rc = ge_texture_manager_changed(texture);
+        if(rc) return rc;
+    }
+    return GE_BACKENDLIST_GET(texture_update_region)(texture, image, x, y, w,
+                                                     h);
+}
+
 void ge_texture_use(GETexture *texture, GEShaderPos *pos, size_t n) {
+    if(texture->manager != NULL) ge_texture_manager_use(texture);
     GE_BACKENDLIST_GET(texture_use)(texture, pos, n);
 }
 
 void ge_texture_free(GETexture *texture) {
+    if(texture->stream != NULL) ge_texture_stream_remove(texture);
+    if(texture->manager != NULL){
+        /* The levels that are not on the GPU don't have to be loaded back */
+        texture->lod = 0;
+        ge_texture_manager_remove(texture);
+    }
     GE_BACKENDLIST_GET(texture_free)(texture);
 }
 
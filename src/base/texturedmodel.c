@@ -59,6 +59,26 @@ void _ge_textured_after_free(void *_model, void *extra) {
     model->extra[GE_TEXTUREDMODEL_INHERIT_LEVEL] = NULL;
 }
 
+/* Finish the initialization of a textured model once its stdmodel has been
+ * initialized with texturedmodel as its extra data. */
+static int _ge_texturedmodel_setup(GEModel *model, GETexture *texture,
+                                   GETexturedModel *texturedmodel,
+                                   void *extra) {
+    if(ge_model_set_callbacks(model, _ge_texturedmodel_before_rendering, NULL,
+                              NULL, _ge_textured_after_free, 1)){
+        ge_model_free(model);
+        free(texturedmodel);
+        return GE_E_SET_CALLBACKS;
+    }
+#if GE_TEXTUREDMODEL_INHERIT_LEVEL+1 >= GE_MODEL_INHERIT_MAX
+    Stop compiling right now!
+#endif
+    model->extra[GE_TEXTUREDMODEL_INHERIT_LEVEL+1] = extra;
+    texturedmodel->texture = texture;
+    texturedmodel->tex_pos = NULL;
+    return GE_E_NONE;
+}
+
 int ge_texturedmodel_init(GEModel *model, GETexture *texture, void *indices,
                           void *vertices, GEType index_type,
                           GEType vertex_type, size_t index_num,
@@ -74,19 +94,26 @@ int ge_texturedmodel_init(GEModel *model, GETexture *texture, void *indices,
         free(texturedmodel);
         return GE_E_STDMODEL_INIT;
     }
-    if(ge_model_set_callbacks(model, _ge_texturedmodel_before_rendering, NULL,
-                              NULL, _ge_textured_after_free, 1)){
-        ge_model_free(model);
+    return _ge_texturedmodel_setup(model, texture, texturedmodel, extra);
+}
+
+int ge_texturedmodel_init_interleaved(GEModel *model, GETexture *texture,
+                                      void *indices, void *data,
+                                      GEType index_type, GEType type,
+                                      size_t index_num, size_t vertex_num,
+                                      size_t *item_sizes, int updatable,
+                                      void *extra) {
+    GETexturedModel *texturedmodel = malloc(sizeof(GETexturedModel));
+    if(texturedmodel == NULL){
+        return GE_E_OUT_OF_MEM;
+    }
+    if(ge_stdmodel_init_interleaved(model, indices, data, index_type, type,
+                                    index_num, vertex_num, item_sizes,
+                                    updatable, texturedmodel)){
         free(texturedmodel);
-        return GE_E_SET_CALLBACKS;
+        return GE_E_STDMODEL_INIT;
     }
-#if GE_TEXTUREDMODEL_INHERIT_LEVEL+1 >= GE_MODEL_INHERIT_MAX
-    Stop compiling right now!
-#endif
-    model->extra[GE_TEXTUREDMODEL_INHERIT_LEVEL+1] = extra;
-    texturedmodel->texture = texture;
-    texturedmodel->tex_pos = NULL;
-    return GE_E_NONE;
+    return _ge_texturedmodel_setup(model, texture, texturedmodel, extra);
 }
 
 int ge_texturedmodel_set_texture(GEModel *model, GEShaderPos *tex_pos,
@@ -0,0 +1,306 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <mibiengine2/base/texturemanager.h>
+
+#include <mibiengine2/errors.h>
+#include <mibiengine2/config.h>
+
+#include <backendlist.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static GETextureEntry *_ge_texture_manager_find(GETexture *texture) {
+    GETextureManager *manager = texture->manager;
+    size_t i;
+    for(i=0;i<manager->entry_num;i++){
+        if(manager->entries[i].texture == texture) return manager->entries+i;
+    }
+    return NULL;
+}
+
+/* Update the number of bytes used by a texture */
+static void _ge_texture_manager_measure(GETextureManager *manager,
+                                        GETextureEntry *entry) {
+    manager->gpu -= entry->gpu;
+    manager->cpu -= entry->cpu;
+    GE_BACKENDLIST_GET(texture_memory)(entry->texture, &entry->gpu,
+                                       &entry->cpu);
+    manager->gpu += entry->gpu;
+    manager->cpu += entry->cpu;
+}
+
+/* Returns 1 if the pixels of a texture can be uploaded again */
+static int _ge_texture_manager_reloadable(GETextureEntry *entry) {
+    return entry->texture->data != NULL || entry->file != NULL;
+}
+
+/* Returns the max. number of levels of a texture that can be dropped */
+static int _ge_texture_manager_lod_max(GETexture *texture) {
+    int width = texture->data_width;
+    int height = texture->data_height;
+    int lod = 0;
+    while(lod+1 < texture->levels &&
+          (width/2 >= GE_TEXTURE_MANAGER_MIN_SIZE ||
+           height/2 >= GE_TEXTURE_MANAGER_MIN_SIZE)){
+        width /= 2;
+        height /= 2;
+        lod++;
+    }
+    return lod;
+}
+
+/* _ge_texture_manager_load
+ *
+ * Load a texture on the GPU without its first lod levels, or evict it. The
+ * pixels are loaded again from its file if the backend doesn't have a copy of
+ * them anymore.
+ *
+ * manager: The texture manager.
+ * entry:   The texture.
+ * lod:     The number of levels to drop, or GE_TEXTURE_EVICTED.
+ * Returns GE_E_NONE (0) on success or an error code on failure.
+ */
+static int _ge_texture_manager_load(GETextureManager *manager,
+                                    GETextureEntry *entry, int lod) {
+    GETexture *texture = entry->texture;
+    GEImage image;
+    size_t len;
+    int rc;
+    if(lod == GE_TEXTURE_EVICTED || texture->data != NULL){
+        rc = GE_BACKENDLIST_GET(texture_residency)(texture, NULL, lod);
+    }else{
+        if(entry->file == NULL) return GE_E_UNKNOWN;
+        len = strlen(entry->file);
+        if(len >= sizeof(GE_IMAGE_GETEX_EXT)-1 &&
+           !strcmp(entry->file+len-(sizeof(GE_IMAGE_GETEX_EXT)-1),
+                   GE_IMAGE_GETEX_EXT)){
+            rc = ge_image_init_getex(&image, entry->file);
+        }else{
+            rc = ge_image_init_texture(&image, entry->file, texture->flip);
+        }
+        if(rc) return rc;
+        rc = GE_BACKENDLIST_GET(texture_residency)(texture, &image, lod);
+        ge_image_free(&image);
+    }
+    _ge_texture_manager_measure(manager, entry);
+    return rc;
+}
+
+/* Returns the number of bytes a texture grows by when the last level that
+ * got dropped is loaded back, which has the same share of the size of the
+ * texture as it would have with RGBA pixels */
+static size_t _ge_texture_manager_growth(GETextureEntry *entry) {
+    GETexture *texture = entry->texture;
+    int width = texture->data_width;
+    int height = texture->data_height;
+    double level = 0;
+    double size = 0;
+    int i;
+    for(i=0;i<texture->levels;i++){
+        if(i == texture->lod-1) level = (double)width*height;
+        if(i >= texture->lod) size += (double)width*height;
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    if(size <= 0) return entry->gpu;
+    return (size_t)(entry->gpu*level/size);
+}
+
+static int _ge_texture_manager_compare(const void *a, const void *b) {
+    unsigned long int use_a = (*(GETextureEntry**)a)->texture->last_use;
+    unsigned long int use_b = (*(GETextureEntry**)b)->texture->last_use;
+    if(use_a < use_b) return -1;
+    return use_a > use_b;
+}
+
+int ge_texture_manager_init(GETextureManager *manager, size_t gpu_budget,
+                            size_t cpu_budget) {
+    manager->entries = NULL;
+    manager->order = NULL;
+    manager->entry_num = 0;
+    manager->entry_max = 0;
+    manager->gpu_budget = gpu_budget;
+    manager->cpu_budget = cpu_budget;
+    manager->gpu = 0;
+    manager->cpu = 0;
+    manager->frame = 0;
+    return GE_E_NONE;
+}
+
+int ge_texture_manager_add(GETextureManager *manager, GETexture *texture,
+                           char *file) {
+    GETextureEntry *entry;
+    void *new;
+    size_t max;
+    if(texture->manager != NULL) return GE_E_ALREADY_ADDED;
+    if(manager->entry_num >= manager->entry_max){
+        max = manager->entry_max ? manager->entry_max*2 : 16;
+        new = realloc(manager->entries, max*sizeof(GETextureEntry));
+        if(new == NULL) return GE_E_OUT_OF_MEM;
+        manager->entries = new;
+        new = realloc(manager->order, max*sizeof(GETextureEntry*));
+        if(new == NULL) return GE_E_OUT_OF_MEM;
+        manager->order = new;
+        manager->entry_max = max;
+    }
+    entry = manager->entries+manager->entry_num;
+    entry->file = NULL;
+    if(file != NULL){
+        entry->file = malloc(strlen(file)+1);
+        if(entry->file == NULL) return GE_E_OUT_OF_MEM;
+        strcpy(entry->file, file);
+    }
+    entry->texture = texture;
+    entry->gpu = 0;
+    entry->cpu = 0;
+    manager->entry_num++;
+    texture->manager = manager;
+    texture->last_use = manager->frame;
+    _ge_texture_manager_measure(manager, entry);
+    return GE_E_NONE;
+}
+
+int ge_texture_manager_use(GETexture *texture) {
+    GETextureEntry *entry;
+    texture->last_use = texture->manager->frame;
+    if(texture->lod != GE_TEXTURE_EVICTED) return GE_E_NONE;
+    entry = _ge_texture_manager_find(texture);
+    if(entry == NULL) return GE_E_NOT_ADDED_YET;
+    return _ge_texture_manager_load(texture->manager, entry, 0);
+}
+
+int ge_texture_manager_changed(GETexture *texture) {
+    GETextureEntry *entry = _ge_texture_manager_find(texture);
+    int rc = GE_E_NONE;
+    if(entry == NULL) return GE_E_NOT_ADDED_YET;
+    if(texture->lod) rc = _ge_texture_manager_load(texture->manager, entry, 0);
+    free(entry->file);
+    entry->file = NULL;
+    return rc;
+}
+
+int ge_texture_manager_update(GETextureManager *manager) {
+    GETextureEntry *entry;
+    GETexture *texture;
+    size_t i;
+    int lod_max;
+    int rc;
+    /* The textures may have been updated during the frame */
+    for(i=0;i<manager->entry_num;i++){
+        _ge_texture_manager_measure(manager, manager->entries+i);
+        manager->order[i] = manager->entries+i;
+    }
+    qsort(manager->order, manager->entry_num, sizeof(GETextureEntry*),
+          _ge_texture_manager_compare);
+    /* Evict the textures that didn't get used in this frame */
+    for(i=0;i<manager->entry_num && manager->gpu > manager->gpu_budget;i++){
+        entry = manager->order[i];
+        if(entry->texture->last_use == manager->frame) break;
+        if(!entry->gpu || !_ge_texture_manager_reloadable(entry)) continue;
+        rc = _ge_texture_manager_load(manager, entry, GE_TEXTURE_EVICTED);
+        if(rc) return rc;
+    }
+    /* Drop the first levels of the textures that are still used */
+    for(i=0;i<manager->entry_num && manager->gpu > manager->gpu_budget;i++){
+        entry = manager->order[i];
+        texture = entry->texture;
+        if(texture->lod == GE_TEXTURE_EVICTED ||
+           !_ge_texture_manager_reloadable(entry)){
+            continue;
+        }
+        lod_max = _ge_texture_manager_lod_max(texture);
+        while(texture->lod < lod_max &&
+              manager->gpu > manager->gpu_budget){
+            rc = _ge_texture_manager_load(manager, entry, texture->lod+1);
+            if(rc) return rc;
+        }
+    }
+    /* Load a level back for the most recently used textures that had levels
+     * dropped, if they fit in the budget */
+    for(i=manager->entry_num;i-- && manager->gpu <= manager->gpu_budget;){
+        entry = manager->order[i];
+        texture = entry->texture;
+        if(texture->last_use != manager->frame) break;
+        if(texture->lod <= 0 || !_ge_texture_manager_reloadable(entry) ||
+           _ge_texture_manager_growth(entry) >
+           manager->gpu_budget-manager->gpu){
+            continue;
+        }
+        rc = _ge_texture_manager_load(manager, entry, texture->lod-1);
+        if(rc) return rc;
+    }
+    /* Free the copies of the pixels on the CPU of the textures that can be
+     * loaded from their file again */
+    for(i=0;i<manager->entry_num && manager->cpu > manager->cpu_budget;i++){
+        entry = manager->order[i];
+        if(!entry->cpu || entry->file == NULL) continue;
+        GE_BACKENDLIST_GET(texture_release)(entry->texture);
+        _ge_texture_manager_measure(manager, entry);
+    }
+    manager->frame++;
+    return GE_E_NONE;
+}
+
+int ge_texture_manager_remove(GETexture *texture) {
+    GETextureManager *manager = texture->manager;
+    GETextureEntry *entry = _ge_texture_manager_find(texture);
+    int rc = GE_E_NONE;
+    if(entry == NULL) return GE_E_NOT_ADDED_YET;
+    if(texture->lod) rc = _ge_texture_manager_load(manager, entry, 0);
+    manager->gpu -= entry->gpu;
+    manager->cpu -= entry->cpu;
+    free(entry->file);
+    *entry = manager->entries[--manager->entry_num];
+    texture->manager = NULL;
+    return rc;
+}
+
+void ge_texture_manager_free(GETextureManager *manager) {
+    GETextureEntry *entry;
+    size_t i;
+    for(i=0;i<manager->entry_num;i++){
+        entry = manager->entries+i;
+        if(entry->texture->lod) _ge_texture_manager_load(manager, entry, 0);
+        entry->texture->manager = NULL;
+        free(entry->file);
+    }
+    free(manager->entries);
+    free(manager->order);
+    manager->entries = NULL;
+    manager->order = NULL;
+    manager->entry_num = 0;
+    manager->entry_max = 0;
+}
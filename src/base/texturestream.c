@@ -0,0 +1,370 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <mibiengine2/base/texturestream.h>
+
+#include <mibiengine2/errors.h>
+#include <mibiengine2/config.h>
+
+#include <backendlist.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#if GE_TEXTURE_STREAM_THREAD
+#include <pthread.h>
+#endif
+
+/* Reading a byte of every page of a mapped level makes the system load the
+ * whole level from the disk */
+#define _GE_TEXTURE_STREAM_PAGE 4096
+
+#if GE_TEXTURE_STREAM_THREAD
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    /* Signaled when there are levels to read or when the thread has to
+     * stop */
+    pthread_cond_t start;
+    /* Signaled when a level was read */
+    pthread_cond_t done;
+    /* The texture a level is being read of, or NULL */
+    GETexture *busy;
+    int quit;
+} GETextureStreamWorker;
+#endif
+
+static void _ge_texture_stream_lock(GETextureStream *stream) {
+#if GE_TEXTURE_STREAM_THREAD
+    GETextureStreamWorker *worker = stream->worker;
+    if(worker != NULL) pthread_mutex_lock(&worker->mutex);
+#else
+    (void)stream;
+#endif
+}
+
+static void _ge_texture_stream_unlock(GETextureStream *stream) {
+#if GE_TEXTURE_STREAM_THREAD
+    GETextureStreamWorker *worker = stream->worker;
+    if(worker != NULL) pthread_mutex_unlock(&worker->mutex);
+#else
+    (void)stream;
+#endif
+}
+
+/* Read a level of a texture from the disk */
+static void _ge_texture_stream_read(GEImage *image, int n) {
+    volatile unsigned char byte;
+    GEImage level;
+    size_t size;
+    size_t i;
+    ge_image_levels(image, &level, n);
+    size = ge_image_level_size(level.format, level.data_width,
+                               level.data_height);
+    for(i=0;i<size;i+=_GE_TEXTURE_STREAM_PAGE) byte = level.data[i];
+    if(size) byte = level.data[size-1];
+    (void)byte;
+}
+
+/* Returns the number of bytes uploaded for a texture that starts at the
+ * level first */
+static size_t _ge_texture_stream_size(GETextureStreamItem *item, int first) {
+    GEImage levels;
+    size_t bytes = 0;
+    int width, height;
+    int i;
+    ge_image_levels(&item->image, &levels, first);
+    width = levels.data_width;
+    height = levels.data_height;
+    for(i=0;i<levels.levels;i++){
+        bytes += ge_image_level_size(levels.format, width, height);
+        width = width > 1 ? width/2 : 1;
+        height = height > 1 ? height/2 : 1;
+    }
+    return bytes;
+}
+
+static GETextureStreamItem *_ge_texture_stream_find(GETextureStream *stream,
+                                                    GETexture *texture) {
+    size_t i;
+    for(i=0;i<stream->item_num;i++){
+        if(stream->items[i].texture == texture) return stream->items+i;
+    }
+    return NULL;
+}
+
+/* Stop streaming a texture, once its levels aren't being read anymore. The
+ * stream has to be locked. */
+static void _ge_texture_stream_drop(GETextureStream *stream,
+                                    GETextureStreamItem *item) {
+#if GE_TEXTURE_STREAM_THREAD
+    GETextureStreamWorker *worker = stream->worker;
+    while(worker != NULL && worker->busy == item->texture){
+        pthread_cond_wait(&worker->done, &worker->mutex);
+    }
+#endif
+    item->texture->stream = NULL;
+    ge_image_free(&item->image);
+    *item = stream->items[--stream->item_num];
+}
+
+#if GE_TEXTURE_STREAM_THREAD
+/* Returns the texture with the least detailed level left to read, or NULL */
+static GETextureStreamItem *_ge_texture_stream_next(GETextureStream *stream) {
+    GETextureStreamItem *next = NULL;
+    size_t i;
+    for(i=0;i<stream->item_num;i++){
+        if(stream->items[i].loaded > 0 &&
+           (next == NULL || stream->items[i].loaded > next->loaded)){
+            next = stream->items+i;
+        }
+    }
+    return next;
+}
+
+static void *_ge_texture_stream_work(void *arg) {
+    GETextureStream *stream = arg;
+    GETextureStreamWorker *worker = stream->worker;
+    GETextureStreamItem *item;
+    GEImage image;
+    int n;
+    pthread_mutex_lock(&worker->mutex);
+    while(!worker->quit){
+        item = _ge_texture_stream_next(stream);
+        if(item == NULL){
+            pthread_cond_wait(&worker->start, &worker->mutex);
+            continue;
+        }
+        n = item->loaded-1;
+        image = item->image;
+        worker->busy = item->texture;
+        pthread_mutex_unlock(&worker->mutex);
+        /* The file stays mapped while the texture is busy, but the item can
+         * move in the array */
+        _ge_texture_stream_read(&image, n);
+        pthread_mutex_lock(&worker->mutex);
+        item = _ge_texture_stream_find(stream, worker->busy);
+        if(item != NULL) item->loaded = n;
+        worker->busy = NULL;
+        pthread_cond_broadcast(&worker->done);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+    return NULL;
+}
+#endif
+
+int ge_texture_stream_init(GETextureStream *stream, size_t budget) {
+#if GE_TEXTURE_STREAM_THREAD
+    GETextureStreamWorker *worker;
+#endif
+    stream->items = NULL;
+    stream->item_num = 0;
+    stream->item_max = 0;
+    stream->budget = budget;
+    stream->worker = NULL;
+#if GE_TEXTURE_STREAM_THREAD
+    worker = malloc(sizeof(GETextureStreamWorker));
+    if(worker == NULL) return GE_E_OUT_OF_MEM;
+    worker->busy = NULL;
+    worker->quit = 0;
+    if(pthread_mutex_init(&worker->mutex, NULL)){
+        free(worker);
+        return GE_E_THREAD;
+    }
+    if(pthread_cond_init(&worker->start, NULL)){
+        pthread_mutex_destroy(&worker->mutex);
+        free(worker);
+        return GE_E_THREAD;
+    }
+    if(pthread_cond_init(&worker->done, NULL)){
+        pthread_cond_destroy(&worker->start);
+        pthread_mutex_destroy(&worker->mutex);
+        free(worker);
+        return GE_E_THREAD;
+    }
+    stream->worker = worker;
+    if(pthread_create(&worker->thread, NULL, _ge_texture_stream_work,
+                      stream)){
+        /* Read the levels in ge_texture_stream_update instead */
+        pthread_cond_destroy(&worker->done);
+        pthread_cond_destroy(&worker->start);
+        pthread_mutex_destroy(&worker->mutex);
+        free(worker);
+        stream->worker = NULL;
+    }
+#endif
+    return GE_E_NONE;
+}
+
+int ge_texture_stream_add(GETextureStream *stream, GETexture *texture,
+                          char *file, int linear) {
+    GETextureStreamItem *item;
+    GEImage image;
+    GEImage view;
+    void *new;
+    size_t max;
+    int lod = 0;
+    int rc;
+    rc = ge_image_init_getex(&image, file);
+    if(rc) return rc;
+    while(lod+1 < image.levels &&
+          ((image.data_width>>lod) > GE_TEXTURE_STREAM_SIZE ||
+           (image.data_height>>lod) > GE_TEXTURE_STREAM_SIZE)){
+        lod++;
+    }
+    /* Create the texture from the small levels, and then give it the size
+     * of the whole image */
+    ge_image_levels(&image, &view, lod);
+    rc = ge_texture_init(texture, &view, linear, image.flip, GE_MIPMAP_NONE);
+    if(rc){
+        ge_image_free(&image);
+        return rc;
+    }
+    if(lod){
+        rc = GE_BACKENDLIST_GET(texture_residency)(texture, &image, lod);
+    }
+    if(rc || texture->lod <= 0){
+        if(rc) ge_texture_free(texture);
+        ge_image_free(&image);
+        return rc;
+    }
+    _ge_texture_stream_lock(stream);
+    if(stream->item_num >= stream->item_max){
+        max = stream->item_max ? stream->item_max*2 : 16;
+        new = realloc(stream->items, max*sizeof(GETextureStreamItem));
+        if(new == NULL){
+            _ge_texture_stream_unlock(stream);
+            ge_texture_free(texture);
+            ge_image_free(&image);
+            return GE_E_OUT_OF_MEM;
+        }
+        stream->items = new;
+        stream->item_max = max;
+    }
+    item = stream->items+stream->item_num++;
+    item->texture = texture;
+    item->image = image;
+    item->lod = texture->lod;
+    item->loaded = texture->lod;
+    texture->stream = stream;
+#if GE_TEXTURE_STREAM_THREAD
+    if(stream->worker != NULL){
+        pthread_cond_signal(&((GETextureStreamWorker*)stream->worker)->start);
+    }
+#endif
+    _ge_texture_stream_unlock(stream);
+    return GE_E_NONE;
+}
+
+int ge_texture_stream_update(GETextureStream *stream) {
+    GETextureStreamItem *item;
+    GETexture *texture;
+    size_t spent = 0;
+    size_t bytes = 0;
+    size_t size;
+    size_t i;
+    int lod;
+    int rc = GE_E_NONE;
+    _ge_texture_stream_lock(stream);
+    for(i=0;i<stream->item_num;){
+        item = stream->items+i;
+        texture = item->texture;
+        if(stream->worker == NULL && item->loaded == item->lod &&
+           item->loaded > 0 && spent < stream->budget){
+            _ge_texture_stream_read(&item->image, --item->loaded);
+        }
+        /* Go up to the most detailed level that was read and fits in the
+         * budget, or at least one level if nothing was uploaded yet */
+        lod = item->lod;
+        while(lod > item->loaded && texture->lod == item->lod){
+            size = _ge_texture_stream_size(item, lod-1);
+            if(spent+size > stream->budget && (spent || lod < item->lod)){
+                break;
+            }
+            bytes = size;
+            lod--;
+        }
+        if(lod < item->lod){
+            /* Only this thread changes the items, the worker thread can read
+             * the levels in the meantime */
+            _ge_texture_stream_unlock(stream);
+            rc = GE_BACKENDLIST_GET(texture_residency)(texture, &item->image,
+                                                       lod);
+            _ge_texture_stream_lock(stream);
+            if(rc) break;
+            spent += bytes;
+            item->lod = texture->lod;
+        }
+        /* Stop streaming the textures that have all of their levels or
+         * that got changed by something else */
+        if(texture->lod != item->lod || item->lod <= 0){
+            _ge_texture_stream_drop(stream, item);
+            continue;
+        }
+        i++;
+    }
+    _ge_texture_stream_unlock(stream);
+    return rc;
+}
+
+void ge_texture_stream_remove(GETexture *texture) {
+    GETextureStream *stream = texture->stream;
+    GETextureStreamItem *item;
+    _ge_texture_stream_lock(stream);
+    item = _ge_texture_stream_find(stream, texture);
+    if(item != NULL) _ge_texture_stream_drop(stream, item);
+    _ge_texture_stream_unlock(stream);
+}
+
+void ge_texture_stream_free(GETextureStream *stream) {
+#if GE_TEXTURE_STREAM_THREAD
+    GETextureStreamWorker *worker = stream->worker;
+    if(worker != NULL){
+        pthread_mutex_lock(&worker->mutex);
+        worker->quit = 1;
+        pthread_cond_signal(&worker->start);
+        pthread_mutex_unlock(&worker->mutex);
+        pthread_join(worker->thread, NULL);
+        pthread_cond_destroy(&worker->done);
+        pthread_cond_destroy(&worker->start);
+        pthread_mutex_destroy(&worker->mutex);
+        free(worker);
+        stream->worker = NULL;
+    }
+#endif
+    while(stream->item_num) _ge_texture_stream_drop(stream, stream->items);
+    free(stream->items);
+    stream->items = NULL;
+    stream->item_max = 0;
+}
@@ -50,21 +50,244 @@ int ge_utils_power_of_two(int num) {
     return 1<<c;
 }
 
-/* longs are at least 32bits, ints can be smaller */
-unsigned long int ge_utils_adler32(unsigned char *data, size_t size) {
-    unsigned short int s1 = 1;
-    unsigned short int s2 = 0;
+#define _GE_UTILS_ADLER_BASE 65521UL
+/* Largest number of bytes that can be summed before s2 may overflow 32 bits
+ * and has to be reduced */
+#define _GE_UTILS_ADLER_NMAX 5552
+
+#define _GE_UTILS_CRC_POLY 0xEDB88320UL
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define _GE_UTILS_AVX2 1
+#define _GE_UTILS_ADLER_CHUNK 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define _GE_UTILS_SSE2 1
+#define _GE_UTILS_ADLER_CHUNK 16
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _GE_UTILS_NEON 1
+#define _GE_UTILS_ADLER_CHUNK 16
+#else
+#define _GE_UTILS_ADLER_CHUNK 1
+#endif
+
+/* Number of bytes summed between two reductions, a multiple of the size of
+ * the vectors */
+#define _GE_UTILS_ADLER_BLOCK \
+    (_GE_UTILS_ADLER_NMAX/_GE_UTILS_ADLER_CHUNK*_GE_UTILS_ADLER_CHUNK)
+
+/* Slicing-by-8 tables: _ge_utils_crc_table[k][n] is the CRC of the byte n
+ * followed by k zero bytes. They are filled on the first use. */
+static unsigned long int _ge_utils_crc_table[8][256];
+static int _ge_utils_crc_ready = 0;
+
+#if _GE_UTILS_AVX2
+
+static unsigned long int _ge_utils_hsum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned int)_mm_cvtsi128_si32(v);
+}
+
+static unsigned long int _ge_utils_hsum256(__m256i v) {
+    return _ge_utils_hsum(_mm_add_epi32(_mm256_castsi256_si128(v),
+                                        _mm256_extracti128_si256(v, 1)));
+}
+
+#elif _GE_UTILS_SSE2
+
+static unsigned long int _ge_utils_hsum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned int)_mm_cvtsi128_si32(v);
+}
+
+#elif _GE_UTILS_NEON
+
+static unsigned long int _ge_utils_hsum(uint32x4_t v) {
+    uint64x2_t sum = vpaddlq_u32(v);
+    return vgetq_lane_u64(sum, 0)+vgetq_lane_u64(sum, 1);
+}
+
+#endif
+
+#if _GE_UTILS_ADLER_CHUNK > 1
+
+/* _ge_utils_adler32_simd
+ *
+ * Add size bytes to the Adler-32 sums, a vector at a time. For each vector,
+ * s2 grows by the size of the vector times the sum of all the previous
+ * vectors and by the bytes of the vector weighted by their distance to its
+ * end.
+ *
+ * s1: The sum of the bytes.
+ * s2: The sum of the values of s1.
+ * data: The data.
+ * size: The size of the data, a multiple of _GE_UTILS_ADLER_CHUNK that is not
+ *       bigger than _GE_UTILS_ADLER_BLOCK.
+ */
+static void _ge_utils_adler32_simd(unsigned long int *s1,
+                                   unsigned long int *s2,
+                                   unsigned char *data, size_t size) {
     size_t i;
+#if _GE_UTILS_AVX2
+    __m256i zero = _mm256_setzero_si256();
+    __m256i ones = _mm256_set1_epi16(1);
+    __m256i weights = _mm256_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                      13, 14, 15, 16, 17, 18, 19, 20, 21, 22,
+                                      23, 24, 25, 26, 27, 28, 29, 30, 31, 32);
+    __m256i sum = zero;
+    __m256i prev = zero;
+    __m256i weighted = zero;
+    __m256i bytes;
+    
+    for(i=0;i<size;i+=32){
+        bytes = _mm256_loadu_si256((__m256i*)(data+i));
+        prev = _mm256_add_epi32(prev, sum);
+        sum = _mm256_add_epi32(sum, _mm256_sad_epu8(bytes, zero));
+        weighted = _mm256_add_epi32(weighted, _mm256_madd_epi16(
+                                    _mm256_maddubs_epi16(bytes, weights),
+                                    ones));
+    }
+    
+    *s2 += size**s1+32*_ge_utils_hsum256(prev)+_ge_utils_hsum256(weighted);
+    *s1 += _ge_utils_hsum256(sum);
+#elif _GE_UTILS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i weights_lo = _mm_set_epi16(9, 10, 11, 12, 13, 14, 15, 16);
+    __m128i weights_hi = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+    __m128i sum = zero;
+    __m128i prev = zero;
+    __m128i weighted = zero;
+    __m128i bytes;
+    
+    for(i=0;i<size;i+=16){
+        bytes = _mm_loadu_si128((__m128i*)(data+i));
+        prev = _mm_add_epi32(prev, sum);
+        sum = _mm_add_epi32(sum, _mm_sad_epu8(bytes, zero));
+        weighted = _mm_add_epi32(weighted, _mm_madd_epi16(
+                                 _mm_unpacklo_epi8(bytes, zero), weights_lo));
+        weighted = _mm_add_epi32(weighted, _mm_madd_epi16(
+                                 _mm_unpackhi_epi8(bytes, zero), weights_hi));
+    }
     
-    for(i=0;i<size;i++){
-        s1 += data[i];
-        s2 += s1;
-        s1 &= 0xFFFF;
-        s2 &= 0xFFFF;
+    *s2 += size**s1+16*_ge_utils_hsum(prev)+_ge_utils_hsum(weighted);
+    *s1 += _ge_utils_hsum(sum);
+#elif _GE_UTILS_NEON
+    static const unsigned char weight_values[16] = {
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    };
+    uint8x16_t weights = vld1q_u8(weight_values);
+    uint32x4_t sum = vdupq_n_u32(0);
+    uint32x4_t prev = vdupq_n_u32(0);
+    uint32x4_t weighted = vdupq_n_u32(0);
+    uint8x16_t bytes;
+    
+    for(i=0;i<size;i+=16){
+        bytes = vld1q_u8(data+i);
+        prev = vaddq_u32(prev, sum);
+        sum = vpadalq_u16(sum, vpaddlq_u8(bytes));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_low_u8(bytes),
+                                                  vget_low_u8(weights)));
+        weighted = vpadalq_u16(weighted, vmull_u8(vget_high_u8(bytes),
+                                                  vget_high_u8(weights)));
+    }
+    
+    *s2 += size**s1+16*_ge_utils_hsum(prev)+_ge_utils_hsum(weighted);
+    *s1 += _ge_utils_hsum(sum);
+#endif
+}
+
+#endif
+
+unsigned long int ge_utils_adler32(unsigned char *data, size_t size) {
+    return ge_utils_adler32_update(1, data, size);
+}
+
+/* longs are at least 32bits, ints can be smaller */
+unsigned long int ge_utils_adler32_update(unsigned long int adler,
+                                          unsigned char *data, size_t size) {
+    unsigned long int s1 = adler&0xFFFF;
+    unsigned long int s2 = (adler>>16)&0xFFFF;
+    size_t n;
+#if _GE_UTILS_ADLER_CHUNK > 1
+    size_t vec;
+#endif
+    
+    while(size){
+        n = size < _GE_UTILS_ADLER_BLOCK ? size : _GE_UTILS_ADLER_BLOCK;
+        size -= n;
+#if _GE_UTILS_ADLER_CHUNK > 1
+        vec = n-n%_GE_UTILS_ADLER_CHUNK;
+        _ge_utils_adler32_simd(&s1, &s2, data, vec);
+        data += vec;
+        n -= vec;
+#endif
+        for(;n;n--){
+            s1 += *data++;
+            s2 += s1;
+        }
+        s1 %= _GE_UTILS_ADLER_BASE;
+        s2 %= _GE_UTILS_ADLER_BASE;
     }
     return (s2<<16)|s1;
 }
 
+static void _ge_utils_crc_init(void) {
+    unsigned long int c;
+    unsigned int n, k;
+    
+    for(n=0;n<256;n++){
+        c = n;
+        for(k=0;k<8;k++){
+            c = c&1 ? _GE_UTILS_CRC_POLY^(c>>1) : c>>1;
+        }
+        _ge_utils_crc_table[0][n] = c;
+    }
+    for(n=0;n<256;n++){
+        c = _ge_utils_crc_table[0][n];
+        for(k=1;k<8;k++){
+            c = _ge_utils_crc_table[0][c&0xFF]^(c>>8);
+            _ge_utils_crc_table[k][n] = c;
+        }
+    }
+    _ge_utils_crc_ready = 1;
+}
+
+unsigned long int ge_utils_crc32(unsigned char *data, size_t size) {
+    return ge_utils_crc32_update(0, data, size);
+}
+
+unsigned long int ge_utils_crc32_update(unsigned long int crc,
+                                        unsigned char *data, size_t size) {
+    unsigned long int (*table)[256] = _ge_utils_crc_table;
+    unsigned long int c = ~crc&0xFFFFFFFFUL;
+    unsigned long int hi;
+    
+    if(!_ge_utils_crc_ready) _ge_utils_crc_init();
+    
+    /* Process 8 bytes at a time */
+    for(;size>=8;size-=8,data+=8){
+        c ^= (unsigned long int)data[0] | (unsigned long int)data[1]<<8 |
+             (unsigned long int)data[2]<<16 |
+             (unsigned long int)data[3]<<24;
+        hi = (unsigned long int)data[4] | (unsigned long int)data[5]<<8 |
+             (unsigned long int)data[6]<<16 |
+             (unsigned long int)data[7]<<24;
+        c = table[7][c&0xFF]^table[6][(c>>8)&0xFF]^
+            table[5][(c>>16)&0xFF]^table[4][c>>24]^
+            table[3][hi&0xFF]^table[2][(hi>>8)&0xFF]^
+            table[1][(hi>>16)&0xFF]^table[0][hi>>24];
+    }
+    for(;size;size--){
+        c = table[0][(c^*data++)&0xFF]^(c>>8);
+    }
+    
+    return ~c&0xFFFFFFFFUL;
+}
+
 int ge_utils_sort(void *data, size_t size, size_t item_size,
                   int cmp(const void *item1, const void *item2)) {
     size_t i, n;
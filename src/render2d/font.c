@@ -76,6 +76,7 @@ int ge_font_init(GEFont *font, GEImage *image, int variable_width,
     (void)min_char_width;
     
     font->charset = charset;
+    font->rect = NULL;
     font->char_spacing = char_spacing;
     font->line_spacing = line_spacing;
     
@@ -114,6 +115,10 @@ int ge_font_init(GEFont *font, GEImage *image, int variable_width,
     return GE_E_NONE;
 }
 
+void ge_font_set_rect(GEFont *font, GEAtlasRect *rect) {
+    font->rect = rect;
+}
+
 void ge_font_free(GEFont *font) {
     free(font->glyphs);
     font->glyphs = NULL;
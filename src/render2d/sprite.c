@@ -37,6 +37,12 @@
 
 int ge_sprite_init(GESprite *sprite, GETexture *texture, GEStdShader *shader,
                    float w, float h) {
+    return ge_sprite_init_rect(sprite, texture, NULL, shader, w, h);
+}
+
+int ge_sprite_init_rect(GESprite *sprite, GETexture *texture,
+                        GEAtlasRect *rect, GEStdShader *shader, float w,
+                        float h) {
     /* Model data */
     float vertices[4*2] = {
          0.5, -0.5,
@@ -66,6 +72,9 @@ int ge_sprite_init(GESprite *sprite, GETexture *texture, GEStdShader *shader,
     for(i=0;i<4*2;i+=2){
         vertices[i] *= w;
         vertices[i+1] *= h;
+        if(rect != NULL){
+            ge_atlas_uv(rect, uv_coords[i], uv_coords[i+1], uv_coords+i);
+        }
     }
     
     /* Initialize the model used to render the sprite */
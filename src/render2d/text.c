@@ -112,6 +112,14 @@ int _ge_text_generate_arrays(GEText *text, GEFont *font, char *str,
                 else text->uv_coords[i*4*2+n] = glyph->u1;
             }
         }
+        if(font->rect != NULL){
+            /* The glyphs can be rotated in the atlas */
+            for(n=0;n<4*2;n+=2){
+                ge_atlas_uv(font->rect, text->uv_coords[i*4*2+n],
+                            text->uv_coords[i*4*2+n+1],
+                            text->uv_coords+i*4*2+n);
+            }
+        }
         for(n=0;n<6;n++){
             text->indices[i*6+n] = indices[n]+i*4;
         }
@@ -99,6 +99,14 @@ int _ge_tilemap_generate(GETilemap *tilemap, unsigned short int *tiles,
                     tilemap->uv_coords[i*4*2+n] = (tx+uv_coords[n])*tile_w;
                 }
             }
+            if(tilemap->rect != NULL){
+                /* The tileset can be rotated in the atlas */
+                for(n=0;n<4*2;n+=2){
+                    ge_atlas_uv(tilemap->rect, tilemap->uv_coords[i*4*2+n],
+                                tilemap->uv_coords[i*4*2+n+1],
+                                tilemap->uv_coords+i*4*2+n);
+                }
+            }
             for(n=0;n<6;n++){
                 tilemap->indices[i*6+n] = i*4+indices[n];
             }
@@ -127,8 +135,10 @@ int ge_tilemap_init(GETilemap *tilemap, GEImage *tileset, GETexture *texture,
     
     tilemap->w = w;
     tilemap->h = h;
+    tilemap->size = size;
     
     tilemap->tileset = tileset;
+    tilemap->rect = NULL;
     
     tilemap->vertices = NULL;
     tilemap->uv_coords = NULL;
@@ -165,6 +175,7 @@ int ge_tilemap_update(GETilemap *tilemap, unsigned short int *tiles, int w,
     tilemap->tiles = tiles;
     tilemap->w = w;
     tilemap->h = h;
+    tilemap->size = size;
     
     rc = _ge_tilemap_generate(tilemap, tiles, size);
     if(rc) return rc;
@@ -183,6 +194,12 @@ int ge_tilemap_update(GETilemap *tilemap, unsigned short int *tiles, int w,
     return GE_E_NONE;
 }
 
+int ge_tilemap_set_rect(GETilemap *tilemap, GEAtlasRect *rect) {
+    tilemap->rect = rect;
+    return ge_tilemap_update(tilemap, tilemap->tiles, tilemap->w, tilemap->h,
+                             tilemap->size);
+}
+
 void ge_tilemap_free(GETilemap *tilemap) {
     free(tilemap->vertices);
     tilemap->vertices = NULL;
@@ -33,6 +33,9 @@
  */
 
 #include <mibiengine2/renderer/loader.h>
+#include <mibiengine2/base/meshcache.h>
+#include <mibiengine2/base/file.h>
+#include <mibiengine2/config.h>
 #include <mibiengine2/errors.h>
 
 #include <stdlib.h>
@@ -66,69 +69,128 @@ char *ge_loader_load_text(char *file, size_t *size_ptr) {
     return data;
 }
 
-int ge_loader_load_obj(GEModel *model, GEShader *shader, GETexture *texture,
-                       char *file, char **attr_names, GEShaderPos *tex_pos,
-                       GEShaderPos *uv_max_pos, int updatable) {
-    void *data;
-    size_t size;
-    GEObj obj;
-    
-    data = ge_loader_load_text(file, &size);
-    if(data == NULL) return GE_E_FILE;
+/* The layout of the vertices of the models loaded from .obj files: a
+ * position, no color, uv coordinates and a normal. */
+static size_t _ge_loader_obj_item_sizes[GE_STDMODEL_ARRAY_NUM] = {4, 0, 3, 3};
+
+/* Interleave the vertex positions, uv coordinates and normals of obj in a
+ * single array. */
+static float *_ge_loader_obj_interleave(GEObj *obj, size_t *vertex_num) {
+    size_t i, n, stride;
+    float *data, *cur;
     
-    if(ge_obj_init(&obj, data, size)){
-        free(data);
-        return GE_E_OBJ_LOADING;
+    stride = _ge_loader_obj_item_sizes[0]+_ge_loader_obj_item_sizes[2]+
+             _ge_loader_obj_item_sizes[3];
+    n = obj->vertex_num/4;
+    data = malloc((n ? n : 1)*stride*sizeof(float));
+    if(data == NULL) return NULL;
+    for(i=0;i<n;i++){
+        cur = data+i*stride;
+        memcpy(cur, obj->vertices+i*4, 4*sizeof(float));
+        cur += 4;
+        if((i+1)*3 <= obj->uv_num){
+            memcpy(cur, obj->uv_coords+i*3, 3*sizeof(float));
+        }else{
+            cur[0] = cur[1] = cur[2] = 0;
+        }
+        cur += 3;
+        if((i+1)*3 <= obj->normal_num){
+            memcpy(cur, obj->normals+i*3, 3*sizeof(float));
+        }else{
+            cur[0] = cur[1] = cur[2] = 0;
+        }
     }
-    
+    *vertex_num = n;
+    return data;
+}
+
+/* Create the model of ge_loader_load_obj from its interleaved vertex data */
+static int _ge_loader_obj_model(GEModel *model, GEShader *shader,
+                                GETexture *texture, unsigned int *indices,
+                                float *vertices, size_t index_num,
+                                size_t vertex_num, size_t *item_sizes,
+                                char **attr_names, GEShaderPos *tex_pos,
+                                GEShaderPos *uv_max_pos, int updatable) {
+    /* All the vertex data is stored in a single interleaved array, so that the
+     * attributes of a vertex are next to each other in memory. */
     if(texture == NULL){
-        if(ge_stdmodel_init(model, obj.indices, obj.vertices,
-                            GE_T_UINT, GE_T_FLOAT, obj.index_num,
-                            obj.vertex_num, 4, updatable, NULL)){
-            ge_obj_free(&obj);
-            free(data);
+        if(ge_stdmodel_init_interleaved(model, indices, vertices, GE_T_UINT,
+                                        GE_T_FLOAT, index_num, vertex_num,
+                                        item_sizes, updatable, NULL)){
             return GE_E_STDMODEL_INIT;
         }
     }else{
-        if(ge_texturedmodel_init(model, texture, obj.indices, obj.vertices,
-                                 GE_T_UINT, GE_T_FLOAT, obj.index_num,
-                                 obj.vertex_num, 4, updatable, NULL)){
-            ge_obj_free(&obj);
-            free(data);
+        if(ge_texturedmodel_init_interleaved(model, texture, indices,
+                                             vertices, GE_T_UINT, GE_T_FLOAT,
+                                             index_num, vertex_num,
+                                             item_sizes, updatable, NULL)){
             return GE_E_TEXTUREDMODEL_INIT;
         }
     }
-    if(ge_stdmodel_add_uv_coords(model, obj.uv_coords, GE_T_FLOAT, obj.uv_num,
-                                 3)){
-        ge_model_free(model);
-        ge_obj_free(&obj);
-        free(data);
-        return GE_E_STDMODEL_ADD;
-    }
-    if(ge_stdmodel_add_normals(model, obj.normals, GE_T_FLOAT, obj.normal_num,
-                              3)){
-        ge_model_free(model);
-        ge_obj_free(&obj);
-        free(data);
-        return GE_E_STDMODEL_ADD;
-    }
     if(ge_stdmodel_shader_attr(model, shader, attr_names)){
         ge_model_free(model);
-        ge_obj_free(&obj);
-        free(data);
         return GE_E_STDMODEL_ADD;
     }
     if(ge_texturedmodel_set_texture(model, tex_pos, uv_max_pos)){
         ge_model_free(model);
-        ge_obj_free(&obj);
-        free(data);
         return GE_E_SET_TEXTURE;
     }
-    ge_obj_free(&obj);
-    free(data);
     return GE_E_NONE;
 }
 
+int ge_loader_load_obj(GEModel *model, GEShader *shader, GETexture *texture,
+                       char *file, char **attr_names, GEShaderPos *tex_pos,
+                       GEShaderPos *uv_max_pos, int updatable) {
+    GEFile source;
+    GEObj obj;
+    float *vertices;
+    size_t vertex_num;
+    int rc;
+#if GE_LOADER_MESH_CACHE
+    GEMeshCache cache;
+    
+    /* Use the mesh saved by a previous run if the file did not change */
+    if(!ge_meshcache_load(&cache, file)){
+        rc = _ge_loader_obj_model(model, shader, texture, cache.indices,
+                                  cache.vertices, cache.index_num,
+                                  cache.vertex_num, cache.item_sizes,
+                                  attr_names, tex_pos, uv_max_pos, updatable);
+        ge_meshcache_free(&cache);
+        return rc;
+    }
+#endif
+    
+    if(ge_file_map(&source, file, 0)) return GE_E_FILE;
+    
+    if(ge_obj_init(&obj, source.data, source.size)){
+        ge_file_unmap(&source);
+        return GE_E_OBJ_LOADING;
+    }
+    
+    vertices = _ge_loader_obj_interleave(&obj, &vertex_num);
+    if(vertices == NULL){
+        ge_obj_free(&obj);
+        ge_file_unmap(&source);
+        return GE_E_OUT_OF_MEM;
+    }
+    
+#if GE_LOADER_MESH_CACHE
+    /* The cache is only an optimization, it doesn't matter if it can't be
+     * written. */
+    ge_meshcache_save(file, source.data, source.size, vertices, vertex_num,
+                      _ge_loader_obj_item_sizes, obj.indices, obj.index_num);
+#endif
+    
+    rc = _ge_loader_obj_model(model, shader, texture, obj.indices, vertices,
+                              obj.index_num, vertex_num,
+                              _ge_loader_obj_item_sizes, attr_names, tex_pos,
+                              uv_max_pos, updatable);
+    free(vertices);
+    ge_obj_free(&obj);
+    ge_file_unmap(&source);
+    return rc;
+}
+
 int ge_loader_load_stdobj(GEModel *model, GEStdShader *shader,
                           GETexture *texture, char *file, int updatable) {
     char *attr_names[] = {
@@ -230,22 +292,21 @@ int ge_loader_light_renderable(GERenderable *renderable, GELight *light,
 
 char *ge_loader_load_shader(GEShader *shader, char *vertex_file,
                             char *fragment_file) {
-    char *vertex_shader;
-    char *fragment_shader;
+    GEFile vertex_shader;
+    GEFile fragment_shader;
     char *log;
     
-    vertex_shader = ge_loader_load_text(vertex_file, NULL);
-    fragment_shader = ge_loader_load_text(fragment_file, NULL);
-    
-    if(vertex_shader == NULL || fragment_shader == NULL){
-        free(vertex_shader);
-        free(fragment_shader);
+    if(ge_file_map(&vertex_shader, vertex_file, 1)){
+        return "Failed to load shaders!\n";
+    }
+    if(ge_file_map(&fragment_shader, fragment_file, 1)){
+        ge_file_unmap(&vertex_shader);
         return "Failed to load shaders!\n";
     }
     
-    log = ge_shader_init(shader, vertex_shader, fragment_shader);
-    free(vertex_shader);
-    free(fragment_shader);
+    log = ge_shader_init(shader, vertex_shader.data, fragment_shader.data);
+    ge_file_unmap(&vertex_shader);
+    ge_file_unmap(&fragment_shader);
     return log;
 }
 
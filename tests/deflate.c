@@ -0,0 +1,120 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Decompress a zlib stream followed by trailing bytes, at once and a byte at
+ * a time, which shouldn't make the decoder read past the end of the stream
+ * into its bit buffer. */
+
+#include <mibiengine2/base/deflate.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The number of bytes after the end of the stream */
+#define TRAILING 64
+
+/* 300 bytes of (i*7+i/13)&255, followed by "hello hello hello hello " 8
+ * times, compressed by zlib */
+static unsigned char stream[] = {
+    0x78, 0xda, 0x63, 0x60, 0xe7, 0x13, 0x95, 0x51, 0xd6, 0x32, 0xb4, 0xb0,
+    0x77, 0xf3, 0x0d, 0x89, 0x49, 0xce, 0x2a, 0xac, 0xa8, 0x6f, 0xeb, 0x9d,
+    0x32, 0x7b, 0xd1, 0xca, 0x0d, 0x3b, 0xf6, 0x1f, 0x3b, 0x7b, 0xe5, 0xf6,
+    0xa3, 0x97, 0x1f, 0xbe, 0xff, 0x63, 0xe5, 0x11, 0x91, 0x56, 0xd2, 0x34,
+    0x30, 0xb7, 0x73, 0xf5, 0x09, 0x8e, 0x4a, 0xcc, 0x28, 0x28, 0xaf, 0x6b,
+    0xed, 0x99, 0x3c, 0x6b, 0xe1, 0x8a, 0xf5, 0xdb, 0xf6, 0x1e, 0x39, 0x73,
+    0xf9, 0xd6, 0xc3, 0x17, 0xef, 0xbf, 0xfd, 0x65, 0xe1, 0x16, 0x92, 0x54,
+    0xd0, 0xd0, 0x37, 0xb3, 0x75, 0xf1, 0x0e, 0x8a, 0x4c, 0x48, 0xcf, 0x2b,
+    0xad, 0x69, 0xe9, 0x9e, 0x34, 0x73, 0xc1, 0xf2, 0x75, 0x5b, 0xf7, 0x1c,
+    0x3e, 0x75, 0xf1, 0xc6, 0x83, 0xe7, 0xef, 0xbe, 0xfe, 0x61, 0xe6, 0x12,
+    0x94, 0x90, 0x57, 0xd3, 0x35, 0xb1, 0x71, 0xf6, 0x0a, 0x8c, 0x88, 0x4f,
+    0xcb, 0x2d, 0xa9, 0x6e, 0xea, 0x9c, 0x30, 0x63, 0xfe, 0xb2, 0xb5, 0x5b,
+    0x76, 0x1f, 0x3a, 0x79, 0xe1, 0xfa, 0xbd, 0xa7, 0x6f, 0xbe, 0xfc, 0x66,
+    0xe2, 0x14, 0x10, 0x97, 0x53, 0xd5, 0x31, 0xb6, 0x72, 0xf4, 0x08, 0x08,
+    0x8f, 0x4b, 0xcd, 0x29, 0xae, 0x6a, 0xec, 0xe8, 0x9f, 0x36, 0x77, 0xc9,
+    0x9a, 0xcd, 0xbb, 0x0e, 0x9e, 0x38, 0x7f, 0xed, 0xee, 0x93, 0xd7, 0x9f,
+    0x7e, 0x32, 0x70, 0xf0, 0x8b, 0xc9, 0xaa, 0x68, 0x1b, 0x59, 0x3a, 0xb8,
+    0xfb, 0x85, 0xc6, 0xa4, 0x64, 0x17, 0x55, 0x36, 0xb4, 0xf7, 0x4d, 0x9d,
+    0xb3, 0x78, 0xd5, 0xc6, 0x1d, 0x07, 0x8e, 0x9f, 0xbb, 0x7a, 0xe7, 0xf1,
+    0xab, 0x8f, 0x3f, 0xfe, 0xb3, 0xf1, 0x8a, 0xc0, 0x3d, 0x16, 0x9d, 0x94,
+    0x59, 0x00, 0xf7, 0xd8, 0xf6, 0x7d, 0x47, 0xcf, 0xc0, 0x3d, 0x26, 0x2c,
+    0xa5, 0xa8, 0x01, 0xf7, 0x58, 0x7e, 0x59, 0x6d, 0x0b, 0xdc, 0x63, 0xa7,
+    0x2f, 0xdd, 0x7c, 0x00, 0xf7, 0x98, 0xba, 0x9e, 0xa9, 0x8d, 0x4b, 0x46,
+    0x6a, 0x4e, 0x4e, 0xbe, 0xc2, 0xd0, 0x25, 0x01, 0xe3, 0xb4, 0xd8, 0xcf
+};
+
+static int decompress(unsigned char *expected, size_t expected_size,
+                      unsigned char *data, size_t size, size_t step) {
+    GEDeflate deflate;
+    size_t i;
+    int rc;
+    
+    if(ge_deflate_init(&deflate)) return 1;
+    for(i=0;i<size;i+=step){
+        rc = ge_deflate_decompress(&deflate, data+i,
+                                   size-i < step ? size-i : step);
+        if(rc){
+            fprintf(stderr, "deflate: failed with %d at %lu\n", rc,
+                    (unsigned long)i);
+            ge_deflate_free(&deflate);
+            return 1;
+        }
+    }
+    rc = 0;
+    if(!deflate.adler32_found || deflate.output_size != expected_size ||
+       memcmp(deflate.output, expected, expected_size)){
+        fprintf(stderr, "deflate: wrong output with steps of %lu bytes\n",
+                (unsigned long)step);
+        rc = 1;
+    }
+    ge_deflate_free(&deflate);
+    return rc;
+}
+
+int main(void) {
+    unsigned char expected[300+24*8];
+    unsigned char data[sizeof(stream)+TRAILING];
+    size_t i;
+    int rc = 0;
+    
+    for(i=0;i<300;i++) expected[i] = (i*7+i/13)&255;
+    for(i=0;i<8;i++) memcpy(expected+300+i*24, "hello hello hello hello ", 24);
+    memcpy(data, stream, sizeof(stream));
+    memset(data+sizeof(stream), 0xFF, TRAILING);
+    
+    rc |= decompress(expected, sizeof(expected), data, sizeof(data),
+                     sizeof(data));
+    rc |= decompress(expected, sizeof(expected), data, sizeof(data), 1);
+    return rc ? EXIT_FAILURE : EXIT_SUCCESS;
+}
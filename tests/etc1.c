@@ -0,0 +1,286 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Compress synthetic images to ETC1 at each quality level and decode them
+ * with a decoder written from the specification of the format, which should
+ * match ge_etc1_decode and give a PSNR that doesn't drop when the quality
+ * gets higher. */
+
+#include <mibiengine2/base/etc1.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define QUALITIES 3
+
+typedef struct {
+    char *name;
+    int width;
+    int height;
+    double min_psnr;
+} Image;
+
+/* The intensity modifiers of the OES_compressed_ETC1_RGB8_texture
+ * extension */
+static const int modifiers[8][2] = {
+    {2, 8},
+    {5, 17},
+    {9, 29},
+    {13, 42},
+    {18, 60},
+    {24, 80},
+    {33, 106},
+    {47, 183}
+};
+
+static const char *quality_names[QUALITIES] = {"fast", "medium", "high"};
+
+static int clamp(int value) {
+    return value < 0 ? 0 : value > 255 ? 255 : value;
+}
+
+/* Read the bits first to last (counted from the least significant bit) of
+ * the big endian 64-bit block. */
+static unsigned long bits(const unsigned char *block, int first, int last) {
+    unsigned long value = 0;
+    int i;
+    
+    for(i=last;i>=first;i--){
+        value = value<<1 | (block[7-i/8]>>(i%8)&1);
+    }
+    return value;
+}
+
+/* Decode a block, returning 1 if the differential mode makes a color go out
+ * of range. */
+static int decode_block(unsigned char colors[4][4][3],
+                        const unsigned char *block) {
+    int base[2][3];
+    int table[2];
+    int flip, sub, index, modifier;
+    int x, y, c;
+    
+    if(bits(block, 33, 33)){
+        for(c=0;c<3;c++){
+            int color = bits(block, 59-c*8, 63-c*8);
+            int delta = bits(block, 56-c*8, 58-c*8);
+            
+            if(delta >= 4) delta -= 8;
+            if(color+delta < 0 || color+delta > 31) return 1;
+            base[0][c] = color<<3 | color>>2;
+            base[1][c] = (color+delta)<<3 | (color+delta)>>2;
+        }
+    }else{
+        for(c=0;c<3;c++){
+            base[0][c] = bits(block, 60-c*8, 63-c*8)*17;
+            base[1][c] = bits(block, 56-c*8, 59-c*8)*17;
+        }
+    }
+    table[0] = bits(block, 37, 39);
+    table[1] = bits(block, 34, 36);
+    flip = bits(block, 32, 32);
+    for(y=0;y<4;y++){
+        for(x=0;x<4;x++){
+            sub = flip ? y >= 2 : x >= 2;
+            index = bits(block, 16+x*4+y, 16+x*4+y)<<1 |
+                    bits(block, x*4+y, x*4+y);
+            modifier = modifiers[table[sub]][index&1];
+            if(index&2) modifier = -modifier;
+            for(c=0;c<3;c++){
+                colors[y][x][c] = clamp(base[sub][c]+modifier);
+            }
+        }
+    }
+    return 0;
+}
+
+static int decode(unsigned char *rgba, const unsigned char *data, int width,
+                  int height) {
+    unsigned char colors[4][4][3];
+    int bx, by, x, y;
+    
+    for(by=0;by<(height+3)/4;by++){
+        for(bx=0;bx<(width+3)/4;bx++){
+            if(decode_block(colors, data)) return 1;
+            data += GE_ETC1_BLOCK_SIZE;
+            for(y=0;y<4 && by*4+y<height;y++){
+                for(x=0;x<4 && bx*4+x<width;x++){
+                    unsigned char *pixel = rgba+((by*4+y)*width+bx*4+x)*4;
+                    
+                    memcpy(pixel, colors[y][x], 3);
+                    pixel[3] = 255;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static void generate(unsigned char *rgba, const char *name, int width,
+                     int height) {
+    int x, y;
+    
+    for(y=0;y<height;y++){
+        for(x=0;x<width;x++){
+            unsigned char *pixel = rgba+(y*width+x)*4;
+            
+            if(!strcmp(name, "gradient")){
+                pixel[0] = x*255/(width-1);
+                pixel[1] = y*255/(height-1);
+                pixel[2] = (x+y)*255/(width+height-2);
+            }else if(!strcmp(name, "stripes")){
+                /* Hard luminance edges that aren't aligned on the blocks */
+                if((x+y/2)/3&1){
+                    pixel[0] = 220;
+                    pixel[1] = 200;
+                    pixel[2] = 150;
+                }else{
+                    pixel[0] = 40;
+                    pixel[1] = 30;
+                    pixel[2] = 10;
+                }
+            }else{
+                /* A gradient with a disc cut out of it */
+                int dx = x-width/3, dy = y-height/2;
+                
+                if(dx*dx+dy*dy < width*height/8){
+                    pixel[0] = 250;
+                    pixel[1] = 240;
+                    pixel[2] = 10;
+                }else{
+                    pixel[0] = 40+x*150/width;
+                    pixel[1] = 90;
+                    pixel[2] = 200-y*150/height;
+                }
+            }
+            /* The alpha should be ignored */
+            pixel[3] = (x*37+y*91)&255;
+        }
+    }
+}
+
+static double psnr(unsigned char *a, unsigned char *b, int width,
+                   int height) {
+    double error = 0;
+    int i, c;
+    
+    for(i=0;i<width*height;i++){
+        for(c=0;c<3;c++){
+            double d = (double)a[i*4+c]-b[i*4+c];
+            
+            error += d*d;
+        }
+    }
+    if(error == 0) return 99;
+    return 10*log10(255.0*255.0*width*height*3/error);
+}
+
+static int test(Image *image) {
+    unsigned char *rgba, *data, *decoded, *expected;
+    double psnrs[QUALITIES];
+    size_t size = ge_etc1_size(image->width, image->height);
+    size_t pixels = (size_t)image->width*image->height*4;
+    int quality;
+    int rc = 0;
+    
+    rgba = malloc(pixels);
+    decoded = malloc(pixels);
+    expected = malloc(pixels);
+    data = malloc(size);
+    if(!rgba || !decoded || !expected || !data){
+        fprintf(stderr, "etc1: out of memory\n");
+        free(rgba);
+        free(decoded);
+        free(expected);
+        free(data);
+        return 1;
+    }
+    generate(rgba, image->name, image->width, image->height);
+    for(quality=0;quality<QUALITIES;quality++){
+        ge_etc1_encode(data, rgba, image->width*4, image->width,
+                       image->height, quality);
+        if(decode(decoded, data, image->width, image->height)){
+            fprintf(stderr, "etc1: %s %dx%d (%s): invalid block\n",
+                    image->name, image->width, image->height,
+                    quality_names[quality]);
+            rc = 1;
+            continue;
+        }
+        ge_etc1_decode(expected, image->width*4, data, image->width,
+                       image->height);
+        if(memcmp(decoded, expected, pixels)){
+            fprintf(stderr, "etc1: %s %dx%d (%s): ge_etc1_decode doesn't "
+                    "match the reference decoder\n", image->name,
+                    image->width, image->height, quality_names[quality]);
+            rc = 1;
+        }
+        psnrs[quality] = psnr(rgba, decoded, image->width, image->height);
+        printf("etc1: %s %dx%d (%s): %.2f dB\n", image->name, image->width,
+               image->height, quality_names[quality], psnrs[quality]);
+        if(psnrs[quality] < image->min_psnr){
+            fprintf(stderr, "etc1: PSNR below %.2f dB\n", image->min_psnr);
+            rc = 1;
+        }
+        if(quality && psnrs[quality] < psnrs[quality-1]){
+            fprintf(stderr, "etc1: PSNR lower than with the %s quality\n",
+                    quality_names[quality-1]);
+            rc = 1;
+        }
+    }
+    free(rgba);
+    free(decoded);
+    free(expected);
+    free(data);
+    return rc;
+}
+
+int main(void) {
+    static Image images[] = {
+        {"gradient", 64, 64, 36},
+        {"gradient", 13, 7, 23},
+        {"stripes", 33, 17, 25},
+        {"stripes", 7, 5, 25},
+        {"disc", 33, 17, 18},
+        {"disc", 64, 64, 23.5}
+    };
+    size_t i;
+    int rc = 0;
+    
+    for(i=0;i<sizeof(images)/sizeof(Image);i++){
+        rc |= test(images+i);
+    }
+    return rc ? EXIT_FAILURE : EXIT_SUCCESS;
+}
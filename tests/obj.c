@@ -0,0 +1,95 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Load a large .obj file without uv coords and normals, that gets parsed in
+ * several chunks, and check that the missing attributes are zeros. */
+
+#include <mibiengine2/base/obj.h>
+#include <mibiengine2/config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The number of triangles of the model, enough for at least four chunks
+ * (run_tests.sh sets GE_OBJ_THREADS to 4) */
+#define TRIANGLES ((GE_OBJ_CHUNK_MIN*4)/32)
+
+int main(void) {
+    GEObj obj;
+    char *data;
+    char *cur;
+    size_t size;
+    size_t i;
+    int rc;
+    
+    data = malloc((size_t)TRIANGLES*64);
+    if(data == NULL) return EXIT_FAILURE;
+    cur = data;
+    for(i=0;i<TRIANGLES;i++){
+        cur += sprintf(cur, "v %d 0 0\nv 0 %d 0\nv 0 0 %d\n", (int)i+1,
+                       (int)i+1, (int)i+1);
+        cur += sprintf(cur, "f -3 -2 -1\n");
+    }
+    size = cur-data;
+    
+    rc = ge_obj_init(&obj, data, size);
+    free(data);
+    if(rc){
+        fprintf(stderr, "obj: ge_obj_init failed with %d\n", rc);
+        return EXIT_FAILURE;
+    }
+    rc = EXIT_SUCCESS;
+    if(obj.index_num != (size_t)TRIANGLES*3 ||
+       obj.vertex_num != (size_t)TRIANGLES*3*4 ||
+       obj.uv_num != (size_t)TRIANGLES*3*3 ||
+       obj.normal_num != (size_t)TRIANGLES*3*3){
+        fprintf(stderr, "obj: wrong number of items\n");
+        rc = EXIT_FAILURE;
+    }
+    for(i=0;i<obj.index_num && rc == EXIT_SUCCESS;i++){
+        if(obj.vertices[obj.indices[i]*4+i%3] != (float)(i/3+1)){
+            fprintf(stderr, "obj: wrong vertex %lu\n", (unsigned long)i);
+            rc = EXIT_FAILURE;
+        }
+    }
+    for(i=0;i<obj.uv_num && rc == EXIT_SUCCESS;i++){
+        if(obj.uv_coords[i] != 0 || obj.normals[i] != 0){
+            fprintf(stderr, "obj: missing attributes aren't zeros\n");
+            rc = EXIT_FAILURE;
+        }
+    }
+    ge_obj_free(&obj);
+    return rc;
+}
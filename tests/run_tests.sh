@@ -0,0 +1,76 @@
+#!/bin/bash
+
+# A small OpenGL ES engine.
+# by Mibi88
+#
+# This software is licensed under the BSD-3-Clause license:
+#
+# Copyright 2025 Mibi88
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+# 1. Redistributions of source code must retain the above copyright notice,
+# this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright notice,
+# this list of conditions and the following disclaimer in the documentation
+# and/or other materials provided with the distribution.
+#
+# 3. Neither the name of the copyright holder nor the names of its
+# contributors may be used to endorse or promote products derived from this
+# software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+
+# Build and run the tests against the sources of the engine, with the address
+# and undefined behavior sanitizers.
+
+SRCFILES=(src/backends/*.c src/backends/gles/*.c src/backends/soft/*.c
+          src/backends/null/*.c
+          src/base/*.c src/renderer/*.c src/render2d/*.c)
+CC=cc
+DEST=build/tests
+CFLAGS=(-ansi -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+        -fno-sanitize-recover=all
+        -Isrc/backends -Iinclude -g)
+LIBS=(-lEGL -lm -lX11 -lGLESv2 -lpng -lpthread)
+
+# Use several threads even on a single core
+export GE_OBJ_THREADS=4
+
+mkdir -p $DEST
+
+failed=0
+
+for file in tests/*.c; do
+    base="${file##*/}"
+    bin="$DEST/${base%%.*}"
+    echo "-- Building $file..."
+    $CC -o $bin $file ${SRCFILES[@]} ${CFLAGS[@]} ${LIBS[@]}
+    rc=$?
+    if [ $rc -ne 0 ]; then
+        echo "-- Build failed with return code $rc!"
+        exit $rc
+    fi
+    echo "-- Running $bin..."
+    if ! $bin; then
+        echo "-- $bin failed!"
+        failed=$((failed+1))
+    fi
+done
+
+if [ $failed -ne 0 ]; then
+    echo "-- $failed test(s) failed!"
+    exit 1
+fi
+echo "-- All tests passed!"
@@ -0,0 +1,122 @@
+/* A small OpenGL ES engine.
+ * by Mibi88
+ *
+ * This software is licensed under the BSD-3-Clause license:
+ *
+ * Copyright 2025 Mibi88
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mibiengine2/base/image.h>
+#include <mibiengine2/base/etc1.h>
+#include <mibiengine2/base/mipmap.h>
+
+#include <mibiengine2/errors.h>
+
+/* Convert PNG images to .getex files, to load them as textures without
+ * decoding them at runtime. */
+
+static void usage(char *name) {
+    fprintf(stderr, "Usage: %s [-f] [-m] [-k] [-g] [-e] [-q quality] "
+            "input.png [output.getex]\n"
+            "  -f  Flip the texture, as ge_texture_init with flip set.\n"
+            "  -m  Generate the mip levels with a box filter.\n"
+            "  -k  Generate the mip levels with a Kaiser filter.\n"
+            "  -g  Filter the mip levels in linear light (sRGB images).\n"
+            "  -e  Compress the texture to ETC1, without its alpha.\n"
+            "  -q  The quality of the ETC1 encoder, from 0 (fastest) to 2 "
+            "(best, default).\n"
+            "The output defaults to the input followed by "
+            GE_IMAGE_GETEX_EXT ".\n", name);
+}
+
+int main(int argc, char **argv) {
+    GEImage image;
+    char *input = NULL;
+    char *output = NULL;
+    char *path = NULL;
+    int flip = 0;
+    int mipmaps = GE_MIPMAP_NONE;
+    int gamma = 0;
+    int format = GE_IMAGE_FORMAT_RGBA8;
+    int quality = GE_ETC1_HIGH;
+    int i;
+    int rc;
+    
+    for(i=1;i<argc;i++){
+        if(!strcmp(argv[i], "-f")) flip = 1;
+        else if(!strcmp(argv[i], "-m")) mipmaps = GE_MIPMAP_BOX;
+        else if(!strcmp(argv[i], "-k")) mipmaps = GE_MIPMAP_KAISER;
+        else if(!strcmp(argv[i], "-g")) gamma = GE_MIPMAP_GAMMA;
+        else if(!strcmp(argv[i], "-e")) format = GE_IMAGE_FORMAT_ETC1;
+        else if(!strcmp(argv[i], "-q") && i+1 < argc){
+            quality = atoi(argv[++i]);
+        }
+        else if(input == NULL) input = argv[i];
+        else if(output == NULL) output = argv[i];
+        else{
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(input == NULL || (gamma && !mipmaps)){
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if(output == NULL){
+        path = malloc(strlen(input)+sizeof(GE_IMAGE_GETEX_EXT));
+        if(path == NULL){
+            fputs("Out of memory!\n", stderr);
+            return EXIT_FAILURE;
+        }
+        strcpy(path, input);
+        strcat(path, GE_IMAGE_GETEX_EXT);
+        output = path;
+    }
+    
+    if(ge_image_init(&image, input)){
+        fprintf(stderr, "Failed to read %s!\n", input);
+        free(path);
+        return EXIT_FAILURE;
+    }
+    rc = ge_image_save_getex(&image, output, flip, mipmaps|gamma, format,
+                             quality);
+    ge_image_free(&image);
+    if(rc){
+        fprintf(stderr, "Failed to write %s!\n", output);
+        free(path);
+        return EXIT_FAILURE;
+    }
+    free(path);
+    
+    return EXIT_SUCCESS;
+}